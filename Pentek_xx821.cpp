@@ -29,41 +29,84 @@
  *      Author: Chris Burghart <burghart@ucar.edu>
  */
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <sstream>
+#include <stdexcept>
+#include <unistd.h>
 #include <logx/Logging.h>
 
 #include "Pentek_xx821.h"
+#include "Pentek_xx821DeferredLog.h"
 
 LOGGING("Pentek_xx821")
 
-// Class-wide count of how many objects of this class are instantiated
-std::atomic<uint32_t> Pentek_xx821::_InstanceCount(0);
+// Navigator BSP bookkeeping shared by all instances
+boost::mutex Pentek_xx821::_BspMutex;
+uint32_t Pentek_xx821::_BspUsers = 0;
+NAV_DEVICE_INFO * Pentek_xx821::_BoardList[NAV_MAX_BOARDS];
+int32_t Pentek_xx821::_NumBoards = -1;
+
+// Return the time in seconds since the given time point
+static double
+secondsSince(const std::chrono::steady_clock::time_point & start) {
+    return(std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start).count());
+}
+
+const uint32_t Pentek_xx821::MAX_SAFE_DMA_READ_BYTES;
+const uint32_t Pentek_xx821::DEFAULT_ADAPTIVE_THRESHOLD_NS;
+const uint32_t Pentek_xx821::DEFAULT_HEALTH_PERIOD_MS;
 
 Pentek_xx821::Pentek_xx821(uint16_t boardNum) :
     _mutex(),
     _boardNum(boardNum),
-    _boardHandle(NULL)
+    _boardHandle(NULL),
+    _numaNode(-1),
+    _bufferPool(),
+    _openTiming(),
+    _telemetry(boardNum),
+    _completionMode(COMPLETION_INTERRUPT),
+    _pollCpu(-1),
+    _adaptiveThresholdNs(DEFAULT_ADAPTIVE_THRESHOLD_NS),
+    _serviceThreadConfig(),
+    _serviceThreads(),
+    _health(),
+    _initialLinkSpeed(0),
+    _initialLinkWidth(0),
+    _healthPeriodMs(DEFAULT_HEALTH_PERIOD_MS),
+    _healthThread(),
+    _healthReader(),
+    _healthReaderOwner(),
+    _healthReaderOwned(false),
+    _dmaReadSegmentBytes(0),
+    _regCacheEnabled(false),
+    _deferRegWrites(false)
 {
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        _regRegionStart[r] = 0;
+    }
+
     boost::recursive_mutex::scoped_lock guard(_mutex);
 
     // Holder for status value returned by NAV_xxx() functions
     int32_t status;
 
-    // Initialize the Navigator board support package when the first instance
-    // is being constructed.
-    if (_InstanceCount == 0) {
-        status = NAV_BoardStartup();
-        _AbortCtorOnNavStatusError(status, "NAV_BoardStartup");
-        DLOG << "Opened Navigator BSP";
-    }
+    std::chrono::steady_clock::time_point ctorStart =
+            std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point phaseStart = ctorStart;
 
-    // Find all Pentek boards in the system
-    NAV_DEVICE_INFO *boardList[NAV_MAX_BOARDS];
-    int32_t numBoards;
-    status = NAV_BoardFind(0, boardList, &numBoards);
-    _AbortCtorOnNavStatusError(status, "NAV_BoardFind");
+    // Initialize the Navigator board support package if this is its first
+    // user, and find all Pentek boards in the system. Both are done only
+    // once while the BSP stays open, however many boards are opened, and
+    // are safe against concurrent construction.
+    _AcquireNavigator();
+    _openTiming.startup = secondsSince(phaseStart);
 
-    DLOG << numBoards << ((numBoards == 1) ? " board " : " boards ") << "found";
+    phaseStart = std::chrono::steady_clock::now();
+    int32_t numBoards = _FindBoards();
+    _openTiming.find = secondsSince(phaseStart);
 
     // Make sure the requested board number is valid
     if (_boardNum >= numBoards) {
@@ -74,47 +117,68 @@ Pentek_xx821::Pentek_xx821(uint16_t boardNum) :
     }
 
     // Open the board
-    _boardHandle = NAV_BoardOpen(boardList[_boardNum], 0);
+    phaseStart = std::chrono::steady_clock::now();
+    _boardHandle = NAV_BoardOpen(_BoardList[_boardNum], 0);
     if (_boardHandle == NULL) {
         std::ostringstream os;
         os << "NAV_BoardOpen error opening board " << _boardNum;
         _AbortConstruction(os.str());
     }
+    _openTiming.open = secondsSince(phaseStart);
+
+    // Register addresses are relative to the board info registers; record
+    // where the user blocks start so register accesses can be sorted into
+    // independently locked regions.
+    _regRegionStart[REG_REGION_USER_BLOCK_1] =
+            4 * (_userBlock1Base() - _boardInfoRegBase());
+    _regRegionStart[REG_REGION_USER_BLOCK_2] =
+            4 * (_userBlock2Base() - _boardInfoRegBase());
+
+    // Find which NUMA node the board hangs off, so that sample buffers can
+    // be kept local to it
+    _numaNode = Pentek_xx821BufferPool::NumaNodeOfPciDevice(pciAddress());
+    _serviceThreadConfig = Pentek_xx821ServiceThread::DefaultConfig(_numaNode);
+    DLOG << "Board " << _boardNum << " at PCI " << pciAddress() <<
+            " is on NUMA node " << _numaNode;
 
     // Initialize the context for system specific resources (semaphores,
     // signals, etc.)
+    phaseStart = std::chrono::steady_clock::now();
     status = NAVsys_Init(&_appSysContext);
     _AbortCtorOnNavStatusError(status, "NAVsys_Init");
+    _openTiming.sysInit = secondsSince(phaseStart);
 
     // DMA reads by Pentek boards apparently always fail if PCIe 'max read
     // request size' is 4096 bytes. (E.g., Pentek Navigator's 'transmit_dma'
     // example program will fail with DMA timeouts). Detect that case now,
-    // and warn the user that if the board attempts any DMA reads, they will
-    // fail.
+    // and if so split every DMA read initiated by the board into segments
+    // no larger than MAX_SAFE_DMA_READ_BYTES.
     uint32_t junk;
     uint32_t maxReadReqSize;
-    status = NAV_GetPcieLinkStatus(_boardHandle, &junk, &junk, &junk,
+    phaseStart = std::chrono::steady_clock::now();
+    status = NAV_GetPcieLinkStatus(_boardHandle, &_initialLinkSpeed,
+                                   &_initialLinkWidth, &junk,
                                    &maxReadReqSize, &junk);
     _AbortCtorOnNavStatusError(status, "NAV_GetPcieLinkStatus");
-
-    if (maxReadReqSize > 2048) {
-        WLOG << "_______________________";
-        WLOG << "|";
-        WLOG << "| PCIe 'max read request size' for board " << _boardNum;
-        WLOG << "| is " << maxReadReqSize << " bytes. A Pentek bug will cause any";
-        WLOG << "| DMA reads initiated by the board to time out";
-        WLOG << "| with this setting. If DMA reads are required,";
-        WLOG << "| adjust PCIe 'max read request size' in the";
-        WLOG << "| computer's BIOS settings to be 2048 bytes or";
-        WLOG << "| smaller.";
-        WLOG << "|______________________";
-        WLOG << "";
+    _openTiming.linkStatus = secondsSince(phaseStart);
+
+    if (maxReadReqSize > MAX_SAFE_DMA_READ_BYTES) {
+        _dmaReadSegmentBytes = MAX_SAFE_DMA_READ_BYTES;
+        WLOG << "PCIe 'max read request size' for board " << _boardNum <<
+                " is " << maxReadReqSize << " bytes, which triggers a Pentek " <<
+                "DMA read bug.";
+        WLOG << "DMA reads initiated by the board will be split into " <<
+                _dmaReadSegmentBytes << "-byte segments. To avoid the " <<
+                "(small) cost, set 'max read request size' in the " <<
+                "computer's BIOS to " << MAX_SAFE_DMA_READ_BYTES <<
+                " bytes or smaller.";
     } else {
         DLOG << "PCIe 'max read request size' for board " << _boardNum <<
                 " is " << maxReadReqSize << " bytes";
     }
 
     // Get the ADC channel count for this board and store it in _adcCount
+    phaseStart = std::chrono::steady_clock::now();
     status = NAV_GetBoardSpec(_boardHandle, NAV_BOARD_SPEC_ADC_CHAN_COUNT,
                               &_adcCount);
     _AbortCtorOnNavStatusError(status, "NAV_GetBoardSpec");
@@ -129,16 +193,47 @@ Pentek_xx821::Pentek_xx821(uint16_t boardNum) :
                               &_dacCount);
     _AbortCtorOnNavStatusError(status, "NAV_GetBoardSpec");
 
-    // We're good, so increment the _InstanceCount.
-    ILOG << "Opened Pentek xx821 board " << _boardNum;
-    _InstanceCount++;
+    _openTiming.boardSpec = secondsSince(phaseStart);
+    _openTiming.total = secondsSince(ctorStart);
+
+    ILOG << "Opened Pentek xx821 board " << _boardNum << " in " <<
+            _openTiming.total << " s";
 }
 
 Pentek_xx821::~Pentek_xx821() {
+    // A health reader without an owner may use state which is already gone
+    // by now (e.g., a subclass's), so its caller should have stopped the
+    // sampler. Stop it first, then report the misuse.
+    bool unownedReaderRunning;
+    {
+        boost::recursive_mutex::scoped_lock guard(_mutex);
+        unownedReaderRunning = _healthThread && _healthReader &&
+                               ! _healthReaderOwned;
+    }
+
+    // Service threads may need the board lock to finish up, so stop them
+    // before taking it
+    stopHealthSampler();
+    if (unownedReaderRunning) {
+        ELOG << "Board " << _boardNum << " destroyed while its health " <<
+                "sampler was running a reader; call stopHealthSampler() " <<
+                "before the reader's state is destroyed, or give " <<
+                "startHealthSampler() the reader's owner";
+    }
+    stopServiceThreads();
+
     boost::recursive_mutex::scoped_lock guard(_mutex);
 
-    // Decrement the instance count.
-    _InstanceCount--;
+    // Push out any deferred register writes before letting go of the board
+    _lockAllRegRegions();
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        _flushRegRegion(_regRegions[r]);
+    }
+    _unlockAllRegRegions();
+
+    // The buffer pool's DMA mappings must be released while the board is
+    // still open
+    _bufferPool.reset();
 
     // Uninit system resources
     int32_t status = NAVsys_UnInit(&_appSysContext);
@@ -178,15 +273,614 @@ Pentek_xx821::_AbortConstruction(const std::string & msg) {
 
 void
 Pentek_xx821::_LogNavigatorError(int status, std::string prefix) {
+    if (status == NAV_STAT_DMA_UNAVAILABLE) {
+        DEFERRABLE_ELOG(prefix << ": no Navigator DMA support in this " <<
+                        "build (see PENTEK_NAV_DMA)");
+    } else if (status != NAV_STAT_OK) {
+        DEFERRABLE_ELOG(prefix << ": " << NavApiStatus[status]);
+    }
+}
+void *
+Pentek_xx821::_allocDmaMemory(uint32_t bytes, uint64_t & busAddr) const {
+    void * mem = NULL;
+    int32_t status = NAV_DmaMemAlloc(_boardHandle, bytes, &mem, &busAddr);
     if (status != NAV_STAT_OK) {
-        ELOG << prefix << ": " << NavApiStatus[status];
+        std::ostringstream os;
+        os << "NAV_DmaMemAlloc of " << bytes << " bytes for board " << _boardNum;
+        _LogNavigatorError(status, os.str());
+        return(NULL);
+    }
+    return(mem);
+}
+
+void
+Pentek_xx821::_freeDmaMemory(void * mem) const {
+    if (mem) {
+        _LogNavigatorError(NAV_DmaMemFree(_boardHandle, mem), "NAV_DmaMemFree");
+    }
+}
+
+bool
+Pentek_xx821::_allocRingBuffers(uint32_t nBuffers, uint32_t bufferBytes,
+                                std::vector<uint8_t *> & data,
+                                std::vector<uint64_t> & busAddrs,
+                                void *& contiguousMem) const {
+    data.clear();
+    busAddrs.clear();
+    contiguousMem = NULL;
+
+    // Use the buffer pool if it can supply all of the buffers
+    Pentek_xx821BufferPool * pool = _bufferPool.get();
+    if (pool && pool->blockBytes() >= bufferBytes &&
+            pool->freeCount() >= nBuffers) {
+        for (uint32_t i = 0; i < nBuffers; i++) {
+            uint8_t * buf = static_cast<uint8_t *>(pool->allocate());
+            if (! buf) {
+                break;
+            }
+            data.push_back(buf);
+            busAddrs.push_back(pool->busAddress(buf));
+        }
+        if (data.size() == nBuffers) {
+            return(true);
+        }
+        // Someone else got there first; give back what we took
+        _freeRingBuffers(data, NULL);
+        busAddrs.clear();
+    }
+
+    // Otherwise use one allocation for all of the buffers
+    uint64_t busAddr = 0;
+    contiguousMem = _allocDmaMemory(nBuffers * bufferBytes, busAddr);
+    if (! contiguousMem) {
+        return(false);
+    }
+    for (uint32_t i = 0; i < nBuffers; i++) {
+        data.push_back(static_cast<uint8_t *>(contiguousMem) +
+                       uint64_t(i) * bufferBytes);
+        busAddrs.push_back(busAddr + uint64_t(i) * bufferBytes);
+    }
+    return(true);
+}
+
+void
+Pentek_xx821::_freeRingBuffers(std::vector<uint8_t *> & data,
+                               void * contiguousMem) const {
+    if (contiguousMem) {
+        _freeDmaMemory(contiguousMem);
+    } else {
+        for (size_t i = 0; i < data.size(); i++) {
+            _bufferPool->release(data[i]);
+        }
+    }
+    data.clear();
+}
+
+std::string
+Pentek_xx821::pciAddress() const {
+    const NAV_PCI_INFO & pciInfo = _boardResource()->pciInfo;
+    std::ostringstream os;
+    os << std::hex << std::setfill('0') <<
+          std::setw(4) << 0 << ":" <<
+          std::setw(2) << pciInfo.busNum << ":" <<
+          std::setw(2) << pciInfo.devNum << "." <<
+          std::setw(1) << pciInfo.funcNum;
+    return(os.str());
+}
+
+void
+Pentek_xx821::createBufferPool(uint32_t blockBytes, uint32_t nBlocks) {
+    boost::recursive_mutex::scoped_lock guard(_mutex);
+    if (_bufferPool &&
+            _bufferPool->freeCount() != _bufferPool->blockCount()) {
+        throw Pentek_xx821BufferPool::ConstructError(
+                "Cannot replace a buffer pool which has blocks in use");
     }
+    _bufferPool.reset();
+#ifdef PENTEK_XX821_NAV_DMA
+    void * boardHandle = _boardHandle;
+    _bufferPool.reset(new Pentek_xx821BufferPool(
+            blockBytes, nBlocks, _numaNode,
+            [boardHandle](void * mem, size_t bytes, uint64_t & busAddr) {
+                int32_t status = NAV_DmaMemMap(boardHandle, mem, bytes, &busAddr);
+                _LogNavigatorError(status, "NAV_DmaMemMap");
+                return(status == NAV_STAT_OK);
+            },
+            [boardHandle](void * mem) {
+                _LogNavigatorError(NAV_DmaMemUnmap(boardHandle, mem),
+                                   "NAV_DmaMemUnmap");
+            }));
+#else
+    // Without Navigator DMA support the memory can't be mapped for the
+    // board, but the pool is still placed on the board's NUMA node
+    WLOG << "Board " << _boardNum << " buffer pool is not mapped for " <<
+            "DMA: no Navigator DMA support in this build (see PENTEK_NAV_DMA)";
+    _bufferPool.reset(new Pentek_xx821BufferPool(blockBytes, nBlocks,
+                                                 _numaNode));
+#endif
 }
+
+void
+Pentek_xx821::setServiceThreadConfig(
+        const Pentek_xx821ServiceThread::Config & config) {
+    boost::recursive_mutex::scoped_lock guard(_mutex);
+    _serviceThreadConfig = config;
+}
+
+Pentek_xx821ServiceThread::Config
+Pentek_xx821::serviceThreadConfig() const {
+    boost::recursive_mutex::scoped_lock guard(_mutex);
+    return(_serviceThreadConfig);
+}
+
+Pentek_xx821ServiceThread &
+Pentek_xx821::startServiceThread(const std::string & name,
+                                 Pentek_xx821ServiceThread::Body body) {
+    boost::recursive_mutex::scoped_lock guard(_mutex);
+    _serviceThreads.emplace_back(
+            new Pentek_xx821ServiceThread(name, _serviceThreadConfig, body));
+    return(*_serviceThreads.back());
+}
+
+void
+Pentek_xx821::stopServiceThreads() {
+    // Ask all of the threads to stop before waiting for any of them. The
+    // threads are joined without holding the board lock, since they may
+    // need it to finish.
+    std::vector<std::unique_ptr<Pentek_xx821ServiceThread> > threads;
+    {
+        boost::recursive_mutex::scoped_lock guard(_mutex);
+        threads.swap(_serviceThreads);
+    }
+    for (auto & thread : threads) {
+        thread->requestStop();
+    }
+    threads.clear();
+}
+
+void
+Pentek_xx821::startHealthSampler(uint32_t periodMs,
+                                 const HealthReader & reader,
+                                 const std::weak_ptr<void> & readerOwner) {
+    boost::recursive_mutex::scoped_lock guard(_mutex);
+    _healthPeriodMs = std::max(periodMs, 1u);
+    if (_healthThread) {
+        return;
+    }
+    _healthReader = reader;
+    _healthReaderOwner = readerOwner;
+    // An empty weak_ptr means no owner; an expired one still counts as one
+    static const std::weak_ptr<void> noOwner;
+    _healthReaderOwned = readerOwner.owner_before(noOwner) ||
+                         noOwner.owner_before(readerOwner);
+    // The sampler only needs to keep off the data path: no pinning, no
+    // SCHED_FIFO, and deferred logging so it never blocks on log output
+    Pentek_xx821ServiceThread::Config config;
+    config.fifoPriority = 0;
+    config.lockMemory = false;
+    config.deferLogging = true;
+    std::ostringstream name;
+    name << "xx821health" << _boardNum;
+    _healthThread.reset(new Pentek_xx821ServiceThread(name.str(), config,
+            [this](Pentek_xx821ServiceThread & thread) {
+                _runHealthSampler(thread);
+            }));
+}
+
+void
+Pentek_xx821::stopHealthSampler() {
+    // Join the thread without holding the board lock
+    std::unique_ptr<Pentek_xx821ServiceThread> thread;
+    {
+        boost::recursive_mutex::scoped_lock guard(_mutex);
+        thread.swap(_healthThread);
+    }
+    thread.reset();
+    boost::recursive_mutex::scoped_lock guard(_mutex);
+    if (! _healthThread) {
+        _healthReader = HealthReader();
+        _healthReaderOwner.reset();
+        _healthReaderOwned = false;
+    }
+}
+
+void
+Pentek_xx821::_runHealthSampler(Pentek_xx821ServiceThread & thread) {
+    // Sleep in short steps so that a stop request is seen promptly even
+    // with a long sampling period
+    static const uint32_t STOP_CHECK_MS = 50;
+
+    Pentek_xx821Health::Snapshot prev = _health.snapshot();
+    while (! thread.stopRequested()) {
+        Pentek_xx821Health::Snapshot snap = prev;
+        snap.sampleCount = prev.sampleCount + 1;
+        snap.sampleTime = Pentek_xx821Telemetry::Now();
+        snap.faults = 0;
+
+        int32_t status = NAV_GetPcieLinkStatus(_boardHandle, &snap.linkSpeed,
+                                               &snap.linkWidth,
+                                               &snap.maxPayloadSize,
+                                               &snap.maxReadReqSize,
+                                               &snap.linkStatus);
+        if (status != NAV_STAT_OK) {
+            snap.faults |= Pentek_xx821Health::FAULT_LINK_QUERY;
+        } else if (snap.linkSpeed < _initialLinkSpeed ||
+                   snap.linkWidth < _initialLinkWidth) {
+            snap.faults |= Pentek_xx821Health::FAULT_LINK_DOWNTRAINED;
+        }
+        if (_healthReader) {
+            // Keep the reader's owner, if it has one, alive for the call
+            std::shared_ptr<void> owner = _healthReaderOwner.lock();
+            if (owner || ! _healthReaderOwned) {
+                _healthReader(snap);
+            }
+        }
+        if (snap.haveClockLock && ! snap.clockLocked) {
+            snap.faults |= Pentek_xx821Health::FAULT_CLOCK_UNLOCKED;
+        }
+
+        // Count and log faults as they appear and clear
+        uint32_t newFaults = snap.faults & ~prev.faults;
+        if (newFaults) {
+            snap.faultEvents++;
+            DEFERRABLE_WLOG("Board " << _boardNum << " health fault: " <<
+                            Pentek_xx821Health::FaultString(newFaults) <<
+                            " (PCIe link gen " << snap.linkSpeed << " x" <<
+                            snap.linkWidth << ", was gen " <<
+                            _initialLinkSpeed << " x" << _initialLinkWidth <<
+                            ")");
+        }
+        uint32_t clearedFaults = prev.faults & ~snap.faults;
+        if (clearedFaults && prev.sampleCount > 0) {
+            DEFERRABLE_ILOG("Board " << _boardNum <<
+                            " health fault cleared: " <<
+                            Pentek_xx821Health::FaultString(clearedFaults));
+        }
+
+        _health.publish(snap);
+        prev = snap;
+
+        uint64_t wakeTime = snap.sampleTime +
+                            uint64_t(_healthPeriodMs.load()) * 1000000;
+        while (! thread.stopRequested()) {
+            uint64_t now = Pentek_xx821Telemetry::Now();
+            if (now >= wakeTime) {
+                break;
+            }
+            uint64_t sleepUs = std::min<uint64_t>((wakeTime - now) / 1000 + 1,
+                                                  STOP_CHECK_MS * 1000);
+            usleep(sleepUs);
+        }
+    }
+}
+
+void
+Pentek_xx821::_AcquireNavigator() {
+    boost::mutex::scoped_lock guard(_BspMutex);
+    if (_BspUsers == 0) {
+        int32_t status = NAV_BoardStartup();
+        if (status != NAV_STAT_OK) {
+            std::ostringstream os;
+            os << "Error in call to NAV_BoardStartup(): " << NavApiStatus[status];
+            throw ConstructError(os.str());
+        }
+        DLOG << "Opened Navigator BSP";
+    }
+    _BspUsers++;
+}
+
 void
 Pentek_xx821::_CloseNavigatorOnLastInstance() {
-    if (_InstanceCount == 0) {
+    boost::mutex::scoped_lock guard(_BspMutex);
+    if (--_BspUsers == 0) {
         DLOG << "Closing Navigator BSP";
         NAV_BoardFinish();
+        // Board list entries belong to the BSP, so they're now invalid
+        _NumBoards = -1;
+    }
+}
+
+int32_t
+Pentek_xx821::_FindBoards() {
+    boost::mutex::scoped_lock guard(_BspMutex);
+    if (_NumBoards < 0) {
+        int32_t numBoards;
+        int32_t status = NAV_BoardFind(0, _BoardList, &numBoards);
+        if (status != NAV_STAT_OK) {
+            guard.unlock();
+            _AbortCtorOnNavStatusError(status, "NAV_BoardFind");
+        }
+        _NumBoards = numBoards;
+        DLOG << _NumBoards << ((_NumBoards == 1) ? " board " : " boards ") <<
+                "found";
+    }
+    return(_NumBoards);
+}
+
+void
+Pentek_xx821::writeLiteRegisterBlock_(uint32_t blockbase,
+                                      const uint32_t * vals, size_t count,
+                                      const char * action) const {
+    // Validate the block before touching the hardware. The message is only
+    // built if something is actually wrong.
+    if ((blockbase % 4) != 0 ||
+            count > (uint64_t(UINT32_MAX) + 1 - blockbase) / 4) {
+        std::ostringstream os;
+        os << action << (*action ? ": " : "") <<
+              "bad register block at 0x" << std::hex << blockbase <<
+              std::dec << " with " << count << " words";
+        throw std::invalid_argument(os.str());
+    }
+
+    // With the shadow register cache enabled, deferred writes must reach the
+    // board before the block does, and the shadow needs to see the block.
+    // Lock the regions the block overlaps, in the same (index) order as
+    // _lockAllRegRegions().
+    uint32_t regions = 0;
+    if (_regCacheEnabled && count > 0) {
+        regions = _regRegionsOverlapped(blockbase,
+                                        blockbase + 4 * (count - 1));
+        for (int r = 0; r < REG_REGION_COUNT; r++) {
+            if (regions & (1u << r)) {
+                _regRegions[r].mutex.lock();
+                _flushRegRegion(_regRegions[r]);
+            }
+        }
+    }
+
+    // Plain back-to-back 32-bit stores. With all mask bits set, NavRegWrite()
+    // reduces to the same store, so this is equivalent to calling
+    // writeLiteRegister_() for each word, minus the per-call overhead.
+    volatile uint32_t * dst = _boardInfoRegBase() + blockbase / 4;
+    for (size_t ndx = 0; ndx < count; ndx++) {
+        _mmioStore(dst + ndx, vals[ndx]);
+    }
+    _telemetry.count(Pentek_xx821Telemetry::REG_WRITES, count);
+
+    // Drain any write-combining buffers so the block is fully posted
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_sfence();
+#else
+    __sync_synchronize();
+#endif
+
+    if (regions) {
+        for (size_t ndx = 0; ndx < count; ndx++) {
+            uint32_t regaddr = blockbase + 4 * ndx;
+            Pentek_xx821RegCache & cache =
+                    _regRegions[_regRegion(regaddr)].cache;
+            if (cache.isCacheable(regaddr)) {
+                cache.fill(regaddr, vals[ndx]);
+            }
+        }
+        for (int r = REG_REGION_COUNT - 1; r >= 0; r--) {
+            if (regions & (1u << r)) {
+                _regRegions[r].mutex.unlock();
+            }
+        }
+    }
+}
+
+bool
+Pentek_xx821::applyProfile_(const Pentek_xx821Profile & profile,
+                            bool arm) const {
+    if (! profile.compiled()) {
+        ELOG << "Profile '" << profile.name() << "' applied before compile()";
+        return(false);
+    }
+
+    const std::vector<Pentek_xx821Profile::Run> & runs = profile.runs();
+    const uint32_t * values = profile.values().data();
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (runs[r].count == 1) {
+            writeLiteRegister_(runs[r].firstAddr, values[runs[r].firstValue]);
+        } else {
+            writeLiteRegisterBlock_(runs[r].firstAddr,
+                                    values + runs[r].firstValue,
+                                    runs[r].count);
+        }
+    }
+
+    if (arm && profile.hasArmWrite()) {
+        writeLiteRegister_(profile.armAddr(), profile.armValue());
+    }
+    return(true);
+}
+
+size_t
+Pentek_xx821::loadWaveform_(Pentek_xx821WaveformCache & cache,
+                            const uint32_t * words, size_t count) const {
+    const std::vector<Pentek_xx821WaveformCache::Run> & runs =
+            cache.diff(words, count);
+    for (size_t r = 0; r < runs.size(); r++) {
+        writeLiteRegisterBlock_(cache.tableBase() + 4 * runs[r].firstWord,
+                                words + runs[r].firstWord, runs[r].count);
+    }
+    cache.commit(words, count);
+    return(cache.lastUploadWords());
+}
+
+Pentek_xx821::RegRegion
+Pentek_xx821::_regRegion(uint32_t regaddr) const {
+    // The region is the one with the highest start address at or below
+    // regaddr. Regions are not assumed to be in any particular order.
+    RegRegion region = REG_REGION_BOARD_INFO;
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        if (_regRegionStart[r] <= regaddr &&
+                _regRegionStart[r] >= _regRegionStart[region]) {
+            region = RegRegion(r);
+        }
+    }
+    return(region);
+}
+
+uint32_t
+Pentek_xx821::_regRegionsOverlapped(uint32_t firstAddr,
+                                    uint32_t lastAddr) const {
+    // The range overlaps the region holding its first register, plus the
+    // region of each region start inside the range
+    uint32_t regions = 1u << _regRegion(firstAddr);
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        uint32_t start = _regRegionStart[r];
+        if (start > firstAddr && start <= lastAddr) {
+            regions |= 1u << _regRegion(start);
+        }
+    }
+    return(regions);
+}
+
+void
+Pentek_xx821::_lockAllRegRegions() const {
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        _regRegions[r].mutex.lock();
+    }
+}
+
+void
+Pentek_xx821::_unlockAllRegRegions() const {
+    for (int r = REG_REGION_COUNT - 1; r >= 0; r--) {
+        _regRegions[r].mutex.unlock();
+    }
+}
+
+void
+Pentek_xx821::enableRegisterCache(bool enable) {
+    _lockAllRegRegions();
+    if (! enable) {
+        for (int r = 0; r < REG_REGION_COUNT; r++) {
+            _flushRegRegion(_regRegions[r]);
+            _regRegions[r].cache.invalidate();
+        }
+    }
+    _regCacheEnabled = enable;
+    _unlockAllRegRegions();
+}
+
+void
+Pentek_xx821::setDeferredRegisterWrites(bool defer) {
+    _lockAllRegRegions();
+    if (! defer) {
+        for (int r = 0; r < REG_REGION_COUNT; r++) {
+            _flushRegRegion(_regRegions[r]);
+        }
+    }
+    _deferRegWrites = defer;
+    _unlockAllRegRegions();
+}
+
+void
+Pentek_xx821::flush() {
+    // Regions are independent, so flush them one at a time
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        boost::mutex::scoped_lock guard(_regRegions[r].mutex);
+        _flushRegRegion(_regRegions[r]);
+    }
+}
+
+void
+Pentek_xx821::_declareCacheableRegisters(uint32_t firstAddr, uint32_t nBytes) {
+    // Each region's cache only ever sees addresses in that region, so the
+    // declaration can simply be given to all of them.
+    _lockAllRegRegions();
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        _regRegions[r].cache.declareCacheable(firstAddr, nBytes);
+    }
+    _unlockAllRegRegions();
+}
+
+void
+Pentek_xx821::_declareUncacheableRegisters(uint32_t firstAddr,
+                                           uint32_t nBytes) {
+    _lockAllRegRegions();
+    for (int r = 0; r < REG_REGION_COUNT; r++) {
+        // Make sure pending writes to the affected registers aren't lost
+        _flushRegRegion(_regRegions[r]);
+        _regRegions[r].cache.declareUncacheable(firstAddr, nBytes);
+    }
+    _unlockAllRegRegions();
+}
+
+void
+Pentek_xx821::_cachedWriteLiteRegister(uint32_t regaddr, uint32_t val) const {
+    RegRegionState & region = _regRegions[_regRegion(regaddr)];
+    boost::mutex::scoped_lock guard(region.mutex);
+    _cachedWriteLocked(region, regaddr, val);
+}
+
+uint32_t
+Pentek_xx821::_cachedReadLiteRegister(uint32_t regaddr) const {
+    RegRegionState & region = _regRegions[_regRegion(regaddr)];
+    boost::mutex::scoped_lock guard(region.mutex);
+    return(_cachedReadLocked(region, regaddr));
+}
+
+void
+Pentek_xx821::_cachedWriteLocked(RegRegionState & region, uint32_t regaddr,
+                                 uint32_t val) const {
+    // Recheck, since the cache may have been disabled while we waited for
+    // the lock
+    if (! _regCacheEnabled || ! region.cache.isCacheable(regaddr)) {
+        // Keep the board seeing writes in program order
+        _flushRegRegion(region);
+        _hwWriteLiteRegister(regaddr, val);
+        return;
+    }
+
+    if (_deferRegWrites) {
+        region.cache.store(regaddr, val);
+    } else {
+        _hwWriteLiteRegister(regaddr, val);
+        region.cache.fill(regaddr, val);
+    }
+}
+
+uint32_t
+Pentek_xx821::_cachedReadLocked(RegRegionState & region,
+                                uint32_t regaddr) const {
+    if (! _regCacheEnabled || ! region.cache.isCacheable(regaddr)) {
+        return(_hwReadLiteRegister(regaddr));
+    }
+
+    uint32_t val;
+    if (! region.cache.lookup(regaddr, val)) {
+        val = _hwReadLiteRegister(regaddr);
+        region.cache.fill(regaddr, val);
+    }
+    return(val);
+}
+
+void
+Pentek_xx821::applyFieldUpdate_(const Pentek_xx821FieldUpdate & update) const {
+    const std::vector<Pentek_xx821FieldUpdate::RegUpdate> & updates =
+            update.updates();
+    for (size_t i = 0; i < updates.size(); i++) {
+        const Pentek_xx821FieldUpdate::RegUpdate & u = updates[i];
+        bool wholeRegister = (u.mask == 0xffffffffUL);
+
+        if (! _regCacheEnabled) {
+            uint32_t raw = wholeRegister ? 0 : _hwReadLiteRegister(u.regaddr);
+            _hwWriteLiteRegister(u.regaddr, (raw & ~u.mask) | u.bits);
+            continue;
+        }
+
+        // With the cache enabled, the read (if any) and write happen under
+        // the region lock, so the read comes from the shadow when it can.
+        RegRegionState & region = _regRegions[_regRegion(u.regaddr)];
+        boost::mutex::scoped_lock guard(region.mutex);
+        uint32_t raw = wholeRegister ? 0 : _cachedReadLocked(region, u.regaddr);
+        _cachedWriteLocked(region, u.regaddr, (raw & ~u.mask) | u.bits);
+    }
+}
+
+void
+Pentek_xx821::_flushRegRegion(RegRegionState & region) const {
+    if (! region.cache.hasDirty()) {
+        return;
+    }
+    region.cache.takeDirty(region.flushList);
+    for (size_t i = 0; i < region.flushList.size(); i++) {
+        _hwWriteLiteRegister(region.flushList[i].first,
+                             region.flushList[i].second);
     }
 }
 
@@ -220,8 +914,17 @@ Pentek_xx821::boardInfoString() const {
           wordOffset << " 32-bit words" << std::endl;
 
     // ADC and DAC channel counts
+    os << std::dec;
     os << "    " << _adcCount << " ADC channels" << std::endl;
     os << "    " << _dacCount << " DAC channels" << std::endl;
 
+    // Runtime counters and latencies
+    os << "    Telemetry:" << std::endl;
+    os << _telemetry.summary("        ");
+
+    // Latest health sample
+    os << "    Health:" << std::endl;
+    os << _health.summary("        ");
+
     return(os.str());
 }
@@ -35,17 +35,50 @@
 #include <nav_common.h>
 #include <820_include/nav820.h>
 
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 
+#include "Pentek_xx821BufferPool.h"
+#include "Pentek_xx821FieldUpdate.h"
+#include "Pentek_xx821Health.h"
+#include "Pentek_xx821NavDma.h"
+#include "Pentek_xx821Profile.h"
+#include "Pentek_xx821RegCache.h"
+#include "Pentek_xx821Registers.h"
+#include "Pentek_xx821ServiceThread.h"
+#include "Pentek_xx821Telemetry.h"
+#include "Pentek_xx821WaveformCache.h"
+
+#include <cstddef>
 #include <cstdint>
 #include <atomic>
 #include <exception>
+#include <functional>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 /// @brief Class which encapsulates access to a Pentek xx821-series transceiver
 /// card
+///
+/// Locking is split so that threads working on unrelated parts of the board
+/// don't contend:
+/// - Plain register reads and writes take no lock at all; 32-bit MMIO
+///   accesses are atomic on their own.
+/// - The shadow register cache is split by register region (board info,
+///   USER BLOCK 1 and USER BLOCK 2), each with its own lock, so cached
+///   access to one region never waits for another.
+/// - Board configuration which is fixed after construction (channel counts,
+///   NUMA node, etc.) is read without locking.
+/// - _mutex is only used for board-wide operations such as construction,
+///   DMA channel setup and buffer pool creation.
 class Pentek_xx821 {
 public:
+    /// @brief Largest DMA read (board reading host memory) which is safe to
+    /// request when PCIe 'max read request size' is larger than this
+    static const uint32_t MAX_SAFE_DMA_READ_BYTES = 2048;
+
     /// @brief constructor
     /// @param boardNum number of the xx821 board to open (0 = first board,
     /// 1 = second board, etc.) [default = 0]
@@ -60,6 +93,46 @@ public:
         ConstructError(std::string msg) : std::runtime_error(msg) {}
     };
 
+    /// @brief How DMA channels wait for completions
+    enum CompletionMode {
+        /// @brief Sleep until the board signals a completion (default)
+        COMPLETION_INTERRUPT,
+        /// @brief Spin on the completion descriptors
+        COMPLETION_POLL,
+        /// @brief Spin while traffic is heavy, sleep on interrupts when it
+        /// isn't
+        COMPLETION_ADAPTIVE
+    };
+
+    /// @brief Default traffic threshold for COMPLETION_ADAPTIVE: the
+    /// completion interval below which waits poll, in nanoseconds
+    static const uint32_t DEFAULT_ADAPTIVE_THRESHOLD_NS = 100000;
+
+    /// @brief Default period of the health sampler, ms
+    static const uint32_t DEFAULT_HEALTH_PERIOD_MS = 1000;
+
+    /// @brief Time spent in each phase of construction, in seconds
+    struct OpenTiming {
+        /// @brief Navigator BSP startup (zero if it was already open)
+        double startup;
+        /// @brief Board enumeration (near zero if already enumerated)
+        double find;
+        /// @brief NAV_BoardOpen()
+        double open;
+        /// @brief NAVsys_Init()
+        double sysInit;
+        /// @brief NAV_GetPcieLinkStatus()
+        double linkStatus;
+        /// @brief NAV_GetBoardSpec() queries
+        double boardSpec;
+        /// @brief The whole constructor
+        double total;
+    };
+
+    /// @brief Return the time spent in each phase of construction
+    /// @return the time spent in each phase of construction
+    const OpenTiming & openTiming() const { return(_openTiming); }
+
     /// @brief Return a string with information about the board and
     /// configuration
     /// @return a string with information about the board and configuration
@@ -69,18 +142,249 @@ public:
     /// @return the number of ADC channels on the board
     int32_t adcCount() const { return(_adcCount); }
 
+    /// @brief Return the number of DDC instances on the board
+    /// @return the number of DDC instances on the board
+    int32_t ddcCount() const { return(_ddcCount); }
+
     /// @brief Return the number of DAC channels on the board
     /// @return the number of DAC channels on the board
     int32_t dacCount() const { return(_dacCount); }
 
+    /// @brief Return the board number
+    /// @return the board number
+    uint16_t boardNum() const { return(_boardNum); }
+
+    /// @brief Return the PCI address of the board
+    /// @return the PCI address of the board, in the form "dddd:bb:ss.f"
+    std::string pciAddress() const;
+
+    /// @brief Return the NUMA node the board is attached to, or -1 if it is
+    /// unknown
+    /// @return the NUMA node the board is attached to, or -1 if unknown
+    int numaNode() const { return(_numaNode); }
+
+    /// @brief Create the board's sample buffer pool, replacing any existing
+    /// one
+    ///
+    /// The pool's memory is placed on the board's NUMA node, in 2 MB
+    /// hugepages, and mapped for DMA by the board. Pentek_xx821Dn and
+    /// Pentek_xx821Up objects constructed afterward take their ring buffers
+    /// from the pool when its blocks are big enough. Any existing pool must
+    /// have no blocks in use. In a build without Navigator DMA support (see
+    /// Pentek_xx821NavDma.h), the memory is not mapped, and falls back to
+    /// normal pages if no hugepages are available.
+    /// @param blockBytes the size of each buffer in the pool, in bytes, at
+    /// most Pentek_xx821BufferPool::ARENA_BYTES
+    /// @param nBlocks the number of buffers in the pool
+    /// @throws Pentek_xx821BufferPool::ConstructError if the pool cannot be
+    /// created, e.g. because too few hugepages are reserved
+    void createBufferPool(uint32_t blockBytes, uint32_t nBlocks);
+
+    /// @brief Return the board's sample buffer pool, or NULL if none has been
+    /// created
+    /// @return the board's sample buffer pool, or NULL if none has been
+    /// created
+    Pentek_xx821BufferPool * bufferPool() const { return(_bufferPool.get()); }
+
+    /// @brief Set how the board's DMA channels wait for completions
+    ///
+    /// Polling gives the lowest and least jittery latency, at the cost of a
+    /// CPU core spinning while a channel waits. Adaptive mode polls only
+    /// while completions arrive more often than adaptiveThresholdNs(), and
+    /// otherwise waits for interrupts. The change applies to the next wait
+    /// of each channel.
+    /// @param mode the completion mode
+    /// @param pollCpu if non-negative, the CPU to which threads are pinned
+    /// when they poll for completions
+    void setCompletionMode(CompletionMode mode, int pollCpu = -1) {
+        _pollCpu = pollCpu;
+        _completionMode = mode;
+    }
+
+    /// @brief Return how the board's DMA channels wait for completions
+    /// @return how the board's DMA channels wait for completions
+    CompletionMode completionMode() const { return(_completionMode); }
+
+    /// @brief Return the CPU to which polling threads are pinned, or -1
+    /// @return the CPU to which polling threads are pinned, or -1 if they
+    /// are not pinned
+    int pollCpu() const { return(_pollCpu); }
+
+    /// @brief Set the COMPLETION_ADAPTIVE switch-over threshold
+    ///
+    /// A good value is around the measured cost of an interrupt wakeup
+    /// (see the rx_wait latency in bench_xx821 output with interrupt and
+    /// poll modes): below that completion interval, spinning for the next
+    /// completion is cheaper than sleeping for it.
+    /// @param ns completion interval below which waits poll, in nanoseconds
+    void setAdaptiveThreshold(uint32_t ns) { _adaptiveThresholdNs = ns; }
+
+    /// @brief Return the COMPLETION_ADAPTIVE switch-over threshold
+    /// @return the completion interval below which waits poll, in
+    /// nanoseconds
+    uint32_t adaptiveThresholdNs() const { return(_adaptiveThresholdNs); }
+
+    /// @brief Set the scheduling and isolation settings for service threads
+    /// started afterward
+    ///
+    /// The default pins service threads to the CPUs of the board's NUMA
+    /// node and defers logging, without SCHED_FIFO or memory locking.
+    /// Memory locking applies to the whole process (see
+    /// Pentek_xx821ServiceThread::Config::lockMemory), so it is opt-in.
+    /// @param config the settings for new service threads
+    void setServiceThreadConfig(const Pentek_xx821ServiceThread::Config & config);
+
+    /// @brief Return the settings used for new service threads
+    /// @return the settings used for new service threads
+    Pentek_xx821ServiceThread::Config serviceThreadConfig() const;
+
+    /// @brief Start a thread servicing this board, using the board's service
+    /// thread settings
+    ///
+    /// The board owns the thread, and stops it (see
+    /// Pentek_xx821ServiceThread::stopRequested()) before the board is
+    /// destroyed.
+    /// @param name the thread name
+    /// @param body the thread body
+    /// @return the new service thread
+    Pentek_xx821ServiceThread &
+    startServiceThread(const std::string & name,
+                       Pentek_xx821ServiceThread::Body body);
+
+    /// @brief Stop all of the board's service threads and wait for them to
+    /// exit
+    void stopServiceThreads();
+
+    /// @brief Return the board's runtime counters and latency histograms
+    /// @return the board's runtime counters and latency histograms
+    Pentek_xx821Telemetry & telemetry() { return(_telemetry); }
+
+    /// @brief Return the board's runtime counters and latency histograms
+    /// @return the board's runtime counters and latency histograms
+    const Pentek_xx821Telemetry & telemetry() const { return(_telemetry); }
+
+    /// @brief Function which reads firmware-specific health registers
+    /// (e.g., temperature and sample clock lock) into a health sample
+    ///
+    /// It is called from the health sampler thread once per period, after
+    /// the PCIe link status has been filled in. It sets the matching
+    /// haveXxx flags for the values it fills in, must not take the board
+    /// lock, and should only read registers.
+    typedef std::function<void(Pentek_xx821Health::Snapshot & snap)>
+            HealthReader;
+
+    /// @brief Start sampling the board's health in a background thread
+    ///
+    /// Each period the sampler queries the PCIe link status and any health
+    /// registers read by the given reader, and publishes the results for
+    /// health(). A link which has trained down in speed or width since the
+    /// board was opened, or an unlocked sample clock, is flagged (and
+    /// logged) in the first sample which sees it. The sampler runs at
+    /// normal priority on any CPU, and never takes the board lock, so it
+    /// does not disturb the data path. If the sampler is already running,
+    /// only its period is changed; stop it first to change the reader.
+    ///
+    /// Whatever the reader uses must outlive its calls. If it belongs to a
+    /// shared_ptr-managed object, pass a weak_ptr to that object as
+    /// readerOwner: the sampler holds the owner for each call, and skips
+    /// the reader once the owner is gone. Otherwise (e.g., for a board
+    /// subclass reading its own registers) the caller must call
+    /// stopHealthSampler() before the reader's state goes away. The board's
+    /// destructor stops a sampler left running and logs an error, but by
+    /// then a subclass reader may already have run on a destroyed object.
+    /// @param periodMs the sampling period, ms
+    /// @param reader the function which reads firmware-specific health
+    /// registers, or an empty function if there are none
+    /// @param readerOwner the object owning the reader's state, or an empty
+    /// weak_ptr if the caller manages the reader's lifetime itself
+    void startHealthSampler(
+            uint32_t periodMs = DEFAULT_HEALTH_PERIOD_MS,
+            const HealthReader & reader = HealthReader(),
+            const std::weak_ptr<void> & readerOwner = std::weak_ptr<void>());
+
+    /// @brief Stop the health sampler, if it is running, and wait for it to
+    /// exit. The last sample remains available from health().
+    void stopHealthSampler();
+
+    /// @brief Return the latest health sample
+    ///
+    /// This only copies the sample most recently published by the health
+    /// sampler; it never touches the hardware or takes a lock, so it may be
+    /// called from any thread, including time-critical ones.
+    /// @return the latest health sample, with sampleCount zero if the
+    /// sampler has not yet run
+    Pentek_xx821Health::Snapshot health() const {
+        return(_health.snapshot());
+    }
+
+    /// @brief Return the segment size used for DMA reads initiated by the
+    /// board, or zero if DMA reads are not segmented
+    ///
+    /// DMA reads are segmented automatically when the host's PCIe 'max read
+    /// request size' would trigger a Pentek bug causing them to time out.
+    /// @return the DMA read segment size in bytes, or zero if DMA reads are
+    /// not segmented
+    uint32_t dmaReadSegmentBytes() const { return(_dmaReadSegmentBytes); }
+
+    /// @brief Enable or disable the shadow register cache
+    ///
+    /// When the cache is enabled, reads of registers declared cacheable are
+    /// served from a host-side shadow copy after the first hardware read, and
+    /// writes to them update the shadow. Registers not declared cacheable
+    /// are always read from and written to the hardware. The cache is
+    /// disabled by default.
+    ///
+    /// Disabling the cache flushes any deferred writes and then discards all
+    /// shadow values.
+    /// @param enable true to enable the cache, false to disable it
+    void enableRegisterCache(bool enable);
+
+    /// @brief Return true iff the shadow register cache is enabled
+    /// @return true iff the shadow register cache is enabled
+    bool registerCacheEnabled() const { return(_regCacheEnabled); }
+
+    /// @brief Select whether writes to cacheable registers are deferred
+    ///
+    /// With deferred writes (and the cache enabled), writing a cacheable
+    /// register only updates its shadow and marks it dirty; dirty registers
+    /// are written to the board by flush(). To keep the board seeing writes
+    /// to a register region (board info, USER BLOCK 1 or USER BLOCK 2) in
+    /// program order, the region's pending dirty registers are also flushed
+    /// before any write to an uncacheable register or register block in the
+    /// region. Turning deferral off flushes pending writes.
+    /// @param defer true to defer writes of cacheable registers, false to
+    /// write them through immediately (the default)
+    void setDeferredRegisterWrites(bool defer);
+
+    /// @brief Write all dirty shadow registers to the board, in ascending
+    /// address order
+    void flush();
+
 protected:
-    /// @brief Close the Navigator BSP if there are no instantiated objects
-    /// which need it.
+    friend class Pentek_xx821CompletionWaiter;
+    friend class Pentek_xx821Dn;
+    friend class Pentek_xx821Manager;
+    friend class Pentek_xx821Up;
+
+    /// @brief Register a new user of the Navigator BSP, starting the BSP if
+    /// this is the first user
+    /// @throws ConstructError if the BSP cannot be started
+    static void _AcquireNavigator();
+
+    /// @brief Release a user's hold on the Navigator BSP, and close the BSP
+    /// if there are no other users which need it.
     ///
     /// This is called from the constructor before throwing an exception, and
     /// from the destructor.
     static void _CloseNavigatorOnLastInstance();
 
+    /// @brief Enumerate the Pentek boards in the system, if that hasn't been
+    /// done since the Navigator BSP was started, and return the number of
+    /// boards. The caller must be a Navigator BSP user.
+    /// @return the number of boards in the system
+    /// @throws ConstructError if enumeration fails
+    static int32_t _FindBoards();
+
     /// @brief Return the generic (void*) board handle pointer reinterpreted
     /// as a pointer to NAV_BOARD_RESRC.
     /// @return the generic board handle pointer reinterpreted as a pointer to
@@ -107,6 +411,32 @@ protected:
         return(_boardResource()->ipBaseAddr.userBlock[1]);
     }
 
+    /// @brief Plain 32-bit load from board memory, for the accessors which
+    /// don't go through NavRegRead(). When built against the simulated
+    /// Navigator backend, the simulator's PCIe latency model is applied.
+    /// @param addr the register to read
+    /// @return the register value
+    static uint32_t _mmioLoad(volatile uint32_t * addr) {
+#ifdef NAV_SIM
+        return(NavSimRegLoad(addr));
+#else
+        return(*addr);
+#endif
+    }
+
+    /// @brief Plain 32-bit store to board memory, for the accessors which
+    /// don't go through NavRegWrite(). When built against the simulated
+    /// Navigator backend, the simulator's PCIe latency model is applied.
+    /// @param addr the register to write
+    /// @param val the value to write
+    static void _mmioStore(volatile uint32_t * addr, uint32_t val) {
+#ifdef NAV_SIM
+        NavSimRegStore(addr, val);
+#else
+        *addr = val;
+#endif
+    }
+
     /// @brief Throw ConstructError if the given status from a NAV_xxx()
     /// function call is an error
     /// @param status the status value returned by a NAV_xxx() function call
@@ -124,7 +454,43 @@ protected:
     /// @param prefix a string to be prepended to the error log message, if any
     static void _LogNavigatorError(int status, std::string prefix = "");
 
-    /// @brief Mutex for thread-safe access to instance members.
+    /// @brief Allocate pinned memory which the board can use for DMA
+    /// @param bytes the size of the allocation, in bytes
+    /// @param[out] busAddr the bus address of the memory as seen by the board
+    /// @return a pointer to the memory, or NULL if the allocation failed (in
+    /// which case an error is logged)
+    void * _allocDmaMemory(uint32_t bytes, uint64_t & busAddr) const;
+
+    /// @brief Free memory obtained from _allocDmaMemory()
+    /// @param mem pointer returned by _allocDmaMemory()
+    void _freeDmaMemory(void * mem) const;
+
+    /// @brief Get the DMA buffers for a ring of equal-sized buffers
+    ///
+    /// The buffers come from the board's buffer pool if it has enough free
+    /// blocks of sufficient size, or else from a single _allocDmaMemory()
+    /// allocation.
+    /// @param nBuffers the number of buffers
+    /// @param bufferBytes the size of each buffer, in bytes
+    /// @param[out] data the address of each buffer
+    /// @param[out] busAddrs the bus address of each buffer
+    /// @param[out] contiguousMem the single allocation holding all of the
+    /// buffers, or NULL if they came from the buffer pool
+    /// @return true iff the buffers were obtained
+    bool _allocRingBuffers(uint32_t nBuffers, uint32_t bufferBytes,
+                           std::vector<uint8_t *> & data,
+                           std::vector<uint64_t> & busAddrs,
+                           void *& contiguousMem) const;
+
+    /// @brief Free buffers obtained from _allocRingBuffers()
+    /// @param data the buffer addresses returned by _allocRingBuffers()
+    /// @param contiguousMem the allocation returned by _allocRingBuffers()
+    void _freeRingBuffers(std::vector<uint8_t *> & data,
+                          void * contiguousMem) const;
+
+    /// @brief Mutex for board-wide operations (construction, destruction,
+    /// DMA channel setup, buffer pool creation). Register access does not
+    /// use it.
     mutable boost::recursive_mutex _mutex;
 
     /// @brief Number of the associated xx821 board
@@ -137,7 +503,67 @@ protected:
     /// etc.
     NAV_SYS_CONTEXT _appSysContext;
 
-    /// @brief Count of ADCs on the board
+    /// @brief NUMA node the board is attached to, or -1 if unknown
+    int _numaNode;
+
+    /// @brief Sample buffer pool, if one has been created
+    std::unique_ptr<Pentek_xx821BufferPool> _bufferPool;
+
+    /// @brief Time spent in each phase of construction
+    OpenTiming _openTiming;
+
+    /// @brief Runtime counters and latency histograms
+    Pentek_xx821Telemetry _telemetry;
+
+    /// @brief How DMA channels wait for completions
+    std::atomic<CompletionMode> _completionMode;
+
+    /// @brief CPU to which polling threads are pinned, or -1
+    std::atomic<int> _pollCpu;
+
+    /// @brief COMPLETION_ADAPTIVE switch-over threshold, ns
+    std::atomic<uint32_t> _adaptiveThresholdNs;
+
+    /// @brief Settings for new service threads. Protected by _mutex.
+    Pentek_xx821ServiceThread::Config _serviceThreadConfig;
+
+    /// @brief The board's service threads. Protected by _mutex.
+    std::vector<std::unique_ptr<Pentek_xx821ServiceThread> > _serviceThreads;
+
+    /// @brief Latest health sample
+    Pentek_xx821Health _health;
+
+    /// @brief PCIe link speed when the board was opened
+    uint32_t _initialLinkSpeed;
+
+    /// @brief PCIe link width when the board was opened
+    uint32_t _initialLinkWidth;
+
+    /// @brief Health sampling period, ms
+    std::atomic<uint32_t> _healthPeriodMs;
+
+    /// @brief The health sampler thread, if running. Protected by _mutex.
+    std::unique_ptr<Pentek_xx821ServiceThread> _healthThread;
+
+    /// @brief The health sampler's register reader, or an empty function.
+    /// Set only while the sampler is stopped.
+    HealthReader _healthReader;
+
+    /// @brief The owner of the reader's state, if _healthReaderOwned. Set
+    /// only while the sampler is stopped.
+    std::weak_ptr<void> _healthReaderOwner;
+
+    /// @brief Was an owner given for the reader? Set only while the sampler
+    /// is stopped.
+    bool _healthReaderOwned;
+
+    /// @brief Segment size for DMA reads initiated by the board, or zero if
+    /// they are not segmented
+    uint32_t _dmaReadSegmentBytes;
+
+    /// @brief Count of ADCs on the board. This and the other counts are set
+    /// during construction and never change, so they may be read from any
+    /// thread without locking.
     int32_t _adcCount;
 
     /// @brief Count of DDC instances on the board
@@ -146,6 +572,57 @@ protected:
     /// @brief Count of DACs on the board
     int32_t _dacCount;
 
+    /// @brief Declare a range of AXI LITE registers as cacheable by the
+    /// shadow register cache
+    ///
+    /// Only registers whose contents are changed exclusively by the host
+    /// (i.e., configuration registers) should be declared cacheable.
+    /// @param firstAddr the address of the first register in the range
+    /// @param nBytes the size of the range, in bytes
+    void _declareCacheableRegisters(uint32_t firstAddr, uint32_t nBytes);
+
+    /// @brief Declare a range of AXI LITE registers as uncacheable, overriding
+    /// any cacheable declaration which includes them
+    ///
+    /// This is used to carve volatile status registers out of an otherwise
+    /// cacheable register block.
+    /// @param firstAddr the address of the first register in the range
+    /// @param nBytes the size of the range, in bytes
+    void _declareUncacheableRegisters(uint32_t firstAddr, uint32_t nBytes);
+
+    /// @brief Write a 32-bit value directly to the given AXI LITE register
+    /// address, bypassing the shadow register cache
+    /// @param regaddr the address of the target register
+    /// @param val the 32-bit value to write
+    void _hwWriteLiteRegister(uint32_t regaddr, uint32_t val) const {
+        _telemetry.count(Pentek_xx821Telemetry::REG_WRITES);
+        if (_telemetry.sampleLatency()) {
+            uint64_t t0 = Pentek_xx821Telemetry::Now();
+            NavRegWrite(_boardInfoRegBase() + regaddr/4, 0xffffffffUL, val);
+            _telemetry.recordLatency(Pentek_xx821Telemetry::HIST_REG_WRITE,
+                                     Pentek_xx821Telemetry::Now() - t0);
+            return;
+        }
+        NavRegWrite(_boardInfoRegBase() + regaddr/4, 0xffffffffUL, val);
+    }
+
+    /// @brief Read a 32-bit value directly from the given AXI LITE register
+    /// address, bypassing the shadow register cache
+    /// @param regaddr the address of the source register
+    /// @return the 32-bit value read from the given register
+    uint32_t _hwReadLiteRegister(uint32_t regaddr) const {
+        _telemetry.count(Pentek_xx821Telemetry::REG_READS);
+        if (_telemetry.sampleLatency()) {
+            uint64_t t0 = Pentek_xx821Telemetry::Now();
+            uint32_t val = NavRegRead(_boardInfoRegBase() + regaddr/4,
+                                      0xffffffffUL);
+            _telemetry.recordLatency(Pentek_xx821Telemetry::HIST_REG_READ,
+                                     Pentek_xx821Telemetry::Now() - t0);
+            return(val);
+        }
+        return(NavRegRead(_boardInfoRegBase() + regaddr/4, 0xffffffffUL));
+    }
+
     /// @brief Write a 32-bit unsigned value to the given AXI LITE register
     /// address
     /// @param regaddr the address of the target register
@@ -153,9 +630,13 @@ protected:
     /// @param action the name of the action being performed by the register
     /// write, used to build a message when throwing an exception
     void writeLiteRegister_(uint32_t regaddr, uint32_t val,
-                            const std::string & action = "") const
+                            const char * action = "") const
     {
-        NavRegWrite(_boardResource()->ipBaseAddr.boardInfo + regaddr/4, 0xffffffffUL, val);
+        if (_regCacheEnabled) {
+            _cachedWriteLiteRegister(regaddr, val);
+        } else {
+            _hwWriteLiteRegister(regaddr, val);
+        }
     }
 
     /// @brief Write a 32-bit signed value to the given AXI LITE register
@@ -165,7 +646,7 @@ protected:
     /// @param action the name of the action being performed by the register
     /// write, used to build a message when throwing an exception
     void writeLiteRegister_(uint32_t regaddr, int32_t val,
-                            const std::string & action = "") const
+                            const char * action = "") const
     {
         // Quick implementation just reinterprets the signed value as unsigned
         // and calls the uint32_t version above...
@@ -173,6 +654,35 @@ protected:
         writeLiteRegister_(regaddr, *uValPtr, action);
     }
 
+    /// @brief Compatibility overload of writeLiteRegister_() taking the
+    /// action as a std::string
+    template <typename T>
+    void writeLiteRegister_(uint32_t regaddr, T val,
+                            const std::string & action) const
+    {
+        writeLiteRegister_(regaddr, val, action.c_str());
+    }
+
+    /// @brief Write a contiguous block of 32-bit values to consecutive AXI
+    /// LITE registers starting at the given address
+    ///
+    /// The values are stored back-to-back directly into the mapped register
+    /// window, with no allocation or message formatting per word. If the BAR
+    /// is mapped write-combining, the CPU merges the stores into PCIe bursts;
+    /// a store fence after the last word makes sure the whole block has been
+    /// issued before returning.
+    /// @param blockbase the register block base address, which must be a
+    /// multiple of 4
+    /// @param vals pointer to the first of the values to write
+    /// @param count the number of 32-bit values to write
+    /// @param action the name of the action being performed by the register
+    /// write, used to build a message when throwing an exception
+    /// @throws std::invalid_argument if blockbase is not 4-byte aligned or
+    /// the block extends past the end of the 32-bit register address space
+    void writeLiteRegisterBlock_(uint32_t blockbase, const uint32_t * vals,
+                                 size_t count,
+                                 const char * action = "") const;
+
     /// @brief Template to write a vector of values to a block of consecutive
     /// AXI LITE registers at a given starting address
     ///
@@ -184,14 +694,23 @@ protected:
     template <typename T>
     void writeLiteRegisterBlock_(uint32_t blockbase,
                                  const std::vector<T> & vals,
-                                 const std::string & action = "") const
+                                 const char * action = "") const
     {
-        for (int ndx = 0; ndx < vals.size(); ndx++)
-        {
-            std::ostringstream oss;
-            oss << action << " at ndx " << ndx;
-            writeLiteRegister_(blockbase + 4 * ndx, vals[ndx], oss.str());
-        }
+        static_assert(std::is_integral<T>::value && sizeof(T) == 4,
+                      "writeLiteRegisterBlock_ requires 32-bit integer values");
+        writeLiteRegisterBlock_(blockbase,
+                                reinterpret_cast<const uint32_t *>(vals.data()),
+                                vals.size(), action);
+    }
+
+    /// @brief Compatibility overload of writeLiteRegisterBlock_() taking the
+    /// action as a std::string
+    template <typename T>
+    void writeLiteRegisterBlock_(uint32_t blockbase,
+                                 const std::vector<T> & vals,
+                                 const std::string & action) const
+    {
+        writeLiteRegisterBlock_(blockbase, vals, action.c_str());
     }
 
     /// @brief Read a 32-bit value from the given AXI LITE register address and
@@ -201,21 +720,254 @@ protected:
     /// write, used to build a message when throwing an exception
     /// @return the 32-bit value read from the given register
     uint32_t readLiteRegister_(uint32_t regaddr,
-                               const std::string &action = "") const
+                               const char * action = "") const
     {
-       return NavRegRead(_boardResource()->ipBaseAddr.boardInfo + regaddr/4, 0xffffffffUL);
+        if (_regCacheEnabled) {
+            return(_cachedReadLiteRegister(regaddr));
+        }
+        return(_hwReadLiteRegister(regaddr));
     }
 
-private:
-    /// @brief Class-wide count of how many Pentek_xx821 objects are
-    /// instantiated
+    /// @brief Compatibility overload of readLiteRegister_() taking the action
+    /// as a std::string
+    uint32_t readLiteRegister_(uint32_t regaddr,
+                               const std::string & action) const
+    {
+        return(readLiteRegister_(regaddr, action.c_str()));
+    }
+
+    /// @brief Read a register described by a Pentek_xx821Reg type
+    ///
+    /// The register address is a compile-time constant, so with the shadow
+    /// register cache disabled this is a single volatile load, plus a
+    /// relaxed atomic add to the calling thread's telemetry slot. Reading a
+    /// write-only register fails to compile.
+    /// @return the register value
+    template <class REG>
+    uint32_t readRegister_() const
+    {
+        static_assert(REG::readable, "register is write-only");
+        if (_regCacheEnabled) {
+            return(_cachedReadLiteRegister(REG::addr));
+        }
+        _telemetry.count(Pentek_xx821Telemetry::REG_READS);
+        return(_mmioLoad(_boardInfoRegBase() + REG::addr / 4));
+    }
+
+    /// @brief Write a register described by a Pentek_xx821Reg type
     ///
-    /// The instance count is kept so that Pentek's Navigator board support
-    /// package can be closed as the last object using it is destroyed.
+    /// The register address is a compile-time constant, so with the shadow
+    /// register cache disabled this is a single volatile store, plus a
+    /// relaxed atomic add to the calling thread's telemetry slot. Writing a
+    /// read-only register fails to compile.
+    /// @param val the value to write
+    template <class REG>
+    void writeRegister_(uint32_t val) const
+    {
+        static_assert(REG::writable, "register is read-only");
+        if (_regCacheEnabled) {
+            _cachedWriteLiteRegister(REG::addr, val);
+        } else {
+            _telemetry.count(Pentek_xx821Telemetry::REG_WRITES);
+            _mmioStore(_boardInfoRegBase() + REG::addr / 4, val);
+        }
+    }
+
+    /// @brief Read a bit field described by a Pentek_xx821Field type
+    /// @return the field value, shifted down to bit 0
+    template <class FIELD>
+    uint32_t readField_() const
+    {
+        return(FIELD::Decode(readRegister_<typename FIELD::Register>()));
+    }
+
+    /// @brief Change a bit field described by a Pentek_xx821Field type,
+    /// leaving the rest of its register unchanged
+    ///
+    /// This is a read-modify-write, so the register must be read-write (or
+    /// the field must cover the whole register).
+    /// @param val the new field value, unshifted; bits which don't fit in
+    /// the field are discarded
+    template <class FIELD>
+    void writeField_(uint32_t val) const
+    {
+        _writeField<FIELD>(val, std::integral_constant<bool,
+                           FIELD::mask == 0xffffffffUL>());
+    }
+
+    /// @brief Apply a batch of bit field changes
     ///
-    /// This member is atomic to allow for thread-safe access, and private
-    /// because only this base class deals with Navigator BSP open and close.
-    static std::atomic<uint> _InstanceCount;
+    /// Each register named in the batch is written once, with all of its
+    /// field changes merged. The register is read first only if some of its
+    /// bits are left unchanged and its shadow value is not known.
+    /// @param update the batch of field changes
+    void applyFieldUpdate_(const Pentek_xx821FieldUpdate & update) const;
+
+    /// @brief Apply a compiled configuration profile
+    ///
+    /// The profile's compiled write list is written as back-to-back register
+    /// bursts, followed by the profile's arm register write if arming is
+    /// requested.
+    /// @param profile the profile, which must have been compiled
+    /// @param arm if true and the profile has an arm register write, issue
+    /// it after the other writes so the configuration takes effect at the
+    /// next sync pulse
+    /// @return true iff the profile was applied
+    bool applyProfile_(const Pentek_xx821Profile & profile,
+                       bool arm = false) const;
+
+    /// @brief Load a waveform into a DAC channel's waveform table, writing
+    /// only the words which differ from what the cache says is loaded
+    ///
+    /// The changed runs found by the cache are written as back-to-back
+    /// register bursts, then the cache is updated to match.
+    /// @param cache the channel's waveform cache
+    /// @param words the waveform
+    /// @param count the number of words in the waveform
+    /// @return the number of words written to the board
+    /// @throws std::invalid_argument if the waveform is larger than the
+    /// channel's waveform table
+    size_t loadWaveform_(Pentek_xx821WaveformCache & cache,
+                         const uint32_t * words, size_t count) const;
+
+    /// @brief Load a waveform held in a vector of 32-bit words; see
+    /// loadWaveform_(Pentek_xx821WaveformCache &, const uint32_t *, size_t)
+    template <typename T>
+    size_t loadWaveform_(Pentek_xx821WaveformCache & cache,
+                         const std::vector<T> & words) const
+    {
+        static_assert(std::is_integral<T>::value && sizeof(T) == 4,
+                      "loadWaveform_ requires 32-bit integer values");
+        return(loadWaveform_(cache,
+                             reinterpret_cast<const uint32_t *>(words.data()),
+                             words.size()));
+    }
+
+    /// @brief writeField_() for a field covering its whole register: a plain
+    /// write
+    template <class FIELD>
+    void _writeField(uint32_t val, std::true_type) const
+    {
+        writeRegister_<typename FIELD::Register>(FIELD::Encode(val));
+    }
+
+    /// @brief writeField_() for a field covering part of its register: a
+    /// read-modify-write
+    template <class FIELD>
+    void _writeField(uint32_t val, std::false_type) const
+    {
+        typedef typename FIELD::Register Reg;
+        static_assert(Reg::readable,
+                      "partial field write needs a readable register");
+        writeRegister_<Reg>(FIELD::Insert(readRegister_<Reg>(), val));
+    }
+
+    /// @brief Independently locked register regions
+    enum RegRegion {
+        REG_REGION_BOARD_INFO,
+        REG_REGION_USER_BLOCK_1,
+        REG_REGION_USER_BLOCK_2,
+        REG_REGION_COUNT
+    };
+
+    /// @brief Return the register region containing the given register
+    /// address
+    /// @param regaddr the register address
+    /// @return the register region containing the register
+    RegRegion _regRegion(uint32_t regaddr) const;
+
+    /// @brief Return the register regions overlapped by a range of register
+    /// addresses
+    /// @param firstAddr the address of the first register in the range
+    /// @param lastAddr the address of the last register in the range
+    /// @return a mask with bit (1 << r) set for each region r overlapped
+    uint32_t _regRegionsOverlapped(uint32_t firstAddr, uint32_t lastAddr) const;
+
+    /// @brief Is the shadow register cache enabled?
+    std::atomic<bool> _regCacheEnabled;
+
+    /// @brief Are writes to cacheable registers deferred until flush()?
+    std::atomic<bool> _deferRegWrites;
+
+private:
+    /// @brief Body of the health sampler thread
+    /// @param thread the health sampler thread
+    void _runHealthSampler(Pentek_xx821ServiceThread & thread);
+
+    /// @brief Register write through the shadow register cache
+    /// @param regaddr the address of the target register
+    /// @param val the 32-bit value to write
+    void _cachedWriteLiteRegister(uint32_t regaddr, uint32_t val) const;
+
+    /// @brief Register read through the shadow register cache
+    /// @param regaddr the address of the source register
+    /// @return the 32-bit register value
+    uint32_t _cachedReadLiteRegister(uint32_t regaddr) const;
+
+    /// @brief Lock, shadow cache and scratch space for one register region.
+    /// Padded to keep regions' locks out of each other's cache lines. (Not
+    /// alignas(64), since C++11 operator new doesn't honor over-alignment.)
+    struct RegRegionState {
+        /// @brief Lock for the region's shadow cache
+        boost::mutex mutex;
+        /// @brief Shadow cache for the region's registers
+        Pentek_xx821RegCache cache;
+        /// @brief Scratch list of (address, value) pairs used when flushing,
+        /// kept here so that its storage is reused
+        std::vector<std::pair<uint32_t, uint32_t> > flushList;
+        /// @brief Padding between this region's data and the next region's
+        /// lock
+        char pad[64];
+    };
+
+    /// @brief Register write through the shadow register cache. The caller
+    /// must hold the region's mutex.
+    /// @param region the register's region
+    /// @param regaddr the address of the target register
+    /// @param val the 32-bit value to write
+    void _cachedWriteLocked(RegRegionState & region, uint32_t regaddr,
+                            uint32_t val) const;
+
+    /// @brief Register read through the shadow register cache. The caller
+    /// must hold the region's mutex.
+    /// @param region the register's region
+    /// @param regaddr the address of the source register
+    /// @return the 32-bit register value
+    uint32_t _cachedReadLocked(RegRegionState & region, uint32_t regaddr) const;
+
+    /// @brief Write all dirty shadow registers of a region to the board. The
+    /// caller must hold the region's mutex.
+    /// @param region the region to flush
+    void _flushRegRegion(RegRegionState & region) const;
+
+    /// @brief Lock all register regions, in order
+    void _lockAllRegRegions() const;
+
+    /// @brief Unlock all register regions
+    void _unlockAllRegRegions() const;
+
+    /// @brief Per-region register state
+    mutable RegRegionState _regRegions[REG_REGION_COUNT];
+
+    /// @brief Starting register address of each region
+    uint32_t _regRegionStart[REG_REGION_COUNT];
+
+    /// @brief Lock for Navigator BSP startup/finish and board enumeration
+    static boost::mutex _BspMutex;
+
+    /// @brief Number of users of the Navigator BSP: objects being
+    /// constructed or alive, plus any Pentek_xx821Manager instances. The BSP
+    /// is started when this goes from 0 to 1 and closed when it returns to
+    /// 0. Protected by _BspMutex.
+    static uint32_t _BspUsers;
+
+    /// @brief Cached result of NAV_BoardFind(), valid while the BSP is open.
+    /// Protected by _BspMutex.
+    static NAV_DEVICE_INFO * _BoardList[NAV_MAX_BOARDS];
+
+    /// @brief Number of entries in _BoardList, or -1 if the boards have not
+    /// been enumerated since the BSP was started. Protected by _BspMutex.
+    static int32_t _NumBoards;
 
 
 };
@@ -0,0 +1,290 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821BufferPool.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821BufferPool.h"
+
+LOGGING("Pentek_xx821BufferPool")
+
+const size_t Pentek_xx821BufferPool::ARENA_BYTES;
+const size_t Pentek_xx821BufferPool::BLOCK_ALIGNMENT;
+const uint32_t Pentek_xx821BufferPool::NO_BLOCK;
+
+// mbind() policy value from <linux/mempolicy.h>. We call the system call
+// directly rather than adding a dependency on libnuma.
+static const int MPOL_PREFERRED_ = 1;
+
+Pentek_xx821BufferPool::Pentek_xx821BufferPool(size_t blockBytes,
+                                               uint32_t nBlocks,
+                                               int numaNode,
+                                               MapFunction mapFunc,
+                                               UnmapFunction unmapFunc) :
+    _blockBytes((std::max<size_t>(blockBytes, 1) + BLOCK_ALIGNMENT - 1) &
+                ~(BLOCK_ALIGNMENT - 1)),
+    _nBlocks(nBlocks),
+    _blocksPerArena(0),
+    _numaNode(numaNode),
+    _hugePages(true),
+    _unmapFunc(unmapFunc),
+    _arenas(),
+    _next(new std::atomic<uint32_t>[nBlocks]),
+    _head(NO_BLOCK),
+    _freeCount(0)
+{
+    if (_nBlocks == 0 || _nBlocks == NO_BLOCK) {
+        std::ostringstream os;
+        os << "Bad buffer pool block count " << nBlocks;
+        throw ConstructError(os.str());
+    }
+
+    // A block must lie within one arena, and so within one hugepage, for
+    // its bus address to be contiguous
+    if (_blockBytes > ARENA_BYTES) {
+        std::ostringstream os;
+        os << "Buffer pool block size " << blockBytes <<
+              " is larger than the " << ARENA_BYTES << "-byte maximum";
+        throw ConstructError(os.str());
+    }
+
+    // Each arena is one 2 MB page, holding one or more blocks
+    _blocksPerArena = ARENA_BYTES / _blockBytes;
+    uint32_t nArenas = (_nBlocks + _blocksPerArena - 1) / _blocksPerArena;
+
+    for (uint32_t a = 0; a < nArenas; a++) {
+        Arena arena;
+        arena.base = _allocArena(bool(mapFunc));
+        arena.busAddr = 0;
+        arena.mapped = false;
+        if (! arena.base) {
+            int err = errno;
+            _freeArenas();
+            std::ostringstream os;
+            if (mapFunc) {
+                os << "Failed to allocate a 2 MB hugepage for a DMA " <<
+                      "buffer pool arena (are hugepages reserved in " <<
+                      "/proc/sys/vm/nr_hugepages?): " << strerror(err);
+            } else {
+                os << "Failed to allocate " << ARENA_BYTES <<
+                      "-byte buffer pool arena: " << strerror(err);
+            }
+            throw ConstructError(os.str());
+        }
+        if (mapFunc) {
+            if (! mapFunc(arena.base, ARENA_BYTES, arena.busAddr)) {
+                munmap(arena.base, ARENA_BYTES);
+                _freeArenas();
+                throw ConstructError("Failed to map buffer pool arena for DMA");
+            }
+            arena.mapped = true;
+        }
+        _arenas.push_back(arena);
+    }
+
+    // Keep the arenas sorted by address so that blocks can be located with
+    // a binary search
+    std::sort(_arenas.begin(), _arenas.end(),
+              [](const Arena & a, const Arena & b) { return(a.base < b.base); });
+
+    // Chain all of the blocks into the free list
+    for (uint32_t b = 0; b < _nBlocks; b++) {
+        _next[b] = (b + 1 < _nBlocks) ? b + 1 : NO_BLOCK;
+    }
+    _head = 0;
+    _freeCount = _nBlocks;
+
+    ILOG << "Buffer pool: " << _nBlocks << " x " << _blockBytes << " bytes in " <<
+            nArenas << " arena(s), NUMA node " << _numaNode <<
+            (_hugePages ? ", hugepages" : ", no hugepages");
+}
+
+Pentek_xx821BufferPool::~Pentek_xx821BufferPool() {
+    if (_freeCount != _nBlocks) {
+        WLOG << "Buffer pool destroyed with " << (_nBlocks - _freeCount) <<
+                " block(s) still in use";
+    }
+    _freeArenas();
+}
+
+uint8_t *
+Pentek_xx821BufferPool::_allocArena(bool hugePagesOnly) {
+    const size_t bytes = ARENA_BYTES;
+    void * mem = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // Ask for 2 MB pages explicitly, in case the default hugepage size is
+    // something else
+    int hugeFlags = MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    hugeFlags |= 21 << MAP_HUGE_SHIFT;
+#endif
+    mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | hugeFlags, -1, 0);
+#else
+    errno = ENOTSUP;
+#endif
+    if (mem == MAP_FAILED) {
+        // Ordinary pages are not physically contiguous, so they are no use
+        // when the arena will get a single bus address
+        if (hugePagesOnly) {
+            return(NULL);
+        }
+        // No hugepages reserved (or not supported): use ordinary pages,
+        // asking for transparent hugepages where the kernel allows it.
+        if (_hugePages) {
+            WLOG << "Hugepages unavailable for buffer pool, using ordinary pages";
+            _hugePages = false;
+        }
+        mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            return(NULL);
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(mem, bytes, MADV_HUGEPAGE);
+#endif
+    }
+
+    // Bind to the NUMA node before the pages are first touched
+    if (_numaNode >= 0) {
+        unsigned long nodeMask[4] = { 0, 0, 0, 0 };
+        const int bitsPerLong = 8 * sizeof(unsigned long);
+        if (_numaNode < 4 * bitsPerLong) {
+            nodeMask[_numaNode / bitsPerLong] = 1UL << (_numaNode % bitsPerLong);
+            if (syscall(SYS_mbind, mem, bytes, MPOL_PREFERRED_, nodeMask,
+                        4 * bitsPerLong, 0) != 0) {
+                WLOG << "Cannot bind buffer pool to NUMA node " << _numaNode <<
+                        ": " << strerror(errno);
+            }
+        }
+    }
+
+    // Lock the arena into RAM; this also faults it in on the chosen node.
+    // Failure (e.g., because of RLIMIT_MEMLOCK) is not fatal, but pages
+    // could then be moved while the board is using them.
+    if (mlock(mem, bytes) != 0) {
+        WLOG << "Cannot lock buffer pool arena in memory: " << strerror(errno);
+        memset(mem, 0, bytes);
+    }
+    return(static_cast<uint8_t *>(mem));
+}
+
+void
+Pentek_xx821BufferPool::_freeArenas() {
+    for (size_t a = 0; a < _arenas.size(); a++) {
+        if (_arenas[a].mapped && _unmapFunc) {
+            _unmapFunc(_arenas[a].base);
+        }
+        munmap(_arenas[a].base, ARENA_BYTES);
+    }
+    _arenas.clear();
+}
+
+void *
+Pentek_xx821BufferPool::allocate() {
+    uint64_t head = _head.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t block = uint32_t(head);
+        if (block == NO_BLOCK) {
+            return(NULL);
+        }
+        // Pop the block, bumping the tag so that a concurrent pop/push of the
+        // same block between our load and the exchange is detected.
+        uint64_t newHead = ((head >> 32) + 1) << 32 |
+                           _next[block].load(std::memory_order_relaxed);
+        if (_head.compare_exchange_weak(head, newHead,
+                                        std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+            _freeCount.fetch_sub(1, std::memory_order_relaxed);
+            const Arena & arena = _arenas[block / _blocksPerArena];
+            return(arena.base + (block % _blocksPerArena) * _blockBytes);
+        }
+    }
+}
+
+void
+Pentek_xx821BufferPool::release(void * ptr) {
+    uint8_t * p = static_cast<uint8_t *>(ptr);
+
+    // Find the arena holding the block
+    std::vector<Arena>::const_iterator it =
+            std::upper_bound(_arenas.begin(), _arenas.end(), p,
+                             [](const uint8_t * q, const Arena & a) {
+                                 return(q < a.base);
+                             });
+    if (it == _arenas.begin() || p >= (it - 1)->base + ARENA_BYTES) {
+        ELOG << "Buffer pool release() of a pointer not from the pool";
+        return;
+    }
+    --it;
+    uint32_t block = uint32_t(it - _arenas.begin()) * _blocksPerArena +
+                     uint32_t((p - it->base) / _blockBytes);
+
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    do {
+        _next[block].store(uint32_t(head), std::memory_order_relaxed);
+    } while (! _head.compare_exchange_weak(head,
+                                           ((head >> 32) + 1) << 32 | block,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+    _freeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t
+Pentek_xx821BufferPool::busAddress(const void * ptr) const {
+    const uint8_t * p = static_cast<const uint8_t *>(ptr);
+    std::vector<Arena>::const_iterator it =
+            std::upper_bound(_arenas.begin(), _arenas.end(), p,
+                             [](const uint8_t * q, const Arena & a) {
+                                 return(q < a.base);
+                             });
+    if (it == _arenas.begin() || p >= (it - 1)->base + ARENA_BYTES) {
+        return(0);
+    }
+    --it;
+    return(it->busAddr + (p - it->base));
+}
+
+int
+Pentek_xx821BufferPool::NumaNodeOfPciDevice(const std::string & pciAddr) {
+    std::ifstream ifs(("/sys/bus/pci/devices/" + pciAddr + "/numa_node").c_str());
+    int node = -1;
+    if (! (ifs >> node)) {
+        return(-1);
+    }
+    return(node);
+}
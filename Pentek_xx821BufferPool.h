@@ -0,0 +1,193 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821BufferPool.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821BUFFERPOOL_H_
+#define PENTEK_XX821BUFFERPOOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// @brief Pool of fixed-size sample buffers placed on a chosen NUMA node
+///
+/// Memory is obtained in 2 MB arenas, each one hugepage when hugepages are
+/// available, bound to the requested NUMA node, and locked into RAM. The
+/// arenas are carved into cache-line-aligned blocks of a fixed size, no
+/// larger than an arena, which are handed out and returned through a
+/// lock-free free list.
+///
+/// If a map function is given, it is called for each arena to make it
+/// available for DMA and to get its bus address. A hugepage is physically
+/// contiguous, so a block's bus address is then the arena's bus address
+/// plus the block's offset within it. That does not hold for ordinary
+/// pages, so a pool with a map function requires hugepages. Without one,
+/// the pool falls back to ordinary pages (with transparent hugepages where
+/// the kernel allows them) when no hugepages are reserved.
+class Pentek_xx821BufferPool {
+public:
+    /// @brief Size of one arena (and of one hugepage), and the largest
+    /// block size
+    static const size_t ARENA_BYTES = 2 * 1024 * 1024;
+
+    /// @brief Alignment of each block
+    static const size_t BLOCK_ALIGNMENT = 64;
+
+    /// @brief Function to make an arena available for DMA: given the arena
+    /// address and size, it sets the arena's bus address and returns true on
+    /// success.
+    typedef std::function<bool(void *, size_t, uint64_t &)> MapFunction;
+
+    /// @brief Function to undo a MapFunction call for an arena
+    typedef std::function<void(void *)> UnmapFunction;
+
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief Constructor
+    /// @param blockBytes the minimum size of each block, in bytes; it is
+    /// rounded up to a multiple of BLOCK_ALIGNMENT, and may not exceed
+    /// ARENA_BYTES
+    /// @param nBlocks the number of blocks in the pool
+    /// @param numaNode the NUMA node on which to place the memory, or -1 to
+    /// leave placement to the kernel
+    /// @param mapFunc function to make each arena available for DMA, if any
+    /// @param unmapFunc function to undo mapFunc, if any
+    /// @throws ConstructError if the block size is too large, or the memory
+    /// cannot be obtained or mapped (including when a map function is given
+    /// and no hugepages are available)
+    Pentek_xx821BufferPool(size_t blockBytes, uint32_t nBlocks,
+                           int numaNode = -1,
+                           MapFunction mapFunc = MapFunction(),
+                           UnmapFunction unmapFunc = UnmapFunction());
+
+    /// @brief Destructor. All blocks must have been released.
+    virtual ~Pentek_xx821BufferPool();
+
+    /// @brief Take a block from the pool. This is lock-free.
+    /// @return a pointer to the block, or NULL if the pool is empty
+    void * allocate();
+
+    /// @brief Return a block to the pool. This is lock-free.
+    /// @param block a pointer returned by allocate()
+    void release(void * block);
+
+    /// @brief Return the bus address of a block, or zero if the pool has no
+    /// map function or the block is not from the pool
+    /// @param block a pointer returned by allocate()
+    /// @return the bus address of the block
+    uint64_t busAddress(const void * block) const;
+
+    /// @brief Return the size of each block, in bytes
+    /// @return the size of each block, in bytes
+    size_t blockBytes() const { return(_blockBytes); }
+
+    /// @brief Return the number of blocks in the pool
+    /// @return the number of blocks in the pool
+    uint32_t blockCount() const { return(_nBlocks); }
+
+    /// @brief Return the number of blocks currently free
+    /// @return the number of blocks currently free
+    uint32_t freeCount() const { return(_freeCount); }
+
+    /// @brief Return the NUMA node the memory was bound to, or -1 if none
+    /// @return the NUMA node the memory was bound to, or -1 if none
+    int numaNode() const { return(_numaNode); }
+
+    /// @brief Return true iff the arenas are backed by explicit hugepages
+    /// @return true iff the arenas are backed by explicit hugepages
+    bool hugePages() const { return(_hugePages); }
+
+    /// @brief Return the NUMA node of a PCI device, as reported by sysfs
+    /// @param pciAddr the PCI address of the device, in the form
+    /// "dddd:bb:ss.f"
+    /// @return the device's NUMA node, or -1 if it is unknown
+    static int NumaNodeOfPciDevice(const std::string & pciAddr);
+
+private:
+    /// @brief One arena of the pool: a single hugepage when the pool has a
+    /// map function
+    struct Arena {
+        uint8_t * base;
+        uint64_t busAddr;
+        bool mapped;
+    };
+
+    /// @brief Allocate, place and lock one arena
+    /// @param hugePagesOnly if true, fail rather than fall back to ordinary
+    /// pages when no hugepage is available
+    /// @return the arena, or NULL if it could not be allocated
+    uint8_t * _allocArena(bool hugePagesOnly);
+
+    /// @brief Free the arenas
+    void _freeArenas();
+
+    /// @brief Marker for the end of the free list
+    static const uint32_t NO_BLOCK = 0xffffffff;
+
+    /// @brief Size of each block, in bytes
+    size_t _blockBytes;
+
+    /// @brief Number of blocks
+    uint32_t _nBlocks;
+
+    /// @brief Number of blocks in each arena
+    uint32_t _blocksPerArena;
+
+    /// @brief NUMA node the memory was bound to, or -1
+    int _numaNode;
+
+    /// @brief Are the arenas backed by explicit hugepages?
+    bool _hugePages;
+
+    /// @brief Function to undo the DMA mapping of an arena
+    UnmapFunction _unmapFunc;
+
+    /// @brief The arenas
+    std::vector<Arena> _arenas;
+
+    /// @brief Free list links, indexed by block number
+    std::unique_ptr<std::atomic<uint32_t>[]> _next;
+
+    /// @brief Head of the free list: block number in the low 32 bits and a
+    /// modification tag in the high 32 bits, to avoid ABA problems
+    std::atomic<uint64_t> _head;
+
+    /// @brief Number of free blocks
+    std::atomic<uint32_t> _freeCount;
+};
+
+#endif /* PENTEK_XX821BUFFERPOOL_H_ */
@@ -0,0 +1,66 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CaptureFile.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstring>
+
+#include "Pentek_xx821CaptureFile.h"
+
+const uint32_t Pentek_xx821CaptureFile::MAX_CHANNELS;
+const uint32_t Pentek_xx821CaptureFile::PAGE_BYTES;
+const uint32_t Pentek_xx821CaptureFile::VERSION;
+const char Pentek_xx821CaptureFile::MAGIC[8] = {
+    'P', 'X', 'X', '8', '2', '1', 'C', 'P'
+};
+
+static_assert(sizeof(Pentek_xx821CaptureFile::Header) <=
+              Pentek_xx821CaptureFile::PAGE_BYTES,
+              "Pentek_xx821CaptureFile::Header must fit in one page");
+static_assert(sizeof(Pentek_xx821CaptureFile::IndexEntry) == 32,
+              "Pentek_xx821CaptureFile::IndexEntry must be 32 bytes");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+              "std::atomic<uint64_t> must have the size of uint64_t");
+
+uint64_t
+Pentek_xx821CaptureFile::Layout(Header & header, uint32_t nChannels,
+                                uint64_t slotBytes, uint64_t nSlots) {
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.nChannels = nChannels;
+    header.slotBytes = _RoundUp(slotBytes);
+    header.nSlots = nSlots;
+    header.indexOffset = PAGE_BYTES;
+    header.dataOffset = IndexRegionOffset(header, nChannels);
+    header.complete = 0;
+    for (uint32_t c = 0; c < MAX_CHANNELS; c++) {
+        header.chanIds[c] = 0;
+        header.blockCount[c] = 0;
+    }
+    return(header.dataOffset + header.nSlots * header.slotBytes);
+}
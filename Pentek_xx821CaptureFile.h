@@ -0,0 +1,135 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CaptureFile.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821CAPTUREFILE_H_
+#define PENTEK_XX821CAPTUREFILE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Layout of a raw capture file, as written by
+/// Pentek_xx821CaptureWriter and read by Pentek_xx821CaptureReader
+///
+/// A capture file is preallocated at its full size when it is created:
+/// - a Header, at offset 0
+/// - one index region per channel, each with room for nSlots IndexEntry
+///   records, at indexOffset
+/// - nSlots data slots of slotBytes each, at dataOffset
+///
+/// Blocks from all channels share the data slots, in arrival order. Each
+/// channel's index lists its blocks in arrival order, which is timetag
+/// order, so a reader can binary search it. The index for a block is
+/// written after the block's data, and the channel's block count in the
+/// header is updated last, so a reader of a file still being written only
+/// sees complete blocks. All offsets and sizes are multiples of PAGE_BYTES,
+/// so that data can be written with O_DIRECT and mapped by readers.
+class Pentek_xx821CaptureFile {
+public:
+    /// @brief Largest number of channels in one file
+    static const uint32_t MAX_CHANNELS = 32;
+
+    /// @brief Alignment of the index, data area and data slots
+    static const uint32_t PAGE_BYTES = 4096;
+
+    /// @brief Current file format version
+    static const uint32_t VERSION = 1;
+
+    /// @brief Magic number at the start of the header, "PXX821CP"
+    static const char MAGIC[8];
+
+    /// @brief File header
+    struct Header {
+        /// @brief MAGIC
+        char magic[8];
+        /// @brief VERSION
+        uint32_t version;
+        /// @brief Number of channels
+        uint32_t nChannels;
+        /// @brief Size of each data slot, bytes
+        uint64_t slotBytes;
+        /// @brief Number of data slots
+        uint64_t nSlots;
+        /// @brief File offset of channel 0's index region
+        uint64_t indexOffset;
+        /// @brief File offset of the first data slot
+        uint64_t dataOffset;
+        /// @brief Nonzero once the writer has closed the file cleanly
+        std::atomic<uint32_t> complete;
+        /// @brief Caller-defined ID of each channel, e.g.,
+        /// 256 * board + DDC channel
+        uint32_t chanIds[MAX_CHANNELS];
+        /// @brief Number of blocks written for each channel
+        std::atomic<uint64_t> blockCount[MAX_CHANNELS];
+    };
+
+    /// @brief Index record for one block
+    struct IndexEntry {
+        /// @brief Board timetag of the first sample in the block
+        uint64_t timetag;
+        /// @brief File offset of the block's data
+        uint64_t dataOffset;
+        /// @brief Length of the block's data, bytes
+        uint32_t bytes;
+        /// @brief Board sequence number of the block
+        uint32_t sequence;
+        /// @brief Caller-defined ID of the block's channel
+        uint32_t chanId;
+        uint32_t reserved;
+    };
+
+    /// @brief Return the file offset of a channel's index region
+    /// @param header the file header
+    /// @param chan the channel's index in the file
+    /// @return the file offset of the channel's index region
+    static uint64_t IndexRegionOffset(const Header & header, uint32_t chan) {
+        return(header.indexOffset +
+               chan * _RoundUp(header.nSlots * sizeof(IndexEntry)));
+    }
+
+    /// @brief Fill in a header and return the total file size for the
+    /// given layout
+    /// @param[out] header the header to fill in
+    /// @param nChannels the number of channels
+    /// @param slotBytes the largest block size, bytes; rounded up to a
+    /// multiple of PAGE_BYTES
+    /// @param nSlots the number of data slots
+    /// @return the total file size, bytes
+    static uint64_t Layout(Header & header, uint32_t nChannels,
+                           uint64_t slotBytes, uint64_t nSlots);
+
+private:
+    /// @brief Round up to a multiple of PAGE_BYTES
+    static uint64_t _RoundUp(uint64_t bytes) {
+        return((bytes + PAGE_BYTES - 1) / PAGE_BYTES * PAGE_BYTES);
+    }
+};
+
+#endif /* PENTEK_XX821CAPTUREFILE_H_ */
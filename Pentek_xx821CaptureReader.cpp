@@ -0,0 +1,131 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CaptureReader.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Pentek_xx821CaptureReader.h"
+
+typedef Pentek_xx821CaptureFile CaptureFile;
+
+Pentek_xx821CaptureReader::Pentek_xx821CaptureReader(const std::string & path) :
+    _path(path),
+    _map(MAP_FAILED),
+    _mapBytes(0),
+    _header(NULL)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0) {
+        _mapBytes = st.st_size;
+        _map = mmap(NULL, _mapBytes, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    int err = errno;
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (_map == MAP_FAILED) {
+        std::ostringstream os;
+        os << "Cannot map capture file " << path << ": " << strerror(err);
+        throw OpenError(os.str());
+    }
+
+    // Make sure the layout described by the header fits in the file
+    _header = static_cast<const CaptureFile::Header *>(_map);
+    bool valid = _mapBytes >= sizeof(CaptureFile::Header) &&
+            memcmp(_header->magic, CaptureFile::MAGIC,
+                   sizeof(_header->magic)) == 0 &&
+            _header->version == CaptureFile::VERSION &&
+            _header->nChannels <= CaptureFile::MAX_CHANNELS &&
+            _header->slotBytes != 0 &&
+            _header->nSlots <= _mapBytes / _header->slotBytes &&
+            _header->dataOffset ==
+                CaptureFile::IndexRegionOffset(*_header, _header->nChannels) &&
+            _header->dataOffset + _header->nSlots * _header->slotBytes <=
+                _mapBytes;
+    if (! valid) {
+        munmap(const_cast<void *>(_map), _mapBytes);
+        std::ostringstream os;
+        os << path << " is not a version " << CaptureFile::VERSION <<
+              " Pentek_xx821 capture file";
+        throw OpenError(os.str());
+    }
+}
+
+Pentek_xx821CaptureReader::~Pentek_xx821CaptureReader() {
+    munmap(const_cast<void *>(_map), _mapBytes);
+}
+
+void
+Pentek_xx821CaptureReader::_checkChan(uint32_t chan) const {
+    if (chan >= _header->nChannels) {
+        std::ostringstream os;
+        os << "Channel " << chan << " is not in capture file " << _path <<
+              ", which has " << _header->nChannels << " channel(s)";
+        throw std::out_of_range(os.str());
+    }
+}
+
+const Pentek_xx821CaptureReader::IndexEntry &
+Pentek_xx821CaptureReader::entry(uint32_t chan, uint64_t block) const {
+    uint64_t nBlocks = blockCount(chan);
+    if (block >= nBlocks) {
+        std::ostringstream os;
+        os << "Block " << block << " of channel " << chan <<
+              " is not in capture file " << _path << ", which has " <<
+              nBlocks << " block(s) for the channel";
+        throw std::out_of_range(os.str());
+    }
+    const IndexEntry * index = reinterpret_cast<const IndexEntry *>(
+            static_cast<const char *>(_map) +
+            CaptureFile::IndexRegionOffset(*_header, chan));
+    return(index[block]);
+}
+
+uint64_t
+Pentek_xx821CaptureReader::findBlock(uint32_t chan, uint64_t timetag) const {
+    uint64_t nBlocks = blockCount(chan);
+    if (nBlocks == 0) {
+        return(0);
+    }
+    const IndexEntry * first = reinterpret_cast<const IndexEntry *>(
+            static_cast<const char *>(_map) +
+            CaptureFile::IndexRegionOffset(*_header, chan));
+    const IndexEntry * after = std::upper_bound(
+            first, first + nBlocks, timetag,
+            [](uint64_t t, const IndexEntry & e) { return(t < e.timetag); });
+    return(after == first ? nBlocks : (after - first) - 1);
+}
@@ -0,0 +1,143 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CaptureReader.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821CAPTUREREADER_H_
+#define PENTEK_XX821CAPTUREREADER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "Pentek_xx821CaptureFile.h"
+
+/// @brief Class which reads a capture file written by
+/// Pentek_xx821CaptureWriter
+///
+/// The whole file is mapped read-only, so block data is accessed in place
+/// without copying. Blocks are found by timetag with a binary search of
+/// the channel's index. A file still being written may be read; only
+/// blocks completely written when blockCount() is called are visible.
+///
+/// The per-channel counts in the header are not trusted: a count larger
+/// than the file's slot count is clamped to it, and channel or block
+/// numbers out of range throw std::out_of_range, so a damaged file cannot
+/// send a lookup outside the mapping.
+class Pentek_xx821CaptureReader {
+public:
+    class OpenError : public virtual std::runtime_error {
+    public:
+        OpenError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    typedef Pentek_xx821CaptureFile::IndexEntry IndexEntry;
+
+    /// @brief Open and map a capture file
+    /// @param path the file path
+    /// @throws OpenError if the file cannot be mapped or is not a capture
+    /// file
+    Pentek_xx821CaptureReader(const std::string & path);
+
+    /// @brief Destructor. Unmaps the file.
+    virtual ~Pentek_xx821CaptureReader();
+
+    /// @brief Return the number of channels in the file
+    /// @return the number of channels in the file
+    uint32_t channelCount() const { return(_header->nChannels); }
+
+    /// @brief Return a channel's caller-defined ID
+    /// @param chan the channel's index in the file
+    /// @return the channel's ID
+    /// @throws std::out_of_range if chan is not a channel in the file
+    uint32_t chanId(uint32_t chan) const {
+        _checkChan(chan);
+        return(_header->chanIds[chan]);
+    }
+
+    /// @brief Return the number of blocks recorded for a channel
+    /// @param chan the channel's index in the file
+    /// @return the number of blocks recorded for the channel, at most the
+    /// number of slots in the file
+    /// @throws std::out_of_range if chan is not a channel in the file
+    uint64_t blockCount(uint32_t chan) const {
+        _checkChan(chan);
+        return(std::min(
+                _header->blockCount[chan].load(std::memory_order_acquire),
+                _header->nSlots));
+    }
+
+    /// @brief Return true iff the writer closed the file cleanly
+    /// @return true iff the writer closed the file cleanly
+    bool complete() const { return(_header->complete != 0); }
+
+    /// @brief Return the index entry for one of a channel's blocks
+    /// @param chan the channel's index in the file
+    /// @param block the block number, 0 to blockCount(chan) - 1
+    /// @return the block's index entry
+    /// @throws std::out_of_range if chan is not a channel in the file or
+    /// block is not one of its blocks
+    const IndexEntry & entry(uint32_t chan, uint64_t block) const;
+
+    /// @brief Find the block of a channel containing a timetag: the last
+    /// block whose timetag is not later than the given one
+    /// @param chan the channel's index in the file
+    /// @param timetag the timetag
+    /// @return the block number, or blockCount(chan) if every block is
+    /// later than the timetag
+    /// @throws std::out_of_range if chan is not a channel in the file
+    uint64_t findBlock(uint32_t chan, uint64_t timetag) const;
+
+    /// @brief Return a block's data, in place in the mapped file
+    /// @param entry the block's index entry
+    /// @return the block's data
+    const void * blockData(const IndexEntry & entry) const {
+        return(static_cast<const char *>(_map) + entry.dataOffset);
+    }
+
+private:
+    /// @brief Throw std::out_of_range if a channel index is not a channel in
+    /// the file
+    /// @param chan the channel index
+    void _checkChan(uint32_t chan) const;
+
+    /// @brief File path
+    std::string _path;
+
+    /// @brief Mapping of the whole file
+    const void * _map;
+
+    /// @brief Length of _map, bytes
+    size_t _mapBytes;
+
+    /// @brief The header, in _map
+    const Pentek_xx821CaptureFile::Header * _header;
+};
+
+#endif /* PENTEK_XX821CAPTUREREADER_H_ */
@@ -0,0 +1,225 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CaptureWriter.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+
+#include "Pentek_xx821CaptureWriter.h"
+
+LOGGING("Pentek_xx821CaptureWriter")
+
+typedef Pentek_xx821CaptureFile CaptureFile;
+
+Pentek_xx821CaptureWriter::Pentek_xx821CaptureWriter(
+        const std::string & path, const std::vector<uint32_t> & chanIds,
+        uint32_t slotBytes, uint64_t capacityBytes) :
+    _path(path),
+    _fd(-1),
+    _directFd(-1),
+    _map(MAP_FAILED),
+    _mapBytes(0),
+    _header(NULL),
+    _index(),
+    _nextSlot(0),
+    _droppedCount(0),
+    _bytesWritten(0),
+    _closed(false)
+{
+    if (chanIds.empty() || chanIds.size() > CaptureFile::MAX_CHANNELS ||
+            slotBytes == 0) {
+        std::ostringstream os;
+        os << "Cannot create capture file " << path << " for " <<
+              chanIds.size() << " channels with " << slotBytes <<
+              "-byte blocks";
+        throw OpenError(os.str());
+    }
+
+    CaptureFile::Header layout;
+    const uint64_t page = CaptureFile::PAGE_BYTES;
+    uint64_t roundedSlotBytes = (slotBytes + page - 1) / page * page;
+    uint64_t fileBytes = CaptureFile::Layout(layout, chanIds.size(),
+                                             slotBytes,
+                                             capacityBytes / roundedSlotBytes);
+    if (layout.nSlots == 0) {
+        std::ostringstream os;
+        os << "Capacity of " << capacityBytes << " bytes for capture file " <<
+              path << " is less than one " << layout.slotBytes << "-byte slot";
+        throw OpenError(os.str());
+    }
+
+    // Create and preallocate the file, so that recording never waits for
+    // the filesystem to allocate blocks
+    _fd = open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (_fd < 0) {
+        std::ostringstream os;
+        os << "Cannot create capture file " << path << ": " << strerror(errno);
+        throw OpenError(os.str());
+    }
+    int err = posix_fallocate(_fd, 0, fileBytes);
+    if (err == 0) {
+        _mapBytes = layout.dataOffset;
+        _map = mmap(NULL, _mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    _fd, 0);
+        err = (_map == MAP_FAILED) ? errno : 0;
+    }
+    if (err != 0) {
+        ::close(_fd);
+        unlink(path.c_str());
+        std::ostringstream os;
+        os << "Cannot allocate " << fileBytes << "-byte capture file " <<
+              path << ": " << strerror(err);
+        throw OpenError(os.str());
+    }
+
+    _header = static_cast<CaptureFile::Header *>(_map);
+    memcpy(static_cast<void *>(_header), &layout, sizeof(layout));
+    for (uint32_t c = 0; c < chanIds.size(); c++) {
+        _header->chanIds[c] = chanIds[c];
+        _index.push_back(reinterpret_cast<CaptureFile::IndexEntry *>(
+                static_cast<char *>(_map) +
+                CaptureFile::IndexRegionOffset(*_header, c)));
+    }
+
+    // O_DIRECT isn't supported on every filesystem (e.g., tmpfs); fall back
+    // to buffered writes there
+    _directFd = open(path.c_str(), O_WRONLY | O_DIRECT);
+    if (_directFd < 0) {
+        WLOG << "Capture file " << path << " will be written through the " <<
+                "page cache: O_DIRECT open failed: " << strerror(errno);
+    }
+
+    ILOG << "Created capture file " << path << ": " << chanIds.size() <<
+            " channel(s), " << _header->nSlots << " x " <<
+            _header->slotBytes << "-byte slots, " << fileBytes << " bytes";
+}
+
+Pentek_xx821CaptureWriter::~Pentek_xx821CaptureWriter() {
+    close();
+    munmap(_map, _mapBytes);
+}
+
+uint64_t
+Pentek_xx821CaptureWriter::blockCount(uint32_t chan) const {
+    return(_header->blockCount[chan].load());
+}
+
+bool
+Pentek_xx821CaptureWriter::_writeData(const void * data, uint32_t bytes,
+                                      uint64_t offset) {
+    // Write straight from the caller's buffer with O_DIRECT when its
+    // address and length allow it
+    bool direct = _directFd >= 0 &&
+                  uintptr_t(data) % CaptureFile::PAGE_BYTES == 0 &&
+                  bytes % CaptureFile::PAGE_BYTES == 0;
+    int fd = direct ? _directFd : _fd;
+    const char * src = static_cast<const char *>(data);
+    while (bytes > 0) {
+        ssize_t n = pwrite(fd, src, bytes, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DEFERRABLE_ELOG("Write to capture file " << _path << " failed: " <<
+                            strerror(errno));
+            return(false);
+        }
+        src += n;
+        bytes -= n;
+        offset += n;
+    }
+    return(true);
+}
+
+bool
+Pentek_xx821CaptureWriter::append(uint32_t chan, const void * data,
+                                  uint32_t bytes, uint64_t timetag,
+                                  uint32_t sequence) {
+    if (_closed || chan >= _index.size() || bytes > _header->slotBytes) {
+        _droppedCount++;
+        return(false);
+    }
+    uint64_t slot = _nextSlot++;
+    if (slot >= _header->nSlots) {
+        if (slot == _header->nSlots) {
+            DEFERRABLE_WLOG("Capture file " << _path << " is full");
+        }
+        _droppedCount++;
+        return(false);
+    }
+
+    uint64_t offset = _header->dataOffset + slot * _header->slotBytes;
+    if (! _writeData(data, bytes, offset)) {
+        _droppedCount++;
+        return(false);
+    }
+
+    // Publish the block: index entry first, then the channel's count
+    uint64_t n = _header->blockCount[chan].load(std::memory_order_relaxed);
+    CaptureFile::IndexEntry & entry = _index[chan][n];
+    entry.timetag = timetag;
+    entry.dataOffset = offset;
+    entry.bytes = bytes;
+    entry.sequence = sequence;
+    entry.chanId = _header->chanIds[chan];
+    entry.reserved = 0;
+    _header->blockCount[chan].store(n + 1, std::memory_order_release);
+    _bytesWritten += bytes;
+    return(true);
+}
+
+void
+Pentek_xx821CaptureWriter::close() {
+    if (_closed.exchange(true)) {
+        return;
+    }
+    _header->complete = 1;
+    if (msync(_map, _mapBytes, MS_SYNC) != 0 || fdatasync(_fd) != 0) {
+        ELOG << "Failed to flush capture file " << _path << ": " <<
+                strerror(errno);
+    }
+    uint64_t nBlocks = 0;
+    for (uint32_t c = 0; c < _index.size(); c++) {
+        nBlocks += _header->blockCount[c];
+    }
+    ILOG << "Closed capture file " << _path << ": " << nBlocks <<
+            " blocks recorded, " << _droppedCount << " dropped";
+
+    if (_directFd >= 0) {
+        ::close(_directFd);
+    }
+    ::close(_fd);
+}
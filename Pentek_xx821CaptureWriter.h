@@ -0,0 +1,160 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CaptureWriter.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821CAPTUREWRITER_H_
+#define PENTEK_XX821CAPTUREWRITER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Pentek_xx821CaptureFile.h"
+#include "Pentek_xx821Dn.h"
+
+/// @brief Class which records raw sample blocks to a preallocated,
+/// indexed capture file (see Pentek_xx821CaptureFile)
+///
+/// Page-aligned blocks whose length is a multiple of the page size (e.g.,
+/// full blocks borrowed from a Pentek_xx821Dn receive ring) are written
+/// straight from their DMA buffers with O_DIRECT, bypassing the page cache.
+/// Other blocks are written through the page cache. The header and index
+/// are kept in a shared memory mapping of the file.
+///
+/// append() may be called concurrently for different channels, but for a
+/// given channel only from one thread at a time.
+class Pentek_xx821CaptureWriter {
+public:
+    class OpenError : public virtual std::runtime_error {
+    public:
+        OpenError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief Create a capture file, preallocating its full size
+    /// @param path the file path; an existing file is replaced
+    /// @param chanIds caller-defined ID for each channel to be recorded
+    /// @param slotBytes the largest block size, bytes
+    /// @param capacityBytes the total size of the data slots, bytes
+    /// @throws OpenError if the file cannot be created
+    Pentek_xx821CaptureWriter(const std::string & path,
+                              const std::vector<uint32_t> & chanIds,
+                              uint32_t slotBytes, uint64_t capacityBytes);
+
+    /// @brief Destructor. Closes the file.
+    virtual ~Pentek_xx821CaptureWriter();
+
+    /// @brief Record a block borrowed from a receive ring. The block may
+    /// be released as soon as this returns.
+    /// @param chan the channel's index in the constructor's list
+    /// @param block the block
+    /// @return true iff the block was recorded
+    bool append(uint32_t chan, const Pentek_xx821Dn::RxBlock & block) {
+        return(append(chan, block.data, block.bytes, block.timetag,
+                      block.sequence));
+    }
+
+    /// @brief Record a block
+    /// @param chan the channel's index in the constructor's list
+    /// @param data the block's data
+    /// @param bytes the length of the block's data, bytes
+    /// @param timetag the board timetag of the block's first sample
+    /// @param sequence the board sequence number of the block
+    /// @return true iff the block was recorded; false if the file is full,
+    /// the block is too big for a slot, or the write failed
+    bool append(uint32_t chan, const void * data, uint32_t bytes,
+                uint64_t timetag, uint32_t sequence);
+
+    /// @brief Mark the file complete, flush it to storage, and close it.
+    /// Further appends fail. Appends in progress must have finished.
+    void close();
+
+    /// @brief Return the file path
+    /// @return the file path
+    const std::string & path() const { return(_path); }
+
+    /// @brief Return true iff O_DIRECT writes are available for the file
+    /// @return true iff O_DIRECT writes are available for the file
+    bool directIo() const { return(_directFd >= 0); }
+
+    /// @brief Return the number of blocks recorded for a channel
+    /// @param chan the channel's index in the constructor's list
+    /// @return the number of blocks recorded for the channel
+    uint64_t blockCount(uint32_t chan) const;
+
+    /// @brief Return the number of blocks not recorded
+    /// @return the number of blocks not recorded
+    uint64_t droppedCount() const { return(_droppedCount); }
+
+    /// @brief Return the number of data bytes recorded
+    /// @return the number of data bytes recorded
+    uint64_t bytesWritten() const { return(_bytesWritten); }
+
+private:
+    /// @brief Write a block's data to a slot
+    /// @return true iff the write succeeded
+    bool _writeData(const void * data, uint32_t bytes, uint64_t offset);
+
+    /// @brief File path
+    std::string _path;
+
+    /// @brief File descriptor for buffered writes
+    int _fd;
+
+    /// @brief File descriptor for O_DIRECT writes, or -1
+    int _directFd;
+
+    /// @brief Mapping of the header and index regions
+    void * _map;
+
+    /// @brief Length of _map, bytes
+    size_t _mapBytes;
+
+    /// @brief The header, in _map
+    Pentek_xx821CaptureFile::Header * _header;
+
+    /// @brief Each channel's index region, in _map
+    std::vector<Pentek_xx821CaptureFile::IndexEntry *> _index;
+
+    /// @brief Next data slot to use
+    std::atomic<uint64_t> _nextSlot;
+
+    /// @brief Number of blocks not recorded
+    std::atomic<uint64_t> _droppedCount;
+
+    /// @brief Number of data bytes recorded
+    std::atomic<uint64_t> _bytesWritten;
+
+    /// @brief Set once close() has been called
+    std::atomic<bool> _closed;
+};
+
+#endif /* PENTEK_XX821CAPTUREWRITER_H_ */
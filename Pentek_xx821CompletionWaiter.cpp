@@ -0,0 +1,133 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CompletionWaiter.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <sched.h>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+
+#include "Pentek_xx821CompletionWaiter.h"
+
+LOGGING("Pentek_xx821CompletionWaiter")
+
+// In adaptive mode, spin for up to this many expected completion intervals
+static const uint64_t ADAPTIVE_SPIN_INTERVALS = 4;
+
+Pentek_xx821CompletionWaiter::Pentek_xx821CompletionWaiter(Pentek_xx821 & board,
+                                                           uint32_t dir,
+                                                           uint32_t chanId) :
+    _board(board),
+    _dir(dir),
+    _chanId(chanId),
+    _lastCompletionNs(0),
+    _intervalNs(0),
+    _pinned(false),
+    _pinnedThread(),
+    _pinnedCpu(-1)
+{
+}
+
+void
+Pentek_xx821CompletionWaiter::noteCompletion() {
+    uint64_t now = Pentek_xx821Telemetry::Now();
+    if (_lastCompletionNs != 0) {
+        // Exponentially weighted average, weight 1/8 for the newest interval
+        uint64_t interval = now - _lastCompletionNs;
+        _intervalNs = (_intervalNs == 0) ?
+                interval : _intervalNs - _intervalNs / 8 + interval / 8;
+    }
+    _lastCompletionNs = now;
+}
+
+uint64_t
+Pentek_xx821CompletionWaiter::_adaptiveSpinNs() const {
+    // Spin only while traffic is heavy, i.e., completions are coming faster
+    // than the switch-over threshold, and not past the threshold
+    uint64_t thresholdNs = _board.adaptiveThresholdNs();
+    if (_intervalNs == 0 || _intervalNs >= thresholdNs) {
+        return(0);
+    }
+    // After a lull, don't spin until traffic resumes
+    if (Pentek_xx821Telemetry::Now() - _lastCompletionNs > thresholdNs) {
+        return(0);
+    }
+    return(std::min(ADAPTIVE_SPIN_INTERVALS * _intervalNs, thresholdNs));
+}
+
+void
+Pentek_xx821CompletionWaiter::_pinIfRequested() {
+    int cpu = _board.pollCpu();
+    if (cpu < 0 || (_pinned && _pinnedCpu == cpu &&
+                    pthread_equal(_pinnedThread, pthread_self()))) {
+        return;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (err != 0) {
+        DEFERRABLE_WLOG("Cannot pin DMA polling thread to CPU " << cpu <<
+                        ": " << strerror(err));
+    } else {
+        DEFERRABLE_DLOG("DMA polling thread for channel " << _chanId <<
+                        " pinned to CPU " << cpu);
+    }
+    // Don't retry on every wait if it failed
+    _pinned = true;
+    _pinnedThread = pthread_self();
+    _pinnedCpu = cpu;
+}
+
+bool
+Pentek_xx821CompletionWaiter::_waitForInterrupt(uint32_t timeoutMs) {
+    _board._telemetry.count(Pentek_xx821Telemetry::COMPLETION_INTERRUPTS);
+    int32_t status = NAV_DmaWaitForInterrupt(_board._boardHandle,
+                                             &_board._appSysContext,
+                                             _dir, _chanId, timeoutMs);
+    if (status != NAV_STAT_OK && status != NAV_STAT_TIMEOUT) {
+        std::ostringstream os;
+        os << "NAV_DmaWaitForInterrupt for " <<
+              ((_dir == NAV_DMA_DIR_TO_HOST) ? "DDC" : "DAC") <<
+              " channel " << _chanId << " on board " << _board._boardNum;
+        Pentek_xx821::_LogNavigatorError(status, os.str());
+    }
+    return(status == NAV_STAT_OK);
+}
+
+void
+Pentek_xx821CompletionWaiter::_recordWait(uint64_t start, uint64_t end) const {
+    _board._telemetry.recordLatency((_dir == NAV_DMA_DIR_TO_HOST) ?
+                                    Pentek_xx821Telemetry::HIST_RX_WAIT :
+                                    Pentek_xx821Telemetry::HIST_TX_WAIT,
+                                    end - start);
+}
@@ -0,0 +1,172 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821CompletionWaiter.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821COMPLETIONWAITER_H_
+#define PENTEK_XX821COMPLETIONWAITER_H_
+
+#include <cstdint>
+#include <string>
+#include <pthread.h>
+
+#include "Pentek_xx821.h"
+
+/// @brief Class which waits for DMA completions on one channel, using the
+/// board's completion mode
+///
+/// - Pentek_xx821::COMPLETION_INTERRUPT: sleep in NAV_DmaWaitForInterrupt()
+///   until the board signals a completion.
+/// - Pentek_xx821::COMPLETION_POLL: spin on the completion descriptors until
+///   one completes or the timeout expires. If the board has a poll CPU set,
+///   the waiting thread is pinned to it the first time it polls.
+/// - Pentek_xx821::COMPLETION_ADAPTIVE: track the interval between
+///   completions. While completions come faster than the board's adaptive
+///   threshold, spin for up to a few intervals before falling back to an
+///   interrupt wait; when traffic is slower, go straight to the interrupt
+///   wait.
+///
+/// wait() and noteCompletion() must be called from only one thread at a
+/// time.
+class Pentek_xx821CompletionWaiter {
+public:
+    /// @brief Constructor
+    /// @param board the board
+    /// @param dir the DMA direction, NAV_DMA_DIR_TO_HOST or
+    /// NAV_DMA_DIR_FROM_HOST
+    /// @param chanId the DMA channel
+    Pentek_xx821CompletionWaiter(Pentek_xx821 & board, uint32_t dir,
+                                 uint32_t chanId);
+
+    /// @brief Wait until ready() returns true or the timeout expires
+    /// @param ready function returning true when the awaited completion has
+    /// happened
+    /// @param timeoutMs the longest time to wait, in milliseconds
+    /// @return the final result of ready()
+    template <class READY>
+    bool wait(READY ready, uint32_t timeoutMs) {
+        Pentek_xx821::CompletionMode mode = _board.completionMode();
+        uint64_t spinNs = 0;
+        if (mode == Pentek_xx821::COMPLETION_POLL) {
+            spinNs = uint64_t(timeoutMs) * 1000000;
+        } else if (mode == Pentek_xx821::COMPLETION_ADAPTIVE) {
+            spinNs = _adaptiveSpinNs();
+        }
+
+        uint64_t start = Pentek_xx821Telemetry::Now();
+        if (spinNs > 0) {
+            _pinIfRequested();
+            _board._telemetry.count(Pentek_xx821Telemetry::COMPLETION_POLLS);
+            uint64_t now = start;
+            do {
+                if (ready()) {
+                    _recordWait(start, Pentek_xx821Telemetry::Now());
+                    return(true);
+                }
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+                now = Pentek_xx821Telemetry::Now();
+            } while (now - start < spinNs);
+            if (mode == Pentek_xx821::COMPLETION_POLL) {
+                _recordWait(start, now);
+                return(ready());
+            }
+        }
+
+        // Sleep until the board signals a completion. An interrupt may
+        // belong to a completion which was already consumed, so keep
+        // waiting until the caller's condition holds or the time is up.
+        while (! ready()) {
+            uint64_t spentMs =
+                    (Pentek_xx821Telemetry::Now() - start) / 1000000;
+            if (spentMs >= timeoutMs ||
+                    ! _waitForInterrupt(timeoutMs - spentMs)) {
+                break;
+            }
+        }
+        _recordWait(start, Pentek_xx821Telemetry::Now());
+        return(ready());
+    }
+
+    /// @brief Note that a completion has been consumed, updating the
+    /// measured completion interval used in adaptive mode
+    void noteCompletion();
+
+    /// @brief Return the smoothed interval between completions, in
+    /// nanoseconds
+    /// @return the smoothed interval between completions, in nanoseconds
+    uint64_t completionIntervalNs() const { return(_intervalNs); }
+
+private:
+    /// @brief Return how long to spin in adaptive mode before falling back
+    /// to an interrupt wait
+    /// @return how long to spin, in nanoseconds, or zero to not spin
+    uint64_t _adaptiveSpinNs() const;
+
+    /// @brief Pin the calling thread to the board's poll CPU if one is set
+    /// and the thread hasn't been pinned already
+    void _pinIfRequested();
+
+    /// @brief Wait for an interrupt from the channel, logging any error
+    /// @param timeoutMs the longest time to wait, in milliseconds
+    /// @return true iff an interrupt was received
+    bool _waitForInterrupt(uint32_t timeoutMs);
+
+    /// @brief Record a wait in the channel's wait-time histogram
+    /// @param start the time the wait started, ns
+    /// @param end the time the wait ended, ns
+    void _recordWait(uint64_t start, uint64_t end) const;
+
+    /// @brief The board
+    Pentek_xx821 & _board;
+
+    /// @brief The DMA direction
+    uint32_t _dir;
+
+    /// @brief The DMA channel
+    uint32_t _chanId;
+
+    /// @brief Time of the last completion, ns, or zero if none yet
+    uint64_t _lastCompletionNs;
+
+    /// @brief Smoothed interval between completions, ns, or zero if not
+    /// yet measured
+    uint64_t _intervalNs;
+
+    /// @brief True if a thread has been pinned to the board's poll CPU
+    bool _pinned;
+
+    /// @brief The thread which was pinned, if _pinned is true
+    pthread_t _pinnedThread;
+
+    /// @brief The CPU the thread was pinned to, if _pinned is true
+    int _pinnedCpu;
+};
+
+#endif /* PENTEK_XX821COMPLETIONWAITER_H_ */
@@ -0,0 +1,383 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Decimator.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <logx/Logging.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define PENTEK_XX821_DECIMATOR_X86 1
+#endif
+
+#include "Pentek_xx821DeferredLog.h"
+
+#include "Pentek_xx821Decimator.h"
+
+LOGGING("Pentek_xx821Decimator")
+
+/// @brief Number of new samples converted into a channel's work buffer at a
+/// time; longer inputs are filtered in pieces of this size
+static const size_t WORK_PAIRS = 4096;
+
+/// @brief Compute the filter outputs whose newest input sample is at index
+/// first, first + step, ... (up to end) of the new samples in a work
+/// buffer. Each output is the dot product of the I/Q taps with the
+/// interleaved samples starting nTaps - 1 samples earlier.
+typedef size_t (*FirFn)(const float * work, const float * iqTaps,
+                        size_t nTaps, size_t first, size_t end, size_t step,
+                        std::complex<float> * out);
+
+static size_t
+firScalar(const float * work, const float * iqTaps, size_t nTaps,
+          size_t first, size_t end, size_t step, std::complex<float> * out) {
+    size_t nOut = 0;
+    for (size_t i = first; i < end; i += step) {
+        const float * x = work + 2 * i;
+        float sumI = 0.0f;
+        float sumQ = 0.0f;
+        for (size_t j = 0; j < 2 * nTaps; j += 2) {
+            sumI += x[j] * iqTaps[j];
+            sumQ += x[j + 1] * iqTaps[j + 1];
+        }
+        out[nOut++] = std::complex<float>(sumI, sumQ);
+    }
+    return(nOut);
+}
+
+#ifdef PENTEK_XX821_DECIMATOR_X86
+
+/// @brief Sum the I (even) and Q (odd) lanes of a vector of I/Q products
+/// into lanes 0 and 1
+__attribute__((target("avx2,fma")))
+static inline __m128
+avx2SumIq(__m256 acc) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+                            _mm256_extractf128_ps(acc, 1));
+    return(_mm_add_ps(sum, _mm_movehl_ps(sum, sum)));
+}
+
+/// @brief Finish an output from the summed lanes and the leftover taps
+static inline std::complex<float>
+finishOutput(__m128 sum, const float * x, const float * iqTaps, size_t j,
+             size_t nFloats) {
+    float sumI = _mm_cvtss_f32(sum);
+    float sumQ = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, 1));
+    for (; j < nFloats; j += 2) {
+        sumI += x[j] * iqTaps[j];
+        sumQ += x[j + 1] * iqTaps[j + 1];
+    }
+    return(std::complex<float>(sumI, sumQ));
+}
+
+/// @brief AVX2 version of firScalar(), 8 taps per iteration
+__attribute__((target("avx2,fma")))
+static size_t
+firAvx2(const float * work, const float * iqTaps, size_t nTaps,
+        size_t first, size_t end, size_t step, std::complex<float> * out) {
+    const size_t nFloats = 2 * nTaps;
+    size_t nOut = 0;
+    for (size_t i = first; i < end; i += step) {
+        const float * x = work + 2 * i;
+        // Two accumulators to keep two FMAs in flight
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        size_t j = 0;
+        for (; j + 16 <= nFloats; j += 16) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + j),
+                                   _mm256_loadu_ps(iqTaps + j), acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + j + 8),
+                                   _mm256_loadu_ps(iqTaps + j + 8), acc1);
+        }
+        if (j + 8 <= nFloats) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + j),
+                                   _mm256_loadu_ps(iqTaps + j), acc0);
+            j += 8;
+        }
+        __m128 sum = avx2SumIq(_mm256_add_ps(acc0, acc1));
+        out[nOut++] = finishOutput(sum, x, iqTaps, j, nFloats);
+    }
+    return(nOut);
+}
+
+// GCC 12's AVX-512 headers trip -Wmaybe-uninitialized in their own inline
+// functions
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/// @brief AVX-512 version of firScalar(), 16 taps per iteration. Every
+/// AVX-512 CPU has FMA, which the 256-bit steps use.
+__attribute__((target("avx512f,avx512bw,fma")))
+static size_t
+firAvx512(const float * work, const float * iqTaps, size_t nTaps,
+          size_t first, size_t end, size_t step, std::complex<float> * out) {
+    const size_t nFloats = 2 * nTaps;
+    size_t nOut = 0;
+    for (size_t i = first; i < end; i += step) {
+        const float * x = work + 2 * i;
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        size_t j = 0;
+        for (; j + 32 <= nFloats; j += 32) {
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + j),
+                                   _mm512_loadu_ps(iqTaps + j), acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + j + 16),
+                                   _mm512_loadu_ps(iqTaps + j + 16), acc1);
+        }
+        if (j + 16 <= nFloats) {
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + j),
+                                   _mm512_loadu_ps(iqTaps + j), acc0);
+            j += 16;
+        }
+        acc0 = _mm512_add_ps(acc0, acc1);
+        __m256 acc = _mm256_add_ps(
+                _mm512_castps512_ps256(acc0),
+                _mm256_castpd_ps(_mm512_extractf64x4_pd(
+                        _mm512_castps_pd(acc0), 1)));
+        if (j + 8 <= nFloats) {
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + j),
+                                  _mm256_loadu_ps(iqTaps + j), acc);
+            j += 8;
+        }
+        out[nOut++] = finishOutput(avx2SumIq(acc), x, iqTaps, j, nFloats);
+    }
+    return(nOut);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // PENTEK_XX821_DECIMATOR_X86
+
+/// @brief Return the filter function for this CPU, matching the instruction
+/// set chosen for the unpack kernels
+static FirFn
+chooseFir() {
+#ifdef PENTEK_XX821_DECIMATOR_X86
+    switch (Pentek_xx821Unpack::ActiveIsa()) {
+    case Pentek_xx821Unpack::ISA_AVX512:
+        return(firAvx512);
+    case Pentek_xx821Unpack::ISA_AVX2:
+        return(firAvx2);
+    default:
+        break;
+    }
+#endif
+    return(firScalar);
+}
+
+Pentek_xx821Decimator::Config
+Pentek_xx821Decimator::DefaultConfig(const std::vector<float> & taps,
+                                     uint32_t decimation, uint32_t nChannels,
+                                     uint32_t maxBlockPairs) {
+    Config config;
+    config.taps = taps;
+    config.decimation = decimation;
+    config.nChannels = nChannels;
+    config.maxBlockPairs = maxBlockPairs;
+    config.nWorkers = 1;
+    config.workerThreadConfig = Pentek_xx821ServiceThread::DefaultConfig(-1);
+    config.correction = Pentek_xx821Unpack::UnitScale();
+    config.byteSwap = false;
+    return(config);
+}
+
+Pentek_xx821Decimator::Pentek_xx821Decimator(const Config & config) :
+    _config(config),
+    _iqTaps(),
+    _historyPairs(0),
+    _channels(),
+    _jobBlocks(NULL),
+    _workers()
+{
+    if (_config.taps.empty() || _config.decimation == 0 ||
+            _config.nChannels == 0 || _config.nWorkers == 0) {
+        std::ostringstream os;
+        os << "Bad decimator configuration: " << _config.taps.size() <<
+              " taps, decimation " << _config.decimation << ", " <<
+              _config.nChannels << " channels, " << _config.nWorkers <<
+              " workers";
+        throw ConstructError(os.str());
+    }
+
+    // Reverse the taps, so each output is a straight dot product with the
+    // samples in order, and repeat each for I and Q
+    size_t nTaps = _config.taps.size();
+    _historyPairs = nTaps - 1;
+    for (size_t t = nTaps; t > 0; t--) {
+        _iqTaps.push_back(_config.taps[t - 1]);
+        _iqTaps.push_back(_config.taps[t - 1]);
+    }
+
+    size_t maxOutputs = (size_t(_config.maxBlockPairs) + _config.decimation -
+                         1) / _config.decimation;
+    for (uint32_t c = 0; c < _config.nChannels; c++) {
+        std::unique_ptr<Channel> ch(new Channel);
+        ch->work.resize(2 * (_historyPairs + WORK_PAIRS));
+        ch->outBuf.resize(maxOutputs);
+        ch->output.samples = ch->outBuf.data();
+        ch->output.count = 0;
+        ch->output.firstInputIndex = 0;
+        ch->output.timetag = 0;
+        ch->gapCount = 0;
+        _clearHistory(*ch);
+        _channels.push_back(std::move(ch));
+    }
+
+    _workers.reset(new Pentek_xx821WorkerPool(
+            "decimator", _config.nWorkers, _config.workerThreadConfig,
+            [this](uint32_t worker) { _runJob(worker); }));
+
+    DLOG << "Decimation by " << _config.decimation << " with " << nTaps <<
+            " taps for " << _config.nChannels << " channel(s) on " <<
+            _config.nWorkers << " worker(s)";
+}
+
+Pentek_xx821Decimator::~Pentek_xx821Decimator() {
+    _workers.reset();
+}
+
+void
+Pentek_xx821Decimator::_clearHistory(Channel & ch) {
+    std::fill(ch.work.begin(), ch.work.begin() + 2 * _historyPairs, 0.0f);
+    ch.nextOutput = 0;
+    ch.firstBlock = true;
+}
+
+void
+Pentek_xx821Decimator::reset() {
+    for (size_t c = 0; c < _channels.size(); c++) {
+        _clearHistory(*_channels[c]);
+    }
+}
+
+void
+Pentek_xx821Decimator::_beginOutput(Channel & ch, size_t nPairs,
+                                    uint64_t timetag) {
+    size_t maxOutputs = (nPairs + _config.decimation - 1) /
+                        _config.decimation;
+    if (ch.outBuf.size() < maxOutputs) {
+        DEFERRABLE_WLOG("Growing decimator output buffer for a block of " <<
+                        nPairs << " pairs, longer than the configured " <<
+                        _config.maxBlockPairs);
+        ch.outBuf.resize(maxOutputs);
+    }
+    ch.output.samples = ch.outBuf.data();
+    ch.output.count = 0;
+    ch.output.firstInputIndex = ch.nextOutput;
+    ch.output.timetag = timetag;
+}
+
+void
+Pentek_xx821Decimator::_filterWork(Channel & ch, size_t nNew) {
+    static const FirFn fir = chooseFir();
+
+    // Outputs fall every decimation'th input sample, continuing the phase
+    // from the previous piece
+    size_t first = ch.nextOutput;
+    if (first < nNew) {
+        size_t nOut = fir(ch.work.data(), _iqTaps.data(), _iqTaps.size() / 2,
+                          first, nNew, _config.decimation,
+                          &ch.outBuf[ch.output.count]);
+        ch.output.count += nOut;
+        first += nOut * _config.decimation;
+    }
+    ch.nextOutput = first - nNew;
+
+    // The newest nTaps - 1 samples become the history for the next piece
+    memmove(ch.work.data(), ch.work.data() + 2 * nNew,
+            2 * _historyPairs * sizeof(float));
+}
+
+const Pentek_xx821Decimator::Output &
+Pentek_xx821Decimator::processChannel(uint32_t chan, const int16_t * iq,
+                                      size_t nPairs, uint64_t timetag) {
+    Channel & ch = *_channels[chan];
+    _beginOutput(ch, nPairs, timetag);
+    std::complex<float> * newSamples = reinterpret_cast<std::complex<float> *>(
+            ch.work.data() + 2 * _historyPairs);
+    for (size_t offset = 0; offset < nPairs; offset += WORK_PAIRS) {
+        size_t n = std::min(WORK_PAIRS, nPairs - offset);
+        Pentek_xx821Unpack::IqToComplex(iq + 2 * offset, newSamples, n,
+                                        _config.correction, _config.byteSwap);
+        _filterWork(ch, n);
+    }
+    return(ch.output);
+}
+
+const Pentek_xx821Decimator::Output &
+Pentek_xx821Decimator::processFloatChannel(uint32_t chan,
+                                           const std::complex<float> * in,
+                                           size_t nSamples, uint64_t timetag) {
+    Channel & ch = *_channels[chan];
+    _beginOutput(ch, nSamples, timetag);
+    std::complex<float> * newSamples = reinterpret_cast<std::complex<float> *>(
+            ch.work.data() + 2 * _historyPairs);
+    for (size_t offset = 0; offset < nSamples; offset += WORK_PAIRS) {
+        size_t n = std::min(WORK_PAIRS, nSamples - offset);
+        std::copy(in + offset, in + offset + n, newSamples);
+        _filterWork(ch, n);
+    }
+    return(ch.output);
+}
+
+void
+Pentek_xx821Decimator::_runJob(uint32_t worker) {
+    // Channels are dealt out to the workers in turn
+    for (uint32_t c = worker; c < _config.nChannels; c += _config.nWorkers) {
+        Channel & ch = *_channels[c];
+        const Pentek_xx821Dn::RxBlock * block = _jobBlocks[c];
+        if (! block) {
+            ch.output.count = 0;
+            continue;
+        }
+
+        // History from before a gap would smear into the new samples
+        if (! ch.firstBlock && block->sequence != ch.expectedSeq) {
+            DEFERRABLE_WLOG("Clearing decimator history for channel " << c <<
+                            " after block sequence gap at " <<
+                            block->sequence);
+            _clearHistory(ch);
+            ch.gapCount++;
+        }
+        ch.firstBlock = false;
+        ch.expectedSeq = block->sequence + 1;
+
+        processChannel(c, static_cast<const int16_t *>(block->data),
+                       block->bytes / (2 * sizeof(int16_t)), block->timetag);
+    }
+}
+
+void
+Pentek_xx821Decimator::processBlocks(
+        const Pentek_xx821Dn::RxBlock * const * blocks) {
+    _jobBlocks = blocks;
+    _workers->runOnAll();
+}
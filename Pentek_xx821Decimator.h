@@ -0,0 +1,244 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Decimator.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821DECIMATOR_H_
+#define PENTEK_XX821DECIMATOR_H_
+
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Pentek_xx821Dn.h"
+#include "Pentek_xx821ServiceThread.h"
+#include "Pentek_xx821Unpack.h"
+#include "Pentek_xx821WorkerPool.h"
+
+/// @brief Host-side FIR decimation of DDC output, for output rates the
+/// board's own decimation can't reach
+///
+/// Each channel's complex samples are filtered with the same real-valued
+/// FIR filter, and only every decimation'th output is computed (the
+/// polyphase form of decimation, so the work per input sample is
+/// nTaps / decimation multiply-adds). Filter history is kept across blocks,
+/// so a stream split into blocks of any size gives the same output as the
+/// whole stream filtered at once.
+///
+/// int16 I/Q input is converted with Pentek_xx821Unpack straight from the
+/// DMA buffer into a preallocated work buffer, which the filter then runs
+/// over; complex float input is copied in instead. The filter uses AVX-512
+/// or AVX2 kernels when the unpack kernels use them. Nothing is allocated
+/// while processing, except to grow a channel's output buffer the first
+/// time it sees a block longer than Config::maxBlockPairs.
+///
+/// processBlocks() processes one block from each of several channels at
+/// once, with the channels split across the calling thread and worker
+/// service threads. processChannel() and processFloatChannel() process a
+/// single channel on the calling thread.
+///
+/// No two calls may process the same channel at the same time, and
+/// processBlocks() must be called from only one thread at a time.
+class Pentek_xx821Decimator {
+public:
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief Processing configuration
+    struct Config {
+        /// @brief FIR filter taps, at the input sample rate
+        std::vector<float> taps;
+        /// @brief Decimation factor, at least 1
+        uint32_t decimation;
+        /// @brief Number of channels
+        uint32_t nChannels;
+        /// @brief Expected largest block, in I/Q pairs, used to size the
+        /// output buffers
+        uint32_t maxBlockPairs;
+        /// @brief Number of threads sharing the channels in
+        /// processBlocks(), including the calling thread
+        uint32_t nWorkers;
+        /// @brief Scheduling settings for the worker service threads
+        Pentek_xx821ServiceThread::Config workerThreadConfig;
+        /// @brief Gain and offset correction applied to int16 samples
+        Pentek_xx821Unpack::Correction correction;
+        /// @brief True if int16 samples are byte-swapped (big-endian)
+        bool byteSwap;
+    };
+
+    /// @brief A channel's output from its latest block
+    struct Output {
+        /// @brief The decimated samples
+        const std::complex<float> * samples;
+        /// @brief Number of decimated samples
+        size_t count;
+        /// @brief Index, within the input block, of the newest input sample
+        /// used for the first output sample
+        size_t firstInputIndex;
+        /// @brief Board timetag of the input block
+        uint64_t timetag;
+    };
+
+    /// @brief Return a default configuration: one worker, unit-scale
+    /// samples, and worker service threads with default settings
+    /// @param taps the FIR filter taps
+    /// @param decimation the decimation factor
+    /// @param nChannels the number of channels
+    /// @param maxBlockPairs the expected largest block, in I/Q pairs
+    /// @return a default configuration
+    static Config DefaultConfig(const std::vector<float> & taps,
+                                uint32_t decimation, uint32_t nChannels,
+                                uint32_t maxBlockPairs);
+
+    /// @brief Constructor. Buffers are allocated and worker service threads
+    /// are started here.
+    /// @param config the processing configuration
+    /// @throws ConstructError if the configuration is unusable
+    Pentek_xx821Decimator(const Config & config);
+
+    /// @brief Destructor. Stops the worker threads.
+    virtual ~Pentek_xx821Decimator();
+
+    /// @brief Decimate one block from each channel, sharing the channels
+    /// among the workers. A gap in a channel's block sequence clears its
+    /// filter history. The blocks may be released as soon as this returns.
+    /// @param blocks pointers to the blocks, one per channel; a NULL
+    /// pointer skips the channel, and its output() is left empty
+    void processBlocks(const Pentek_xx821Dn::RxBlock * const * blocks);
+
+    /// @brief Decimate int16 I/Q samples for one channel on the calling
+    /// thread
+    /// @param chan the channel
+    /// @param iq the I/Q samples
+    /// @param nPairs the number of I/Q pairs
+    /// @param timetag board timetag of the first sample
+    /// @return the channel's output, valid until its next processing call
+    const Output & processChannel(uint32_t chan, const int16_t * iq,
+                                  size_t nPairs, uint64_t timetag);
+
+    /// @brief Decimate complex float samples for one channel on the calling
+    /// thread
+    /// @param chan the channel
+    /// @param in the samples
+    /// @param nSamples the number of samples
+    /// @param timetag board timetag of the first sample
+    /// @return the channel's output, valid until its next processing call
+    const Output & processFloatChannel(uint32_t chan,
+                                       const std::complex<float> * in,
+                                       size_t nSamples, uint64_t timetag);
+
+    /// @brief Return a channel's output from its latest block
+    /// @param chan the channel
+    /// @return the channel's output, valid until its next processing call
+    const Output & output(uint32_t chan) const {
+        return(_channels[chan]->output);
+    }
+
+    /// @brief Clear the filter history of all channels and forget their
+    /// expected block sequences, e.g., after restarting the DDC channels
+    void reset();
+
+    /// @brief Return the processing configuration
+    /// @return the processing configuration
+    const Config & config() const { return(_config); }
+
+    /// @brief Return the number of times a channel's filter history was
+    /// cleared because of a block sequence gap
+    /// @param chan the channel
+    /// @return the number of sequence gaps seen on the channel
+    uint64_t gapCount(uint32_t chan) const {
+        return(_channels[chan]->gapCount);
+    }
+
+private:
+    /// @brief Filter state and buffers for one channel
+    struct Channel {
+        /// @brief Work buffer: nTaps - 1 samples of history followed by
+        /// room for WORK_PAIRS new samples, as interleaved I and Q
+        std::vector<float> work;
+        /// @brief Index, within the next input, of the next output sample
+        size_t nextOutput;
+        /// @brief Output buffer
+        std::vector<std::complex<float> > outBuf;
+        /// @brief Output from the latest block
+        Output output;
+        /// @brief Sequence number expected for the next block
+        uint32_t expectedSeq;
+        /// @brief Is the next block the first since construction or reset()?
+        bool firstBlock;
+        /// @brief Number of sequence gaps seen
+        std::atomic<uint64_t> gapCount;
+    };
+
+    /// @brief Start a channel's output for a new input block, growing the
+    /// output buffer if needed
+    /// @param ch the channel
+    /// @param nPairs the number of samples in the block
+    /// @param timetag board timetag of the block
+    void _beginOutput(Channel & ch, size_t nPairs, uint64_t timetag);
+
+    /// @brief Filter the new samples in a channel's work buffer, then move
+    /// the newest samples into its history
+    /// @param ch the channel
+    /// @param nNew the number of new samples in the work buffer
+    void _filterWork(Channel & ch, size_t nNew);
+
+    /// @brief Clear a channel's filter history
+    /// @param ch the channel
+    void _clearHistory(Channel & ch);
+
+    /// @brief Run the current job on the given worker's channels
+    /// @param worker the worker index
+    void _runJob(uint32_t worker);
+
+    /// @brief Processing configuration
+    Config _config;
+
+    /// @brief Taps, reversed and with each tap repeated for I and Q
+    std::vector<float> _iqTaps;
+
+    /// @brief Number of history samples kept, nTaps - 1
+    size_t _historyPairs;
+
+    /// @brief Per-channel state
+    std::vector<std::unique_ptr<Channel> > _channels;
+
+    /// @brief Blocks for the current job
+    const Pentek_xx821Dn::RxBlock * const * _jobBlocks;
+
+    /// @brief The workers, which run _runJob()
+    std::unique_ptr<Pentek_xx821WorkerPool> _workers;
+};
+
+#endif /* PENTEK_XX821DECIMATOR_H_ */
@@ -0,0 +1,172 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821DeferredLog.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstring>
+#include <unistd.h>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+
+LOGGING("Pentek_xx821DeferredLog")
+
+const size_t Pentek_xx821DeferredLog::MAX_MESSAGE_BYTES;
+const size_t Pentek_xx821DeferredLog::MAX_QUEUED;
+const int64_t Pentek_xx821DeferredLog::Site::RECHECK_INTERVAL_MS;
+
+static_assert((Pentek_xx821DeferredLog::MAX_QUEUED &
+               (Pentek_xx821DeferredLog::MAX_QUEUED - 1)) == 0,
+              "MAX_QUEUED must be a power of 2");
+
+// How long the drain thread sleeps when it finds the ring empty
+static const useconds_t DRAIN_IDLE_SLEEP_US = 10000;
+
+// One message in the ring. A slot's sequence number says whose turn it is:
+// it equals the ring position when the slot is free for the message at that
+// position, and the position + 1 once the message has been written.
+struct RingSlot {
+    std::atomic<size_t> sequence;
+    Pentek_xx821DeferredLog::Site * site;
+    size_t length;
+    char text[Pentek_xx821DeferredLog::MAX_MESSAGE_BYTES];
+};
+
+// Ring shared by any number of posting threads and the single drain thread.
+// It is allocated once and never freed, so that the detached drain thread
+// can't outlive it at exit.
+struct DrainState {
+    DrainState() : slots(new RingSlot[Pentek_xx821DeferredLog::MAX_QUEUED]),
+        postPos(0), dropped(0), drainStarted(false) {
+        for (size_t i = 0; i < Pentek_xx821DeferredLog::MAX_QUEUED; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingSlot * slots;
+    std::atomic<size_t> postPos;
+    std::atomic<uint64_t> dropped;
+    boost::mutex startMutex;
+    bool drainStarted;
+};
+
+static DrainState &
+drainState() {
+    static DrainState * state = new DrainState;
+    return(*state);
+}
+
+// Pass queued messages on to logx
+static void
+drain() {
+    static const size_t MASK = Pentek_xx821DeferredLog::MAX_QUEUED - 1;
+    DrainState & state = drainState();
+    size_t pos = 0;
+    uint64_t lastDropped = 0;
+    std::string msg;
+    for (;;) {
+        RingSlot & slot = state.slots[pos & MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            uint64_t dropped = state.dropped.load(std::memory_order_relaxed);
+            if (dropped != lastDropped) {
+                WLOG << (dropped - lastDropped) <<
+                        " deferred log message(s) dropped (queue full)";
+                lastDropped = dropped;
+            }
+            usleep(DRAIN_IDLE_SLEEP_US);
+            continue;
+        }
+        msg.assign(slot.text, slot.length);
+        Pentek_xx821DeferredLog::Site * site = slot.site;
+        // Hand the slot back to the posting threads before logging
+        slot.sequence.store(pos + Pentek_xx821DeferredLog::MAX_QUEUED,
+                            std::memory_order_release);
+        pos++;
+        // Each message is logged by its call site, under the caller's
+        // logx category
+        site->emit(msg);
+    }
+}
+
+void
+Pentek_xx821DeferredLog::SetDeferring(bool defer) {
+    if (defer) {
+        StartDrain();
+    }
+    _Deferring() = defer;
+}
+
+void
+Pentek_xx821DeferredLog::StartDrain() {
+    DrainState & state = drainState();
+    boost::mutex::scoped_lock guard(state.startMutex);
+    if (! state.drainStarted) {
+        boost::thread(drain).detach();
+        state.drainStarted = true;
+    }
+}
+
+void
+Pentek_xx821DeferredLog::Post(Site & site, const MessageBuffer & msg) {
+    static const size_t MASK = MAX_QUEUED - 1;
+    DrainState & state = drainState();
+    size_t pos = state.postPos.load(std::memory_order_relaxed);
+    RingSlot * slot;
+    for (;;) {
+        slot = &state.slots[pos & MASK];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        ptrdiff_t diff = ptrdiff_t(sequence) - ptrdiff_t(pos);
+        if (diff == 0) {
+            // The slot is free; claim it
+            if (state.postPos.compare_exchange_weak(pos, pos + 1,
+                    std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The slot still holds a message from a lap ago: the ring is
+            // full
+            state.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            // Another thread claimed this position first
+            pos = state.postPos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->site = &site;
+    slot->length = msg.length();
+    memcpy(slot->text, msg.text(), slot->length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+uint64_t
+Pentek_xx821DeferredLog::DroppedCount() {
+    return(drainState().dropped.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,202 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821DeferredLog.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821DEFERREDLOG_H_
+#define PENTEK_XX821DEFERREDLOG_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+/// @brief Log a message through logx, or through Pentek_xx821DeferredLog if
+/// the calling thread defers its logging. LOGMACRO is the logx macro to use
+/// (DLOG, ILOG, WLOG or ELOG) and STREAM a << expression.
+///
+/// Each call site gets a Pentek_xx821DeferredLog::Site whose emit function
+/// is compiled in the caller's file, so the drain thread logs the message
+/// under the caller's logx category and level. A deferring thread formats
+/// the message into a fixed-size buffer on its stack (longer messages are
+/// truncated) and never allocates or takes a lock.
+///
+/// NOTE: when the drain thread finds that a site's level is disabled,
+/// deferring threads stop formatting that site's messages for
+/// Site::RECHECK_INTERVAL_MS. The next message after that is queued again
+/// so that the level is re-checked: a level enabled at run time takes
+/// effect for deferred messages within that interval, and the first such
+/// message may be lost.
+#define PENTEK_XX821_LOG(LOGMACRO, STREAM) \
+    do { \
+        if (Pentek_xx821DeferredLog::Deferring()) { \
+            static Pentek_xx821DeferredLog::Site deferredLogSite_( \
+                    [](const std::string & msg) -> bool { \
+                        bool emitted = false; \
+                        LOGMACRO << (emitted = true, msg); \
+                        return(emitted); \
+                    }); \
+            if (deferredLogSite_.enabled()) { \
+                Pentek_xx821DeferredLog::MessageBuffer deferredLogBuffer_; \
+                std::ostream deferredLogStream_(&deferredLogBuffer_); \
+                deferredLogStream_ << STREAM; \
+                Pentek_xx821DeferredLog::Post(deferredLogSite_, \
+                                              deferredLogBuffer_); \
+            } \
+        } else { \
+            LOGMACRO << STREAM; \
+        } \
+    } while (0)
+
+#define DEFERRABLE_DLOG(STREAM) PENTEK_XX821_LOG(DLOG, STREAM)
+#define DEFERRABLE_ILOG(STREAM) PENTEK_XX821_LOG(ILOG, STREAM)
+#define DEFERRABLE_WLOG(STREAM) PENTEK_XX821_LOG(WLOG, STREAM)
+#define DEFERRABLE_ELOG(STREAM) PENTEK_XX821_LOG(ELOG, STREAM)
+
+/// @brief Queue of log messages from threads which must not block on log
+/// output, written out by a background drain thread
+///
+/// A thread opts in with SetDeferring(true) (Pentek_xx821ServiceThread does
+/// this when its Config asks for it). The library's hot-path messages use
+/// the DEFERRABLE_xLOG macros, which then just format the message and copy
+/// it into a preallocated lock-free ring of MAX_QUEUED fixed-size slots; the
+/// drain thread passes it on to logx. If the ring is full, messages are
+/// dropped and counted rather than blocking the caller.
+class Pentek_xx821DeferredLog {
+public:
+    /// @brief Longest deferred message, in bytes. Longer messages are
+    /// truncated.
+    static const size_t MAX_MESSAGE_BYTES = 256;
+
+    /// @brief Number of slots in the ring (a power of 2)
+    static const size_t MAX_QUEUED = 4096;
+
+    /// @brief One PENTEK_XX821_LOG call site
+    class Site {
+    public:
+        /// @brief Function which logs a message through the call site's logx
+        /// macro, returning false if logx discarded it unformatted because
+        /// the macro's level is disabled
+        typedef bool (*EmitFunction)(const std::string & msg);
+
+        /// @brief How long a site found to be disabled stays disabled
+        /// before its level is checked again, in milliseconds
+        static const int64_t RECHECK_INTERVAL_MS = 1000;
+
+        /// @brief Constructor
+        /// @param emit the function which logs the site's messages
+        explicit Site(EmitFunction emit) : _emit(emit), _disabledUntilMs(0) {}
+
+        /// @brief Return false if the site's level was recently found to be
+        /// disabled
+        /// @return false if the site's messages need not be formatted
+        bool enabled() const {
+            int64_t until = _disabledUntilMs.load(std::memory_order_relaxed);
+            return(until == 0 || _NowMs() >= until);
+        }
+
+        /// @brief Log a message through the site's logx macro, noting
+        /// whether its level is enabled. Called by the drain thread.
+        /// @param msg the message
+        void emit(const std::string & msg) {
+            int64_t until = _emit(msg) ? 0 : _NowMs() + RECHECK_INTERVAL_MS;
+            _disabledUntilMs.store(until, std::memory_order_relaxed);
+        }
+
+    private:
+        /// @brief Return the monotonic clock time
+        /// @return the monotonic clock time, in milliseconds
+        static int64_t _NowMs() {
+            using namespace std::chrono;
+            return(duration_cast<milliseconds>(
+                    steady_clock::now().time_since_epoch()).count());
+        }
+
+        EmitFunction _emit;
+        /// @brief Time until which the site is taken to be disabled, or 0
+        std::atomic<int64_t> _disabledUntilMs;
+    };
+
+    /// @brief Fixed-size buffer a deferred message is formatted into,
+    /// normally on the caller's stack. Output past MAX_MESSAGE_BYTES is
+    /// discarded.
+    class MessageBuffer : public std::streambuf {
+    public:
+        MessageBuffer() { setp(_text, _text + MAX_MESSAGE_BYTES); }
+
+        /// @brief Return the formatted text (not null terminated)
+        /// @return the formatted text
+        const char * text() const { return(_text); }
+
+        /// @brief Return the length of the formatted text
+        /// @return the length of the formatted text, in bytes
+        size_t length() const { return(pptr() - pbase()); }
+
+    private:
+        char _text[MAX_MESSAGE_BYTES];
+    };
+
+    /// @brief Set whether the calling thread defers its log messages,
+    /// starting the drain thread if necessary
+    /// @param defer true to defer the calling thread's log messages
+    static void SetDeferring(bool defer);
+
+    /// @brief Return true if the calling thread defers its log messages
+    /// @return true if the calling thread defers its log messages
+    static bool Deferring() { return(_Deferring()); }
+
+    /// @brief Start the drain thread if it isn't already running.
+    /// Pentek_xx821ServiceThread calls this when a thread which defers its
+    /// logging is started, so that Post() never has to.
+    static void StartDrain();
+
+    /// @brief Queue a message for the drain thread. This never blocks or
+    /// allocates: if the ring is full, the message is dropped.
+    /// @param site the call site, which must live until the message has been
+    /// drained (PENTEK_XX821_LOG uses a function-local static)
+    /// @param msg the message
+    static void Post(Site & site, const MessageBuffer & msg);
+
+    /// @brief Return the number of messages dropped because the ring was
+    /// full
+    /// @return the number of messages dropped because the ring was full
+    static uint64_t DroppedCount();
+
+private:
+    /// @brief Return a reference to the calling thread's deferring flag
+    /// @return a reference to the calling thread's deferring flag
+    static bool & _Deferring() {
+        static thread_local bool deferring = false;
+        return(deferring);
+    }
+};
+
+#endif /* PENTEK_XX821DEFERREDLOG_H_ */
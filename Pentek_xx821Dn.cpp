@@ -0,0 +1,290 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Dn.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <sstream>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+
+#include "Pentek_xx821Dn.h"
+
+LOGGING("Pentek_xx821Dn")
+
+const uint32_t Pentek_xx821Dn::DEFAULT_BUFFER_COUNT;
+const uint32_t Pentek_xx821Dn::DEFAULT_BUFFER_BYTES;
+const uint32_t Pentek_xx821Dn::HUGEPAGE_BYTES;
+
+Pentek_xx821Dn::Pentek_xx821Dn(Pentek_xx821 & board, uint32_t chanId,
+                               uint32_t nBuffers, uint32_t bufferBytes,
+                               void * ringMem) :
+    _board(board),
+    _chanId(chanId),
+    _nBuffers(nBuffers),
+    _bufferBytes((bufferBytes + 4095) & ~4095u),
+    _ringMem(NULL),
+    _userRingMem(ringMem),
+    _slotData(),
+    _slotBusAddr(),
+    _descs(NULL),
+    _borrowed(new std::atomic<bool>[nBuffers]),
+    _nextSlot(0),
+    _expectedSeq(0),
+    _firstBlock(true),
+    _running(false),
+    _blockCount(0),
+    _overrunCount(0),
+    _droppedBlockCount(0),
+    _waiter(board, NAV_DMA_DIR_TO_HOST, chanId)
+{
+    if (int32_t(_chanId) >= _board.ddcCount()) {
+        std::ostringstream os;
+        os << "Cannot use DDC channel " << _chanId << " on Pentek_xx821 board " <<
+              _board._boardNum << " (only " << _board.ddcCount() <<
+              " channels)";
+        throw ConstructError(os.str());
+    }
+    if (_nBuffers < 2 || _bufferBytes == 0 ||
+            uint64_t(_nBuffers) * _bufferBytes > UINT32_MAX) {
+        std::ostringstream os;
+        os << "Bad receive ring size for DDC channel " << _chanId << ": " <<
+              nBuffers << " buffers of " << bufferBytes << " bytes";
+        throw ConstructError(os.str());
+    }
+    if (_userRingMem) {
+        // Each buffer is mapped on its own and gets one bus address, so it
+        // must lie within one hugepage
+        uintptr_t first = reinterpret_cast<uintptr_t>(_userRingMem);
+        for (uint32_t slot = 0; slot < _nBuffers; slot++) {
+            uintptr_t start = first + uintptr_t(slot) * _bufferBytes;
+            if (start / HUGEPAGE_BYTES !=
+                    (start + _bufferBytes - 1) / HUGEPAGE_BYTES) {
+                std::ostringstream os;
+                os << "Receive buffer " << slot << " for DDC channel " <<
+                      _chanId << " crosses a hugepage boundary in the " <<
+                      "caller's ring memory";
+                throw ConstructError(os.str());
+            }
+        }
+    }
+
+    // Get the sample buffers (from the caller, or else from the board's
+    // buffer pool if possible) and the descriptors
+    bool haveBuffers = _userRingMem ? _mapUserRingMem() :
+                       _board._allocRingBuffers(_nBuffers, _bufferBytes,
+                                                _slotData, _slotBusAddr,
+                                                _ringMem);
+    uint64_t descBusAddr;
+    _descs = static_cast<NAV_DMA_DESC *>(
+            _board._allocDmaMemory(_nBuffers * sizeof(NAV_DMA_DESC),
+                                   descBusAddr));
+    if (! haveBuffers || ! _descs) {
+        _freeBuffers(haveBuffers);
+        _board._freeDmaMemory(_descs);
+        std::ostringstream os;
+        os << "Failed to allocate receive ring for DDC channel " << _chanId;
+        throw ConstructError(os.str());
+    }
+
+    // Point each descriptor at its buffer, and ask for an interrupt on each
+    // completion so that acquireBlock() can sleep while waiting.
+    for (uint32_t slot = 0; slot < _nBuffers; slot++) {
+        NAV_DMA_DESC & desc = _descs[slot];
+        desc.busAddr = _slotBusAddr[slot];
+        desc.length = _bufferBytes;
+        desc.control = NAV_DMA_DESC_CTRL_IRQ;
+        desc.status = 0;
+        _borrowed[slot] = false;
+    }
+
+    DLOG << "DDC channel " << _chanId << " receive ring: " << _nBuffers <<
+            " x " << _bufferBytes << " bytes";
+}
+
+Pentek_xx821Dn::~Pentek_xx821Dn() {
+    stop();
+    _freeBuffers(true);
+    _board._freeDmaMemory(_descs);
+}
+
+bool
+Pentek_xx821Dn::_mapUserRingMem() {
+    for (uint32_t slot = 0; slot < _nBuffers; slot++) {
+        uint8_t * data = static_cast<uint8_t *>(_userRingMem) +
+                         uint64_t(slot) * _bufferBytes;
+        uint64_t busAddr;
+        int32_t status = NAV_DmaMemMap(_board._boardHandle, data,
+                                       _bufferBytes, &busAddr);
+        if (status != NAV_STAT_OK) {
+            _logDmaError(status, "NAV_DmaMemMap");
+            _freeBuffers(true);
+            return(false);
+        }
+        _slotData.push_back(data);
+        _slotBusAddr.push_back(busAddr);
+    }
+    return(true);
+}
+
+void
+Pentek_xx821Dn::_freeBuffers(bool haveBuffers) {
+    if (! _userRingMem) {
+        _board._freeRingBuffers(_slotData, _ringMem);
+    } else if (haveBuffers) {
+        for (uint8_t * data : _slotData) {
+            int32_t status = NAV_DmaMemUnmap(_board._boardHandle, data);
+            if (status != NAV_STAT_OK) {
+                _logDmaError(status, "NAV_DmaMemUnmap");
+            }
+        }
+        _slotData.clear();
+        _slotBusAddr.clear();
+    }
+}
+
+bool
+Pentek_xx821Dn::start() {
+    boost::recursive_mutex::scoped_lock guard(_board._mutex);
+    if (_running) {
+        return(true);
+    }
+
+    // Give every descriptor to the board
+    for (uint32_t slot = 0; slot < _nBuffers; slot++) {
+        _descs[slot].status = 0;
+        _borrowed[slot] = false;
+    }
+    _nextSlot = 0;
+    _firstBlock = true;
+    _blockCount = 0;
+    _overrunCount = 0;
+    _droppedBlockCount = 0;
+
+    int32_t status = NAV_DmaLinkedListSetup(_board._boardHandle,
+                                            NAV_DMA_DIR_TO_HOST, _chanId,
+                                            _descs, _nBuffers);
+    if (status != NAV_STAT_OK) {
+        _logDmaError(status, "NAV_DmaLinkedListSetup");
+        return(false);
+    }
+    status = NAV_DmaStart(_board._boardHandle, NAV_DMA_DIR_TO_HOST, _chanId);
+    if (status != NAV_STAT_OK) {
+        _logDmaError(status, "NAV_DmaStart");
+        return(false);
+    }
+    _running = true;
+    return(true);
+}
+
+void
+Pentek_xx821Dn::stop() {
+    boost::recursive_mutex::scoped_lock guard(_board._mutex);
+    if (! _running) {
+        return;
+    }
+    int32_t status = NAV_DmaStop(_board._boardHandle, NAV_DMA_DIR_TO_HOST,
+                                 _chanId);
+    if (status != NAV_STAT_OK) {
+        _logDmaError(status, "NAV_DmaStop");
+    }
+    _running = false;
+}
+
+void
+Pentek_xx821Dn::_logDmaError(int32_t status, const std::string & funcName) const {
+    std::ostringstream os;
+    os << funcName << " for DDC channel " << _chanId << " on board " <<
+          _board._boardNum;
+    Pentek_xx821::_LogNavigatorError(status, os.str());
+}
+
+bool
+Pentek_xx821Dn::_slotReady(uint32_t slot) const {
+    return((_descs[slot].status & NAV_DMA_DESC_STAT_DONE) &&
+           ! _borrowed[slot].load(std::memory_order_acquire));
+}
+
+bool
+Pentek_xx821Dn::acquireBlock(RxBlock & block, uint32_t timeoutMs) {
+    uint32_t slot = _nextSlot;
+    if (! _slotReady(slot)) {
+        // Wait for the board to complete the slot, by polling or interrupt
+        // depending on the board's completion mode
+        if (! _running) {
+            return(false);
+        }
+        if (! _waiter.wait([this, slot]() { return(_slotReady(slot)); },
+                           timeoutMs)) {
+            return(false);
+        }
+    }
+
+    // Don't look at the block contents until after we've seen the
+    // descriptor's DONE status
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    const NAV_DMA_DESC & desc = _descs[slot];
+    block.handle = slot;
+    block.data = _slotData[slot];
+    block.bytes = desc.xferBytes;
+    block.timetag = desc.timetag;
+    block.sequence = desc.sequence;
+
+    // Detect blocks dropped by the board from gaps in the sequence
+    if (! _firstBlock && block.sequence != _expectedSeq) {
+        uint32_t nDropped = block.sequence - _expectedSeq;
+        _overrunCount++;
+        _droppedBlockCount += nDropped;
+        _board._telemetry.count(Pentek_xx821Telemetry::RX_OVERRUNS);
+        _board._telemetry.count(Pentek_xx821Telemetry::RX_DROPPED_BLOCKS,
+                                nDropped);
+        DEFERRABLE_WLOG("DDC channel " << _chanId << " overrun: " <<
+                        nDropped << " block(s) dropped before sequence " <<
+                        block.sequence);
+    }
+    _firstBlock = false;
+    _expectedSeq = block.sequence + 1;
+
+    _borrowed[slot].store(true, std::memory_order_relaxed);
+    _nextSlot = (slot + 1) % _nBuffers;
+    _blockCount++;
+    _waiter.noteCompletion();
+    _board._telemetry.count(Pentek_xx821Telemetry::RX_BLOCKS);
+    _board._telemetry.count(Pentek_xx821Telemetry::RX_BYTES, block.bytes);
+    return(true);
+}
+
+void
+Pentek_xx821Dn::releaseBlock(const RxBlock & block) {
+    uint32_t slot = block.handle;
+    // Finish with the buffer contents before the board can overwrite them
+    std::atomic_thread_fence(std::memory_order_release);
+    _descs[slot].status = 0;
+    _borrowed[slot].store(false, std::memory_order_release);
+}
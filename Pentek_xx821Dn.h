@@ -0,0 +1,247 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Dn.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821DN_H_
+#define PENTEK_XX821DN_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Pentek_xx821.h"
+#include "Pentek_xx821CompletionWaiter.h"
+
+/// @brief Class which encapsulates one ADC/downconverter (DDC) channel of a
+/// Pentek xx821-series board
+///
+/// Received samples are delivered through a zero-copy receive ring: a fixed
+/// set of pinned DMA buffers, each with a Navigator linked-list descriptor,
+/// which the board fills in order. A consumer borrows completed blocks with
+/// acquireBlock(), works directly on the DMA buffer, and hands the buffer
+/// back to the board with releaseBlock(). No samples are copied between the
+/// board and the consumer.
+///
+/// The board stamps each block with a sequence number. If the board finds
+/// its next descriptor still held by the host, the block is dropped on the
+/// card but its sequence number is still consumed, so overruns show up as
+/// gaps in the sequence seen by acquireBlock().
+///
+/// acquireBlock() must be called from only one thread at a time;
+/// releaseBlock() may be called from any thread.
+class Pentek_xx821Dn {
+public:
+    /// @brief Default number of DMA buffers in the receive ring
+    static const uint32_t DEFAULT_BUFFER_COUNT = 64;
+
+    /// @brief Default size of each DMA buffer, in bytes
+    static const uint32_t DEFAULT_BUFFER_BYTES = 65536;
+
+    /// @brief Size of the hugepages which caller-supplied ring memory is
+    /// expected to lie in. No DMA buffer in such memory may cross a
+    /// multiple of this size.
+    static const uint32_t HUGEPAGE_BYTES = 2 * 1024 * 1024;
+
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief A block of received samples borrowed from the receive ring
+    ///
+    /// The data pointer refers directly to the DMA buffer written by the
+    /// board, and remains valid until the block is passed to releaseBlock().
+    struct RxBlock {
+        /// @brief Ring slot holding the block, used to return it
+        uint32_t handle;
+        /// @brief Start of the sample data
+        const void * data;
+        /// @brief Number of valid bytes at data
+        uint32_t bytes;
+        /// @brief Board timetag of the first sample in the block
+        uint64_t timetag;
+        /// @brief Board sequence number of the block
+        uint32_t sequence;
+    };
+
+    /// @brief Constructor
+    /// @param board the board containing the channel; it must outlive this
+    /// object
+    /// @param chanId the DDC channel number, 0 to board.ddcCount() - 1
+    /// @param nBuffers the number of DMA buffers in the receive ring
+    /// @param bufferBytes the size of each DMA buffer, in bytes; it is
+    /// rounded up to a multiple of 4096
+    /// @param ringMem page-aligned memory to hold the DMA buffers (e.g., a
+    /// shared memory segment), with room for nBuffers of the rounded
+    /// bufferBytes; each buffer is made available for DMA separately with
+    /// NAV_DmaMemMap() for the life of this object, and the memory must
+    /// outlive it. Since each buffer gets a single bus address, it must be
+    /// physically contiguous: the memory should be backed by hugepages, and
+    /// no buffer may cross a multiple of HUGEPAGE_BYTES. If NULL, the
+    /// buffers come from the board's buffer pool or a DMA allocation.
+    /// @throws ConstructError on error in construction
+    Pentek_xx821Dn(Pentek_xx821 & board, uint32_t chanId,
+                   uint32_t nBuffers = DEFAULT_BUFFER_COUNT,
+                   uint32_t bufferBytes = DEFAULT_BUFFER_BYTES,
+                   void * ringMem = NULL);
+
+    /// @brief Destructor. DMA is stopped if it is running.
+    virtual ~Pentek_xx821Dn();
+
+    /// @brief Return the DDC channel number
+    /// @return the DDC channel number
+    uint32_t chanId() const { return(_chanId); }
+
+    /// @brief Return the number of DMA buffers in the receive ring
+    /// @return the number of DMA buffers in the receive ring
+    uint32_t bufferCount() const { return(_nBuffers); }
+
+    /// @brief Return the size of each DMA buffer, in bytes
+    /// @return the size of each DMA buffer, in bytes
+    uint32_t bufferBytes() const { return(_bufferBytes); }
+
+    /// @brief Hand all ring buffers to the board and start DMA
+    ///
+    /// Any blocks still borrowed are implicitly returned, and the sequence
+    /// tracking and counters are reset.
+    /// @return true iff DMA was started successfully
+    bool start();
+
+    /// @brief Stop DMA
+    void stop();
+
+    /// @brief Return true iff DMA is running
+    /// @return true iff DMA is running
+    bool running() const { return(_running); }
+
+    /// @brief Borrow the next completed block from the receive ring
+    /// @param[out] block the borrowed block, if one is available
+    /// @param timeoutMs the longest time to wait for a block, in ms
+    /// @return true iff a block was borrowed
+    bool acquireBlock(RxBlock & block, uint32_t timeoutMs);
+
+    /// @brief Return a borrowed block to the receive ring, making its buffer
+    /// available to the board again
+    /// @param block the block to return
+    void releaseBlock(const RxBlock & block);
+
+    /// @brief Return the number of blocks delivered since start()
+    /// @return the number of blocks delivered since start()
+    uint64_t blockCount() const { return(_blockCount); }
+
+    /// @brief Return the number of overruns (sequence gaps) seen since
+    /// start()
+    /// @return the number of overruns seen since start()
+    uint64_t overrunCount() const { return(_overrunCount); }
+
+    /// @brief Return the number of blocks dropped by the board since start()
+    /// @return the number of blocks dropped by the board since start()
+    uint64_t droppedBlockCount() const { return(_droppedBlockCount); }
+
+protected:
+    /// @brief Return true iff the descriptor at the given ring slot has been
+    /// completed by the board and not yet borrowed
+    bool _slotReady(uint32_t slot) const;
+
+    /// @brief Carve the caller-supplied ring memory into the ring's buffers
+    /// and make each one available for DMA
+    /// @return true iff every buffer was mapped for DMA
+    bool _mapUserRingMem();
+
+    /// @brief Free (or, for caller-supplied memory, unmap) the ring's
+    /// buffers
+    /// @param haveBuffers true if the buffers were obtained successfully
+    void _freeBuffers(bool haveBuffers);
+
+    /// @brief Log an error from a Navigator DMA call for this channel
+    /// @param status the status returned by the Navigator function
+    /// @param funcName the name of the Navigator function
+    void _logDmaError(int32_t status, const std::string & funcName) const;
+
+    /// @brief The board containing the channel
+    Pentek_xx821 & _board;
+
+    /// @brief DDC channel number
+    uint32_t _chanId;
+
+    /// @brief Number of DMA buffers in the ring
+    uint32_t _nBuffers;
+
+    /// @brief Size of each DMA buffer, in bytes
+    uint32_t _bufferBytes;
+
+    /// @brief Single DMA allocation holding the ring's sample buffers, or
+    /// NULL if they came from the board's buffer pool or the caller
+    void * _ringMem;
+
+    /// @brief Caller-supplied memory holding the ring's sample buffers, or
+    /// NULL
+    void * _userRingMem;
+
+    /// @brief Address of each ring slot's sample buffer
+    std::vector<uint8_t *> _slotData;
+
+    /// @brief Bus address of each ring slot's sample buffer
+    std::vector<uint64_t> _slotBusAddr;
+
+    /// @brief Navigator descriptors for the ring, in DMA memory
+    NAV_DMA_DESC * _descs;
+
+    /// @brief Per-slot flags: is the slot's block currently borrowed?
+    std::unique_ptr<std::atomic<bool>[]> _borrowed;
+
+    /// @brief Ring slot of the next block to be delivered
+    uint32_t _nextSlot;
+
+    /// @brief Sequence number expected for the next block
+    uint32_t _expectedSeq;
+
+    /// @brief Is the first block since start() still to come?
+    bool _firstBlock;
+
+    /// @brief Is DMA running?
+    std::atomic<bool> _running;
+
+    /// @brief Number of blocks delivered since start()
+    std::atomic<uint64_t> _blockCount;
+
+    /// @brief Number of overruns seen since start()
+    std::atomic<uint64_t> _overrunCount;
+
+    /// @brief Number of blocks dropped by the board since start()
+    std::atomic<uint64_t> _droppedBlockCount;
+
+    /// @brief Waits for DMA completions in the board's completion mode
+    Pentek_xx821CompletionWaiter _waiter;
+};
+
+#endif /* PENTEK_XX821DN_H_ */
@@ -0,0 +1,160 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821FanIn.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+#include "Pentek_xx821Telemetry.h"
+
+#include "Pentek_xx821FanIn.h"
+
+LOGGING("Pentek_xx821FanIn")
+
+Pentek_xx821FanIn::Pentek_xx821FanIn(
+        const std::vector<Pentek_xx821Dn *> & channels,
+        uint64_t toleranceTicks) :
+    _channels(channels),
+    _toleranceTicks(toleranceTicks),
+    _offset(channels.size(), 0),
+    _held(channels.size()),
+    _isHeld(channels.size(), false),
+    _completeCount(0),
+    _incompleteCount(0),
+    _lateCount(new std::atomic<uint64_t>[channels.size()]),
+    _missingCount(new std::atomic<uint64_t>[channels.size()])
+{
+    if (_channels.empty()) {
+        throw ConstructError("Pentek_xx821FanIn needs at least one channel");
+    }
+    for (size_t c = 0; c < _channels.size(); c++) {
+        _lateCount[c] = 0;
+        _missingCount[c] = 0;
+    }
+}
+
+Pentek_xx821FanIn::~Pentek_xx821FanIn() {
+    for (size_t c = 0; c < _channels.size(); c++) {
+        if (_isHeld[c]) {
+            _channels[c]->releaseBlock(_held[c]);
+        }
+    }
+}
+
+void
+Pentek_xx821FanIn::setTimetagOffset(size_t chan, int64_t offsetTicks) {
+    _offset[chan] = offsetTicks;
+}
+
+bool
+Pentek_xx821FanIn::acquire(PulseSet & set, uint32_t timeoutMs) {
+    const size_t nChans = _channels.size();
+    uint64_t deadline = Pentek_xx821Telemetry::Now() +
+                        uint64_t(timeoutMs) * 1000000;
+    uint64_t newest;
+    while (true) {
+        // Take a head block from each channel which needs one, waiting no
+        // later than the deadline
+        for (size_t c = 0; c < nChans; c++) {
+            if (_isHeld[c]) {
+                continue;
+            }
+            uint64_t now = Pentek_xx821Telemetry::Now();
+            uint32_t remainingMs = (now < deadline) ?
+                                   (deadline - now + 999999) / 1000000 : 0;
+            _isHeld[c] = _channels[c]->acquireBlock(_held[c], remainingMs);
+        }
+
+        newest = 0;
+        bool anyHeld = false;
+        for (size_t c = 0; c < nChans; c++) {
+            if (_isHeld[c]) {
+                newest = std::max(newest, _alignedTimetag(c));
+                anyHeld = true;
+            }
+        }
+        if (! anyHeld) {
+            return(false);
+        }
+
+        // Heads older than the newest by more than the tolerance lost
+        // their partners on the other channels; drop them and try the
+        // channels' next blocks
+        bool droppedStale = false;
+        for (size_t c = 0; c < nChans; c++) {
+            if (_isHeld[c] && newest - _alignedTimetag(c) > _toleranceTicks) {
+                _channels[c]->releaseBlock(_held[c]);
+                _isHeld[c] = false;
+                _lateCount[c]++;
+                droppedStale = true;
+            }
+        }
+        if (! droppedStale) {
+            bool allHeld = std::find(_isHeld.begin(), _isHeld.end(), false) ==
+                           _isHeld.end();
+            if (allHeld || Pentek_xx821Telemetry::Now() >= deadline) {
+                break;
+            }
+        }
+    }
+
+    // Hand the heads over to the caller
+    set.timetag = newest;
+    set.blocks = _held;
+    set.present = _isHeld;
+    bool complete = true;
+    for (size_t c = 0; c < nChans; c++) {
+        if (_isHeld[c]) {
+            set.timetag = std::min(set.timetag, _alignedTimetag(c));
+            _isHeld[c] = false;
+        } else {
+            _missingCount[c]++;
+            complete = false;
+        }
+    }
+    if (complete) {
+        _completeCount++;
+    } else {
+        _incompleteCount++;
+        DEFERRABLE_DLOG("Pulse at timetag " << set.timetag <<
+                        " delivered with channel(s) missing");
+    }
+    return(true);
+}
+
+void
+Pentek_xx821FanIn::release(PulseSet & set) {
+    for (size_t c = 0; c < set.present.size(); c++) {
+        if (set.present[c]) {
+            _channels[c]->releaseBlock(set.blocks[c]);
+            set.present[c] = false;
+        }
+    }
+}
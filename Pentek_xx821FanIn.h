@@ -0,0 +1,183 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821FanIn.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821FANIN_H_
+#define PENTEK_XX821FANIN_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Pentek_xx821Dn.h"
+
+/// @brief Class which merges the receive rings of several DDC channels
+/// (e.g., H and V for dual-polarization) into coherent multi-channel pulses,
+/// by timetag
+///
+/// Each channel is expected to deliver one pulse per DMA block, stamped with
+/// the board timetag of its first sample. acquire() borrows the head block
+/// of every channel and lines them up: while a channel's head is older than
+/// the newest head by more than the tolerance, its partners were lost on
+/// the other channels, so it is released as stale and the channel's next
+/// block is taken. The resulting PulseSet refers directly to the DMA
+/// buffers; nothing is copied or queued, and no lock is taken.
+///
+/// Channels on different boards can be aligned by giving each channel a
+/// timetag offset which maps its board's timetags onto a common timebase.
+///
+/// A channel which has no block by the timeout is reported as missing in
+/// the PulseSet, and the other channels are delivered without it.
+///
+/// acquire() and release() must be called from only one thread at a time,
+/// and no other thread may acquire blocks from the channels.
+class Pentek_xx821FanIn {
+public:
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief One pulse across all channels, borrowed from the channels'
+    /// receive rings until passed to release()
+    struct PulseSet {
+        /// @brief Timetag of the pulse, in the common timebase
+        uint64_t timetag;
+        /// @brief The pulse's block from each channel; meaningful only
+        /// where present[] is true
+        std::vector<Pentek_xx821Dn::RxBlock> blocks;
+        /// @brief For each channel, true if it supplied a block
+        std::vector<bool> present;
+
+        /// @brief Return true iff every channel supplied a block
+        /// @return true iff every channel supplied a block
+        bool complete() const {
+            for (size_t c = 0; c < present.size(); c++) {
+                if (! present[c]) {
+                    return(false);
+                }
+            }
+            return(true);
+        }
+    };
+
+    /// @brief Constructor
+    /// @param channels the channels to merge, which must outlive this object
+    /// @param toleranceTicks the largest timetag difference, in board
+    /// ticks, between blocks of the same pulse
+    /// @throws ConstructError if no channels are given
+    Pentek_xx821FanIn(const std::vector<Pentek_xx821Dn *> & channels,
+                      uint64_t toleranceTicks);
+
+    /// @brief Destructor
+    virtual ~Pentek_xx821FanIn();
+
+    /// @brief Return the number of channels
+    /// @return the number of channels
+    size_t channelCount() const { return(_channels.size()); }
+
+    /// @brief Set the offset added to a channel's timetags to put them in
+    /// the common timebase (e.g., the skew between two boards' clocks)
+    /// @param chan the channel's index in the constructor's list
+    /// @param offsetTicks the offset, in board ticks
+    void setTimetagOffset(size_t chan, int64_t offsetTicks);
+
+    /// @brief Borrow the next aligned pulse from all channels
+    /// @param[out] set the pulse
+    /// @param timeoutMs the longest time to wait for the channels, in ms
+    /// @return true iff at least one channel supplied a block, in which
+    /// case set must be passed to release()
+    bool acquire(PulseSet & set, uint32_t timeoutMs);
+
+    /// @brief Return a pulse's blocks to their receive rings
+    /// @param set the pulse
+    void release(PulseSet & set);
+
+    /// @brief Return the number of pulses delivered with every channel
+    /// present
+    /// @return the number of complete pulses delivered
+    uint64_t completeCount() const { return(_completeCount); }
+
+    /// @brief Return the number of pulses delivered with one or more
+    /// channels missing
+    /// @return the number of incomplete pulses delivered
+    uint64_t incompleteCount() const { return(_incompleteCount); }
+
+    /// @brief Return the number of blocks from a channel released as stale,
+    /// i.e., which arrived too late to be aligned with the other channels
+    /// @param chan the channel's index in the constructor's list
+    /// @return the number of stale blocks from the channel
+    uint64_t lateCount(size_t chan) const { return(_lateCount[chan]); }
+
+    /// @brief Return the number of pulses delivered without a channel
+    /// @param chan the channel's index in the constructor's list
+    /// @return the number of pulses delivered without the channel
+    uint64_t missingCount(size_t chan) const { return(_missingCount[chan]); }
+
+private:
+    /// @brief Return a channel's held block's timetag in the common
+    /// timebase
+    /// @param chan the channel
+    /// @return the held block's timetag in the common timebase
+    uint64_t _alignedTimetag(size_t chan) const {
+        return(_held[chan].timetag + _offset[chan]);
+    }
+
+    /// @brief The channels
+    std::vector<Pentek_xx821Dn *> _channels;
+
+    /// @brief Largest timetag difference within a pulse
+    uint64_t _toleranceTicks;
+
+    /// @brief Per-channel timetag offsets
+    std::vector<int64_t> _offset;
+
+    /// @brief Per-channel head blocks, borrowed but not yet delivered
+    std::vector<Pentek_xx821Dn::RxBlock> _held;
+
+    /// @brief Per-channel flags: is a head block held?
+    std::vector<bool> _isHeld;
+
+    /// @brief Number of complete pulses delivered
+    std::atomic<uint64_t> _completeCount;
+
+    /// @brief Number of incomplete pulses delivered
+    std::atomic<uint64_t> _incompleteCount;
+
+    /// @brief Per-channel counts of stale blocks released
+    std::unique_ptr<std::atomic<uint64_t>[]> _lateCount;
+
+    /// @brief Per-channel counts of pulses delivered without the channel
+    std::unique_ptr<std::atomic<uint64_t>[]> _missingCount;
+};
+
+#endif /* PENTEK_XX821FANIN_H_ */
@@ -0,0 +1,50 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821FieldUpdate.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+
+#include "Pentek_xx821FieldUpdate.h"
+
+Pentek_xx821FieldUpdate &
+Pentek_xx821FieldUpdate::set(uint32_t regaddr, uint32_t mask, uint32_t bits) {
+    // Find the register's entry, or where to insert one
+    std::vector<RegUpdate>::iterator it =
+            std::lower_bound(_updates.begin(), _updates.end(), regaddr,
+                             [](const RegUpdate & u, uint32_t addr) {
+                                 return(u.regaddr < addr);
+                             });
+    if (it == _updates.end() || it->regaddr != regaddr) {
+        RegUpdate update = { regaddr, 0, 0 };
+        it = _updates.insert(it, update);
+    }
+    it->bits = (it->bits & ~mask) | (bits & mask);
+    it->mask |= mask;
+    return(*this);
+}
@@ -0,0 +1,98 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821FieldUpdate.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821FIELDUPDATE_H_
+#define PENTEK_XX821FIELDUPDATE_H_
+
+#include <cstdint>
+#include <vector>
+
+/// @brief A batch of register bit field changes to be applied to a
+/// Pentek_xx821 in one pass
+///
+/// Field changes are queued with set(), and all changes to the same register
+/// are merged, so that Pentek_xx821::applyFieldUpdate_() does at most one
+/// read (none if the register's shadow value is known or every bit is being
+/// set) and one write per register, however many fields change.
+///
+/// A later change to the same bits of a register overrides an earlier one.
+class Pentek_xx821FieldUpdate {
+public:
+    /// @brief Merged changes to one register
+    struct RegUpdate {
+        /// @brief Register address
+        uint32_t regaddr;
+        /// @brief Mask of the bits being changed
+        uint32_t mask;
+        /// @brief New values for the bits being changed
+        uint32_t bits;
+    };
+
+    Pentek_xx821FieldUpdate() : _updates() {}
+
+    /// @brief Queue a change to a bit field described by a Pentek_xx821Field
+    /// type
+    /// @param val the new field value, unshifted
+    /// @return this object, so that calls may be chained
+    template <class FIELD>
+    Pentek_xx821FieldUpdate & set(uint32_t val) {
+        typedef typename FIELD::Register Reg;
+        static_assert(Reg::writable, "register is read-only");
+        static_assert(Reg::readable || FIELD::mask == 0xffffffffUL,
+                      "partial field write needs a readable register");
+        return(set(Reg::addr, FIELD::mask, FIELD::Encode(val)));
+    }
+
+    /// @brief Queue a change to the given bits of a register
+    /// @param regaddr the register address
+    /// @param mask mask of the bits to change
+    /// @param bits the new values for the bits in mask (other bits ignored)
+    /// @return this object, so that calls may be chained
+    Pentek_xx821FieldUpdate & set(uint32_t regaddr, uint32_t mask,
+                                  uint32_t bits);
+
+    /// @brief Discard all queued changes
+    void clear() { _updates.clear(); }
+
+    /// @brief Return true iff no changes are queued
+    /// @return true iff no changes are queued
+    bool empty() const { return(_updates.empty()); }
+
+    /// @brief Return the merged changes, one per register, in ascending
+    /// register address order
+    /// @return the merged changes
+    const std::vector<RegUpdate> & updates() const { return(_updates); }
+
+private:
+    /// @brief Merged changes, sorted by register address
+    std::vector<RegUpdate> _updates;
+};
+
+#endif /* PENTEK_XX821FIELDUPDATE_H_ */
@@ -0,0 +1,118 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Health.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "Pentek_xx821Health.h"
+
+Pentek_xx821Health::Pentek_xx821Health() :
+    _current(0)
+{
+    for (int b = 0; b < 2; b++) {
+        _buffers[b].sequence = 0;
+        memset(&_buffers[b].snap, 0, sizeof(Snapshot));
+    }
+}
+
+void
+Pentek_xx821Health::publish(const Snapshot & snap) {
+    // Fill the buffer readers aren't directed to, then direct them to it
+    uint32_t next = 1 - _current.load(std::memory_order_relaxed);
+    Buffer & buf = _buffers[next];
+    uint32_t seq = buf.sequence.load(std::memory_order_relaxed);
+    buf.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    buf.snap = snap;
+    buf.sequence.store(seq + 2, std::memory_order_release);
+    _current.store(next, std::memory_order_release);
+}
+
+Pentek_xx821Health::Snapshot
+Pentek_xx821Health::snapshot() const {
+    while (true) {
+        const Buffer & buf = _buffers[_current.load(std::memory_order_acquire)];
+        uint32_t seq = buf.sequence.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        Snapshot snap = buf.snap;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (buf.sequence.load(std::memory_order_relaxed) == seq) {
+            return(snap);
+        }
+    }
+}
+
+std::string
+Pentek_xx821Health::FaultString(uint32_t faults) {
+    static const struct {
+        Fault fault;
+        const char * name;
+    } Names[] = {
+        { FAULT_LINK_QUERY, "PCIe link query failed" },
+        { FAULT_LINK_DOWNTRAINED, "PCIe link downtrained" },
+        { FAULT_CLOCK_UNLOCKED, "sample clock unlocked" }
+    };
+    std::string str;
+    for (size_t f = 0; f < sizeof(Names) / sizeof(Names[0]); f++) {
+        if (faults & Names[f].fault) {
+            str += (str.empty() ? "" : ", ");
+            str += Names[f].name;
+        }
+    }
+    return(str.empty() ? "none" : str);
+}
+
+std::string
+Pentek_xx821Health::summary(const std::string & indent) const {
+    Snapshot snap = snapshot();
+    std::ostringstream os;
+    if (snap.sampleCount == 0) {
+        os << indent << "not sampled" << std::endl;
+        return(os.str());
+    }
+    os << indent << "PCIe link: gen " << snap.linkSpeed << " x" <<
+          snap.linkWidth << ", max payload " << snap.maxPayloadSize <<
+          ", max read request " << snap.maxReadReqSize << std::endl;
+    if (snap.haveTemperature) {
+        os << indent << "temperature: " << std::fixed <<
+              std::setprecision(1) << snap.temperatureC << " C" << std::endl;
+    }
+    if (snap.haveClockLock) {
+        os << indent << "sample clock: " <<
+              (snap.clockLocked ? "locked" : "UNLOCKED") << std::endl;
+    }
+    os << indent << "faults: " << FaultString(snap.faults) << " (" <<
+          snap.faultEvents << " fault events in " << snap.sampleCount <<
+          " samples)" << std::endl;
+    return(os.str());
+}
@@ -0,0 +1,134 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Health.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821HEALTH_H_
+#define PENTEK_XX821HEALTH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// @brief The latest board health sample, published by the board's health
+/// sampler thread (see Pentek_xx821::startHealthSampler())
+///
+/// Samples are published into two alternating buffers, each guarded by a
+/// sequence count. The sampler always writes the buffer readers aren't
+/// directed to, so snapshot() normally copies the latest sample on the
+/// first try; it only retries if the sampler laps it while it copies.
+/// Reading never touches the hardware or takes a lock, so monitoring can
+/// call snapshot() as often as it likes without disturbing the data path.
+///
+/// publish() must be called from only one thread; snapshot() may be called
+/// from any number of threads.
+class Pentek_xx821Health {
+public:
+    /// @brief Fault flags in Snapshot::faults
+    enum Fault {
+        /// @brief NAV_GetPcieLinkStatus() failed
+        FAULT_LINK_QUERY = 0x1,
+        /// @brief The PCIe link is running slower or narrower than when the
+        /// board was opened
+        FAULT_LINK_DOWNTRAINED = 0x2,
+        /// @brief The board reports its sample clock unlocked
+        FAULT_CLOCK_UNLOCKED = 0x4
+    };
+
+    /// @brief One health sample
+    struct Snapshot {
+        /// @brief Number of samples taken, 0 if none has been
+        uint64_t sampleCount;
+        /// @brief Time of the sample, ns (see Pentek_xx821Telemetry::Now())
+        uint64_t sampleTime;
+        /// @brief PCIe link speed (1 = 2.5 GT/s, 2 = 5 GT/s, 3 = 8 GT/s, ...)
+        uint32_t linkSpeed;
+        /// @brief PCIe link width, lanes
+        uint32_t linkWidth;
+        /// @brief PCIe max payload size, bytes
+        uint32_t maxPayloadSize;
+        /// @brief PCIe max read request size, bytes
+        uint32_t maxReadReqSize;
+        /// @brief PCIe link status word
+        uint32_t linkStatus;
+        /// @brief True if the board reported a temperature
+        bool haveTemperature;
+        /// @brief Board temperature, deg C
+        float temperatureC;
+        /// @brief True if the board reported its clock lock status
+        bool haveClockLock;
+        /// @brief True if the sample clock is locked
+        bool clockLocked;
+        /// @brief Faults present in this sample, a mask of Fault values
+        uint32_t faults;
+        /// @brief Number of samples which showed a fault the previous
+        /// sample did not
+        uint64_t faultEvents;
+    };
+
+    /// @brief Constructor. snapshot() returns an empty sample until the
+    /// first publish().
+    Pentek_xx821Health();
+
+    /// @brief Publish a new sample
+    /// @param snap the sample
+    void publish(const Snapshot & snap);
+
+    /// @brief Return the latest sample
+    /// @return the latest sample, with sampleCount zero if none has been
+    /// published
+    Snapshot snapshot() const;
+
+    /// @brief Return a short multi-line summary of the latest sample, each
+    /// line starting with the given indent
+    /// @param indent string prepended to each line
+    /// @return a short summary of the latest sample
+    std::string summary(const std::string & indent = "") const;
+
+    /// @brief Return a readable list of faults
+    /// @param faults a mask of Fault values
+    /// @return the names of the faults, or "none"
+    static std::string FaultString(uint32_t faults);
+
+private:
+    /// @brief One of the two sample buffers
+    struct Buffer {
+        /// @brief Odd while the sampler is writing the buffer
+        std::atomic<uint32_t> sequence;
+        /// @brief The sample
+        Snapshot snap;
+    };
+
+    /// @brief The sample buffers
+    Buffer _buffers[2];
+
+    /// @brief Index of the buffer holding the latest sample
+    std::atomic<uint32_t> _current;
+};
+
+#endif /* PENTEK_XX821HEALTH_H_ */
@@ -0,0 +1,57 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Manager.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <logx/Logging.h>
+
+#include "Pentek_xx821Manager.h"
+
+LOGGING("Pentek_xx821Manager")
+
+Pentek_xx821Manager::Pentek_xx821Manager() :
+    _boardCount(0),
+    _enumerationTime(0.0),
+    _lastOpenTime(0.0)
+{
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+
+    // On failure, _FindBoards() releases our hold on the BSP before throwing
+    Pentek_xx821::_AcquireNavigator();
+    _boardCount = Pentek_xx821::_FindBoards();
+
+    _enumerationTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    ILOG << _boardCount << " Pentek board(s) enumerated in " <<
+            _enumerationTime << " s";
+}
+
+Pentek_xx821Manager::~Pentek_xx821Manager() {
+    Pentek_xx821::_CloseNavigatorOnLastInstance();
+}
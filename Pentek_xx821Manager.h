@@ -0,0 +1,137 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Manager.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821MANAGER_H_
+#define PENTEK_XX821MANAGER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#include "Pentek_xx821.h"
+
+/// @brief Class which brings up several Pentek xx821 boards at once
+///
+/// The manager holds the Navigator BSP open for its lifetime, so the BSP is
+/// started and the boards are enumerated only once, and the cached board
+/// list is shared by every board opened while the manager exists.
+/// openBoards() constructs the requested boards concurrently, one thread
+/// per board, and records the wall-clock time taken; each board's own
+/// per-phase times are available from Pentek_xx821::openTiming().
+class Pentek_xx821Manager {
+public:
+    /// @brief Constructor. Starts the Navigator BSP (if no board has already
+    /// done so) and enumerates the boards.
+    /// @throws Pentek_xx821::ConstructError if the BSP cannot be started or
+    /// the boards cannot be enumerated
+    Pentek_xx821Manager();
+
+    /// @brief Destructor. Releases the manager's hold on the Navigator BSP.
+    virtual ~Pentek_xx821Manager();
+
+    /// @brief Managers can't be copied, since each one holds the Navigator
+    /// BSP open exactly once
+    Pentek_xx821Manager(const Pentek_xx821Manager &) = delete;
+    Pentek_xx821Manager & operator=(const Pentek_xx821Manager &) = delete;
+
+    /// @brief Return the number of boards found in the system
+    /// @return the number of boards found in the system
+    int32_t boardCount() const { return(_boardCount); }
+
+    /// @brief Return the time taken to start the Navigator BSP and enumerate
+    /// the boards, in seconds
+    /// @return the time taken to start the BSP and enumerate the boards
+    double enumerationTime() const { return(_enumerationTime); }
+
+    /// @brief Return the wall-clock time taken by the last openBoards()
+    /// call, in seconds
+    /// @return the wall-clock time taken by the last openBoards() call
+    double lastOpenTime() const { return(_lastOpenTime); }
+
+    /// @brief Construct the given boards concurrently
+    ///
+    /// If any board fails to open, the boards which did open are destroyed
+    /// and the first error is rethrown.
+    /// @tparam BOARD the board class to construct, Pentek_xx821 or a
+    /// subclass with a constructor taking just the board number
+    /// @param boardNums the numbers of the boards to open
+    /// @return the opened boards, in the same order as boardNums
+    /// @throws Pentek_xx821::ConstructError (or whatever BOARD's constructor
+    /// throws) if any board fails to open
+    template <class BOARD>
+    std::vector<std::unique_ptr<BOARD> >
+    openBoards(const std::vector<uint16_t> & boardNums) {
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+
+        size_t nBoards = boardNums.size();
+        std::vector<std::unique_ptr<BOARD> > boards(nBoards);
+        std::vector<std::exception_ptr> errors(nBoards);
+        boost::thread_group threads;
+        for (size_t i = 0; i < nBoards; i++) {
+            threads.create_thread([i, &boardNums, &boards, &errors]() {
+                try {
+                    boards[i].reset(new BOARD(boardNums[i]));
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        threads.join_all();
+
+        _lastOpenTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+
+        for (size_t i = 0; i < nBoards; i++) {
+            if (errors[i]) {
+                boards.clear();
+                std::rethrow_exception(errors[i]);
+            }
+        }
+        return(boards);
+    }
+
+private:
+    /// @brief Number of boards found in the system
+    int32_t _boardCount;
+
+    /// @brief Time taken to start the BSP and enumerate the boards, s
+    double _enumerationTime;
+
+    /// @brief Wall-clock time taken by the last openBoards() call, s
+    double _lastOpenTime;
+};
+
+#endif /* PENTEK_XX821MANAGER_H_ */
@@ -0,0 +1,175 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821NavDma.h
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Declarations of the Navigator BSP's linked-list DMA interface, as used by
+ * the Pentek_xx821 library. nav_common.h declares the board, register and
+ * status parts of the Navigator API, but not these, so the library declares
+ * the DMA calls it assumes here. Include this after nav_common.h.
+ *
+ * The assumed model: each channel is driven from a host-resident list of
+ * NAV_DMA_DESC descriptors, used in ring order. A descriptor with status 0
+ * belongs to the board; the board sets NAV_DMA_DESC_STAT_DONE when it hands
+ * the descriptor back to the host, after filling in the byte count,
+ * timetag and sequence number of the transfer.
+ *
+ * Only builds which define PENTEK_XX821_NAV_DMA (the simulated backend, or
+ * PENTEK_NAV_DMA=yes for a BSP which provides these entry points) get the
+ * real calls, declared with C linkage as the BSP's own are. Otherwise each
+ * call is an inline stub returning NAV_STAT_DMA_UNAVAILABLE, so that the
+ * library still links against a BSP without them; register access and
+ * board control work as before, and creating a DMA channel fails.
+ */
+
+#ifndef PENTEK_XX821NAVDMA_H_
+#define PENTEK_XX821NAVDMA_H_
+
+#include <cstdint>
+
+/// @brief Status returned by NAV_DmaWaitForInterrupt() when no interrupt
+/// arrives in time, if nav_common.h doesn't define one
+#ifndef NAV_STAT_TIMEOUT
+#define NAV_STAT_TIMEOUT 2
+#endif
+
+/// @brief Status returned by every DMA call in a build without Navigator
+/// DMA support
+#define NAV_STAT_DMA_UNAVAILABLE (-1)
+
+/// @brief Transfer direction: board to host
+#define NAV_DMA_DIR_TO_HOST 0
+
+/// @brief Transfer direction: host to board
+#define NAV_DMA_DIR_FROM_HOST 1
+
+/// @brief Descriptor control bit: interrupt the host when the descriptor
+/// completes
+#define NAV_DMA_DESC_CTRL_IRQ 0x1
+
+/// @brief Descriptor status bit: the board has completed the descriptor
+#define NAV_DMA_DESC_STAT_DONE 0x1
+
+/// @brief Descriptor status bit: the transfer failed
+#define NAV_DMA_DESC_STAT_ERROR 0x2
+
+/// @brief One DMA linked-list descriptor
+typedef struct {
+    /// @brief Bus address of the buffer
+    uint64_t busAddr;
+    /// @brief Size of the buffer, bytes
+    uint32_t length;
+    /// @brief NAV_DMA_DESC_CTRL_xxx bits
+    uint32_t control;
+    /// @brief 0 while owned by the board, else NAV_DMA_DESC_STAT_xxx bits
+    volatile uint32_t status;
+    /// @brief Bytes transferred
+    volatile uint32_t xferBytes;
+    /// @brief Board timetag of the transfer
+    volatile uint64_t timetag;
+    /// @brief Board sequence number of the transfer
+    volatile uint32_t sequence;
+    uint32_t reserved[3];
+} NAV_DMA_DESC;
+
+#ifdef PENTEK_XX821_NAV_DMA
+
+extern "C" {
+
+/// @brief Allocate pinned, physically contiguous memory for DMA
+int32_t NAV_DmaMemAlloc(void * board, uint32_t bytes, void ** virtAddr,
+                        uint64_t * busAddr);
+/// @brief Free memory from NAV_DmaMemAlloc()
+int32_t NAV_DmaMemFree(void * board, void * virtAddr);
+/// @brief Pin existing host memory and map it for DMA by the board. The
+/// range gets a single bus address, so it must be physically contiguous
+/// (e.g., lie within one hugepage).
+int32_t NAV_DmaMemMap(void * board, void * virtAddr, uint32_t bytes,
+                      uint64_t * busAddr);
+/// @brief Release a mapping made by NAV_DmaMemMap()
+int32_t NAV_DmaMemUnmap(void * board, void * virtAddr);
+/// @brief Give a channel its descriptor list
+int32_t NAV_DmaLinkedListSetup(void * board, uint32_t dir, uint32_t chan,
+                               NAV_DMA_DESC * descs, uint32_t nDescs);
+/// @brief Start a channel working through its descriptor list
+int32_t NAV_DmaStart(void * board, uint32_t dir, uint32_t chan);
+/// @brief Stop a channel
+int32_t NAV_DmaStop(void * board, uint32_t dir, uint32_t chan);
+/// @brief Wait for a descriptor completion interrupt from a channel
+int32_t NAV_DmaWaitForInterrupt(void * board, NAV_SYS_CONTEXT * context,
+                                uint32_t dir, uint32_t chan,
+                                uint32_t timeoutMs);
+
+}
+
+#else // PENTEK_XX821_NAV_DMA
+
+static inline int32_t
+NAV_DmaMemAlloc(void *, uint32_t, void **, uint64_t *) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaMemFree(void *, void *) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaMemMap(void *, void *, uint32_t, uint64_t *) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaMemUnmap(void *, void *) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaLinkedListSetup(void *, uint32_t, uint32_t, NAV_DMA_DESC *,
+                       uint32_t) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaStart(void *, uint32_t, uint32_t) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaStop(void *, uint32_t, uint32_t) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+static inline int32_t
+NAV_DmaWaitForInterrupt(void *, NAV_SYS_CONTEXT *, uint32_t, uint32_t,
+                        uint32_t) {
+    return(NAV_STAT_DMA_UNAVAILABLE);
+}
+
+#endif // PENTEK_XX821_NAV_DMA
+
+#endif /* PENTEK_XX821NAVDMA_H_ */
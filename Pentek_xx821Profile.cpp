@@ -0,0 +1,99 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Profile.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <logx/Logging.h>
+
+#include "Pentek_xx821Profile.h"
+
+LOGGING("Pentek_xx821Profile")
+
+Pentek_xx821Profile::Pentek_xx821Profile(const std::string & name) :
+    _name(name),
+    _settings(),
+    _hasArm(false),
+    _armAddr(0),
+    _armValue(0),
+    _compiled(false),
+    _runs(),
+    _values() {
+}
+
+void
+Pentek_xx821Profile::write(uint32_t regaddr, uint32_t val) {
+    _settings[regaddr] = val;
+    _compiled = false;
+}
+
+void
+Pentek_xx821Profile::setArmWrite(uint32_t regaddr, uint32_t val) {
+    _hasArm = true;
+    _armAddr = regaddr;
+    _armValue = val;
+}
+
+bool
+Pentek_xx821Profile::value(uint32_t regaddr, uint32_t & val) const {
+    std::map<uint32_t, uint32_t>::const_iterator it = _settings.find(regaddr);
+    if (it == _settings.end()) {
+        return(false);
+    }
+    val = it->second;
+    return(true);
+}
+
+void
+Pentek_xx821Profile::compile(const Pentek_xx821Profile * from) {
+    _runs.clear();
+    _values.clear();
+
+    // _settings is ordered by address, so consecutive registers which
+    // survive the comparison with 'from' can simply be appended to the
+    // current run.
+    std::map<uint32_t, uint32_t>::const_iterator it;
+    for (it = _settings.begin(); it != _settings.end(); it++) {
+        uint32_t oldVal;
+        if (from && from->value(it->first, oldVal) && oldVal == it->second) {
+            continue;
+        }
+        if (_runs.empty() ||
+                it->first != _runs.back().firstAddr + 4 * _runs.back().count) {
+            Run run = { it->first, _values.size(), 0 };
+            _runs.push_back(run);
+        }
+        _values.push_back(it->second);
+        _runs.back().count++;
+    }
+    _compiled = true;
+
+    DLOG << "Profile '" << _name << "' compiled" <<
+            (from ? " from '" + from->name() + "'" : std::string()) << ": " <<
+            _values.size() << " of " << _settings.size() << " registers in " <<
+            _runs.size() << " burst(s)";
+}
@@ -0,0 +1,154 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Profile.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821PROFILE_H_
+#define PENTEK_XX821PROFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/// @brief A precompiled board configuration (e.g., the DDC decimation,
+/// filter and transmit timing registers for one scan strategy)
+///
+/// A profile describes the final register state for a mode, not a sequence
+/// of writes: writing the same register twice keeps only the last value.
+/// Once all of its registers are set, compile() reduces the profile to a
+/// minimal write list, optionally dropping registers whose value is the same
+/// in a reference profile (typically the mode being switched from). The
+/// list is sorted by address and grouped into runs of consecutive
+/// registers, so Pentek_xx821::applyProfile_() can write it as a few tight
+/// bursts.
+///
+/// A profile may also name an "arm" register write, which is issued after
+/// everything else when the profile is applied with arming requested. With
+/// firmware which double-buffers its configuration registers, this is what
+/// makes the new configuration take effect at the next sync pulse.
+class Pentek_xx821Profile {
+public:
+    /// @brief A run of consecutive registers in the compiled write list
+    struct Run {
+        /// @brief Address of the first register in the run
+        uint32_t firstAddr;
+        /// @brief Index of the run's first value in values()
+        size_t firstValue;
+        /// @brief Number of registers in the run
+        size_t count;
+    };
+
+    /// @brief Constructor
+    /// @param name a name for the profile, used in log messages
+    Pentek_xx821Profile(const std::string & name = "");
+
+    /// @brief Return the profile's name
+    /// @return the profile's name
+    const std::string & name() const { return(_name); }
+
+    /// @brief Set the value for a register. This invalidates any previous
+    /// compile().
+    /// @param regaddr the register address
+    /// @param val the register value
+    void write(uint32_t regaddr, uint32_t val);
+
+    /// @brief Set the register write used to arm the configuration for the
+    /// next sync pulse
+    /// @param regaddr the arm register address
+    /// @param val the value to write to the arm register
+    void setArmWrite(uint32_t regaddr, uint32_t val);
+
+    /// @brief Return true iff the profile has an arm register write
+    /// @return true iff the profile has an arm register write
+    bool hasArmWrite() const { return(_hasArm); }
+
+    /// @brief Return the arm register address
+    /// @return the arm register address
+    uint32_t armAddr() const { return(_armAddr); }
+
+    /// @brief Return the value written to the arm register
+    /// @return the value written to the arm register
+    uint32_t armValue() const { return(_armValue); }
+
+    /// @brief Return the value for a register, if the profile sets it
+    /// @param regaddr the register address
+    /// @param[out] val the register value, if the profile sets it
+    /// @return true iff the profile sets the register
+    bool value(uint32_t regaddr, uint32_t & val) const;
+
+    /// @brief Build the compiled write list
+    /// @param from if non-NULL, registers which have the same value in this
+    /// profile and in @p from are dropped, on the assumption that @p from is
+    /// what is currently loaded on the board
+    void compile(const Pentek_xx821Profile * from = NULL);
+
+    /// @brief Return true iff compile() has been called since the last change
+    /// @return true iff the profile is compiled
+    bool compiled() const { return(_compiled); }
+
+    /// @brief Return the number of registers set by the profile
+    /// @return the number of registers set by the profile
+    size_t registerCount() const { return(_settings.size()); }
+
+    /// @brief Return the compiled runs of consecutive registers
+    /// @return the compiled runs of consecutive registers
+    const std::vector<Run> & runs() const { return(_runs); }
+
+    /// @brief Return the compiled register values, referenced by runs()
+    /// @return the compiled register values
+    const std::vector<uint32_t> & values() const { return(_values); }
+
+private:
+    /// @brief Profile name
+    std::string _name;
+
+    /// @brief Register values set by the profile, keyed by address
+    std::map<uint32_t, uint32_t> _settings;
+
+    /// @brief Is there an arm register write?
+    bool _hasArm;
+
+    /// @brief Arm register address
+    uint32_t _armAddr;
+
+    /// @brief Value written to the arm register
+    uint32_t _armValue;
+
+    /// @brief Has the write list been compiled since the last change?
+    bool _compiled;
+
+    /// @brief Compiled runs of consecutive registers
+    std::vector<Run> _runs;
+
+    /// @brief Compiled register values
+    std::vector<uint32_t> _values;
+};
+
+#endif /* PENTEK_XX821PROFILE_H_ */
@@ -0,0 +1,245 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Publisher.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/mman.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+#include "Pentek_xx821Publisher.h"
+
+LOGGING("Pentek_xx821Publisher")
+
+typedef Pentek_xx821StreamSegment Segment;
+
+Pentek_xx821Publisher::Pentek_xx821Publisher(
+        Pentek_xx821 & board, uint32_t chanId, const std::string & shmName,
+        uint32_t nBuffers, uint32_t bufferBytes, uint32_t readableDepth) :
+    _board(board),
+    _shmName(shmName),
+    _shmPath(Segment::Path(shmName)),
+    _shmBase(MAP_FAILED),
+    _shmBytes(0),
+    _header(NULL),
+    _slots(NULL),
+    _dn(),
+    _thread()
+{
+    // Round the buffer size so that the buffers tile the segment's
+    // hugepages
+    uint32_t requestedBytes = bufferBytes;
+    bufferBytes = Segment::BufferBytes(requestedBytes);
+    if (bufferBytes == 0) {
+        std::ostringstream os;
+        os << "Cannot publish DDC channel " << chanId << " with " <<
+              requestedBytes << "-byte buffers, larger than a " <<
+              Segment::HUGEPAGE_BYTES << "-byte hugepage";
+        throw ConstructError(os.str());
+    }
+    if (readableDepth == 0) {
+        readableDepth = nBuffers / 2;
+    }
+    if (nBuffers < 3 || readableDepth < 1 || readableDepth > nBuffers - 2) {
+        std::ostringstream os;
+        os << "Cannot publish DDC channel " << chanId << " with " <<
+              nBuffers << " buffers and a readable depth of " <<
+              readableDepth;
+        throw ConstructError(os.str());
+    }
+
+    Segment::Header layout;
+    _shmBytes = Segment::Layout(layout, nBuffers, bufferBytes);
+    int fd = open(_shmPath.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::ostringstream os;
+        os << "open(" << _shmPath << "): " << strerror(errno);
+        throw ConstructError(os.str());
+    }
+    // The DMA buffers must be physically contiguous, which only hugetlbfs
+    // guarantees
+    struct statfs fs;
+    if (fstatfs(fd, &fs) != 0 || fs.f_type != HUGETLBFS_MAGIC) {
+        close(fd);
+        unlink(_shmPath.c_str());
+        std::ostringstream os;
+        os << "Cannot publish in " << _shmPath << ": not on a hugetlbfs " <<
+              "mount (see PENTEK_XX821_HUGETLBFS)";
+        throw ConstructError(os.str());
+    }
+    if (ftruncate(fd, _shmBytes) == 0) {
+        _shmBase = mmap(NULL, _shmBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+    }
+    int err = errno;
+    close(fd);
+    if (_shmBase == MAP_FAILED) {
+        unlink(_shmPath.c_str());
+        std::ostringstream os;
+        os << "Cannot map " << _shmBytes << "-byte shared memory segment " <<
+              _shmPath << ": " << strerror(err) << " (are enough hugepages " <<
+              "reserved in /proc/sys/vm/nr_hugepages?)";
+        throw ConstructError(os.str());
+    }
+
+    _header = static_cast<Segment::Header *>(_shmBase);
+    memcpy(static_cast<void *>(_header), &layout, sizeof(layout));
+    _header->pid = getpid();
+    _header->boardNum = board.boardNum();
+    _header->chanId = chanId;
+    _header->readableDepth = readableDepth;
+    _header->reserved = 0;
+    _header->startCount = 0;
+    _header->publishing = 0;
+    _header->head = 0;
+    _slots = reinterpret_cast<Segment::SlotInfo *>(
+            static_cast<char *>(_shmBase) + _header->slotTableOffset);
+
+    try {
+        _dn.reset(new Pentek_xx821Dn(
+                board, chanId, nBuffers, bufferBytes,
+                static_cast<char *>(_shmBase) + _header->dataOffset));
+    } catch (Pentek_xx821Dn::ConstructError & e) {
+        munmap(_shmBase, _shmBytes);
+        unlink(_shmPath.c_str());
+        throw ConstructError(e.what());
+    }
+
+    ILOG << "Publishing DDC channel " << chanId << " of board " <<
+            board.boardNum() << " in shared memory segment " << shmName <<
+            " (" << nBuffers << " x " << bufferBytes << " bytes, " <<
+            readableDepth << " readable)";
+}
+
+Pentek_xx821Publisher::~Pentek_xx821Publisher() {
+    stop();
+    _dn.reset();
+    munmap(_shmBase, _shmBytes);
+    unlink(_shmPath.c_str());
+}
+
+bool
+Pentek_xx821Publisher::start() {
+    stop();
+
+    // Every slot starts out owned by the board
+    for (uint32_t slot = 0; slot < _header->nBuffers; slot++) {
+        _slots[slot].generation.store(1, std::memory_order_relaxed);
+    }
+    _header->head.store(0, std::memory_order_relaxed);
+    _header->startCount++;
+
+    if (! _dn->start()) {
+        return(false);
+    }
+    _header->publishing = 1;
+    std::ostringstream name;
+    name << "publish" << _dn->chanId();
+    _thread.reset(new Pentek_xx821ServiceThread(
+            name.str(), _board.serviceThreadConfig(),
+            [this](Pentek_xx821ServiceThread & thread) { _publish(thread); }));
+    return(true);
+}
+
+void
+Pentek_xx821Publisher::stop() {
+    if (! _thread) {
+        return;
+    }
+    _thread.reset();
+    _dn->stop();
+    _header->publishing = 0;
+
+    // Hand the blocks still in the readable window back to the board
+    const uint32_t nBuffers = _header->nBuffers;
+    uint64_t head = _header->head.load(std::memory_order_relaxed);
+    uint64_t first = head > _header->readableDepth ?
+                     head - _header->readableDepth : 0;
+    for (uint64_t n = first; n < head; n++) {
+        _releaseBlock(n % nBuffers, n);
+    }
+}
+
+void
+Pentek_xx821Publisher::_releaseBlock(uint32_t slot, uint64_t n) {
+    // Mark the slot first, so that readers know the block is gone
+    _slots[slot].generation.store(Segment::Generation(n) + 1,
+                                  std::memory_order_release);
+    Pentek_xx821Dn::RxBlock block;
+    block.handle = slot;
+    _dn->releaseBlock(block);
+}
+
+void
+Pentek_xx821Publisher::_publish(Pentek_xx821ServiceThread & thread) {
+    const uint32_t nBuffers = _header->nBuffers;
+    const uint32_t depth = _header->readableDepth;
+    uint64_t n = 0;
+    Pentek_xx821Dn::RxBlock block;
+    while (! thread.stopRequested()) {
+        if (! _dn->acquireBlock(block, 100)) {
+            continue;
+        }
+
+        // Readers find block n in slot n % nBuffers. The ring is consumed
+        // in order, so that is the slot the block arrived in; if it isn't,
+        // the readers' view of the ring is broken and publishing stops.
+        const uint32_t slot = n % nBuffers;
+        if (block.handle != slot) {
+            DEFERRABLE_ELOG("Publishing in " << _shmName << " stopped: " <<
+                            "block " << n << " arrived in ring slot " <<
+                            block.handle << " rather than " << slot);
+            _dn->releaseBlock(block);
+            _header->publishing = 0;
+            return;
+        }
+
+        // Hand the block leaving the readable window back to the board
+        if (n >= depth) {
+            uint64_t old = n - depth;
+            _releaseBlock(old % nBuffers, old);
+        }
+
+        // Publish the new block: metadata, then the slot's generation, then
+        // the head
+        Segment::SlotInfo & info = _slots[slot];
+        info.timetag = block.timetag;
+        info.boardSequence = block.sequence;
+        info.bytes = block.bytes;
+        info.generation.store(Segment::Generation(n),
+                              std::memory_order_release);
+        _header->head.store(++n, std::memory_order_release);
+    }
+}
@@ -0,0 +1,155 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Publisher.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821PUBLISHER_H_
+#define PENTEK_XX821PUBLISHER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Pentek_xx821Dn.h"
+#include "Pentek_xx821ServiceThread.h"
+#include "Pentek_xx821StreamSegment.h"
+
+/// @brief Class which shares one DDC channel's receive ring with reader
+/// processes through a named shared memory segment
+///
+/// The channel's DMA buffers are placed in the segment (see
+/// Pentek_xx821StreamSegment), so the board writes samples directly into
+/// memory that any number of Pentek_xx821Subscriber readers can map
+/// read-only. The segment is a file in a hugetlbfs mount, so that each DMA
+/// buffer is physically contiguous; enough hugepages must be reserved for
+/// it. A service thread takes each completed block from the ring,
+/// publishes its metadata in the segment, and returns the block that has
+/// just left the readable window to the board. Publishing takes no locks,
+/// and nothing is copied for any reader.
+///
+/// Readers which fall more than the readable depth behind lose blocks;
+/// they can tell from the block numbers and slot generations, and the
+/// publisher never waits for them.
+class Pentek_xx821Publisher {
+public:
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief Constructor. Creates the shared memory segment and the
+    /// channel's receive ring in it.
+    /// @param board the board containing the channel; it must outlive this
+    /// object
+    /// @param chanId the DDC channel number
+    /// @param shmName the shared memory segment name, e.g.,
+    /// "/pentek0_ddc0"; an existing segment of that name is replaced
+    /// @param nBuffers the number of DMA buffers in the receive ring
+    /// @param bufferBytes the size of each DMA buffer, in bytes; it is
+    /// rounded up to a power of two (see
+    /// Pentek_xx821StreamSegment::BufferBytes()), and may be at most one
+    /// hugepage
+    /// @param readableDepth the number of most recent blocks kept readable,
+    /// 1 to nBuffers - 2; 0 for half of the ring
+    /// @throws ConstructError on error in construction, including when the
+    /// segment's directory is not a hugetlbfs mount or not enough hugepages
+    /// are reserved
+    Pentek_xx821Publisher(
+            Pentek_xx821 & board, uint32_t chanId, const std::string & shmName,
+            uint32_t nBuffers = Pentek_xx821Dn::DEFAULT_BUFFER_COUNT,
+            uint32_t bufferBytes = Pentek_xx821Dn::DEFAULT_BUFFER_BYTES,
+            uint32_t readableDepth = 0);
+
+    /// @brief Destructor. Stops publishing and removes the segment name;
+    /// readers which have it mapped keep their mappings.
+    virtual ~Pentek_xx821Publisher();
+
+    /// @brief Start DMA on the channel and the publishing service thread,
+    /// which runs with the board's service thread settings. Block
+    /// numbering restarts from zero.
+    /// @return true iff DMA was started successfully
+    bool start();
+
+    /// @brief Stop the publishing service thread and DMA, and hand the
+    /// blocks still in the readable window back to the board
+    void stop();
+
+    /// @brief Return the shared memory segment name
+    /// @return the shared memory segment name
+    const std::string & shmName() const { return(_shmName); }
+
+    /// @brief Return the number of blocks published since start()
+    /// @return the number of blocks published since start()
+    uint64_t publishedCount() const { return(_header->head.load()); }
+
+    /// @brief Return the channel being published
+    /// @return the channel being published
+    const Pentek_xx821Dn & channel() const { return(*_dn); }
+
+private:
+    /// @brief Body of the publishing service thread
+    /// @param thread the service thread
+    void _publish(Pentek_xx821ServiceThread & thread);
+
+    /// @brief Mark a published block's slot as no longer readable, and hand
+    /// the block back to the board
+    /// @param slot the ring slot holding the block
+    /// @param n the block number
+    void _releaseBlock(uint32_t slot, uint64_t n);
+
+    /// @brief The board
+    Pentek_xx821 & _board;
+
+    /// @brief Shared memory segment name
+    std::string _shmName;
+
+    /// @brief Path of the file holding the segment
+    std::string _shmPath;
+
+    /// @brief Mapping of the segment
+    void * _shmBase;
+
+    /// @brief Size of the segment, bytes
+    size_t _shmBytes;
+
+    /// @brief The segment header, in _shmBase
+    Pentek_xx821StreamSegment::Header * _header;
+
+    /// @brief The slot table, in _shmBase
+    Pentek_xx821StreamSegment::SlotInfo * _slots;
+
+    /// @brief The channel, with its ring in the segment
+    std::unique_ptr<Pentek_xx821Dn> _dn;
+
+    /// @brief The publishing service thread, while running
+    std::unique_ptr<Pentek_xx821ServiceThread> _thread;
+};
+
+#endif /* PENTEK_XX821PUBLISHER_H_ */
@@ -0,0 +1,363 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821PulsePair.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <logx/Logging.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define PENTEK_XX821_PULSEPAIR_X86 1
+#endif
+
+#include "Pentek_xx821DeferredLog.h"
+
+#include "Pentek_xx821PulsePair.h"
+
+LOGGING("Pentek_xx821PulsePair")
+
+/// @brief Gate ranges are split on multiples of this many gates (64 bytes
+/// of floats), so that each range is a whole number of the AVX2 kernel's
+/// 8-gate steps and a whole number of 64-byte lines long. The
+/// per-gate arrays are std::vectors, aligned only as far as operator new
+/// guarantees, so neighbouring workers may still share the one cache line
+/// which straddles each range boundary.
+static const uint32_t GATE_ALIGNMENT = 16;
+
+/// @brief The planes used to accumulate one pulse
+struct AccumPlanes {
+    const float * curI;
+    const float * curQ;
+    const float * lag1I;
+    const float * lag1Q;
+    const float * lag2I;
+    const float * lag2Q;
+    float * r0;
+    float * r1Re;
+    float * r1Im;
+    float * r2Re;
+    float * r2Im;
+};
+
+typedef void (*AccumulateFn)(const AccumPlanes &, uint32_t, uint32_t,
+                             uint32_t);
+
+/// @brief Accumulate R0, and R1 and R2 if nLags is 2 or 3, for gates g0 to
+/// g1 - 1. R1 and R2 are the sums of x[n] * conj(x[n - lag]).
+static void
+accumulateScalar(const AccumPlanes & a, uint32_t g0, uint32_t g1,
+                 uint32_t nLags) {
+    for (uint32_t g = g0; g < g1; g++) {
+        float ci = a.curI[g];
+        float cq = a.curQ[g];
+        a.r0[g] += ci * ci + cq * cq;
+        if (nLags > 1) {
+            a.r1Re[g] += ci * a.lag1I[g] + cq * a.lag1Q[g];
+            a.r1Im[g] += cq * a.lag1I[g] - ci * a.lag1Q[g];
+        }
+        if (nLags > 2) {
+            a.r2Re[g] += ci * a.lag2I[g] + cq * a.lag2Q[g];
+            a.r2Im[g] += cq * a.lag2I[g] - ci * a.lag2Q[g];
+        }
+    }
+}
+
+#ifdef PENTEK_XX821_PULSEPAIR_X86
+
+/// @brief Accumulate one complex lag product into (re, im) for 8 gates
+__attribute__((target("avx2,fma")))
+static inline void
+avx2LagProduct(__m256 ci, __m256 cq, const float * lagI, const float * lagQ,
+               float * re, float * im) {
+    __m256 li = _mm256_loadu_ps(lagI);
+    __m256 lq = _mm256_loadu_ps(lagQ);
+    __m256 sumRe = _mm256_fmadd_ps(ci, li, _mm256_loadu_ps(re));
+    __m256 sumIm = _mm256_fmadd_ps(cq, li, _mm256_loadu_ps(im));
+    _mm256_storeu_ps(re, _mm256_fmadd_ps(cq, lq, sumRe));
+    _mm256_storeu_ps(im, _mm256_fnmadd_ps(ci, lq, sumIm));
+}
+
+/// @brief AVX2 version of accumulateScalar(), 8 gates per iteration
+__attribute__((target("avx2,fma")))
+static void
+accumulateAvx2(const AccumPlanes & a, uint32_t g0, uint32_t g1,
+               uint32_t nLags) {
+    uint32_t g = g0;
+    for (; g + 8 <= g1; g += 8) {
+        __m256 ci = _mm256_loadu_ps(a.curI + g);
+        __m256 cq = _mm256_loadu_ps(a.curQ + g);
+        __m256 r0 = _mm256_fmadd_ps(ci, ci, _mm256_loadu_ps(a.r0 + g));
+        _mm256_storeu_ps(a.r0 + g, _mm256_fmadd_ps(cq, cq, r0));
+        if (nLags > 1) {
+            avx2LagProduct(ci, cq, a.lag1I + g, a.lag1Q + g,
+                           a.r1Re + g, a.r1Im + g);
+        }
+        if (nLags > 2) {
+            avx2LagProduct(ci, cq, a.lag2I + g, a.lag2Q + g,
+                           a.r2Re + g, a.r2Im + g);
+        }
+    }
+    accumulateScalar(a, g, g1, nLags);
+}
+
+#endif // PENTEK_XX821_PULSEPAIR_X86
+
+/// @brief Return the accumulation function for this CPU. The AVX2 version
+/// is used whenever the unpack kernels found AVX2 (or better).
+static AccumulateFn
+chooseAccumulate() {
+#ifdef PENTEK_XX821_PULSEPAIR_X86
+    if (Pentek_xx821Unpack::ActiveIsa() >= Pentek_xx821Unpack::ISA_AVX2) {
+        return(accumulateAvx2);
+    }
+#endif
+    return(accumulateScalar);
+}
+
+Pentek_xx821PulsePair::Config
+Pentek_xx821PulsePair::DefaultConfig(uint32_t nGates, uint32_t pulsesPerDwell,
+                                     double wavelength, double prt) {
+    Config config;
+    config.nGates = nGates;
+    config.pulsesPerDwell = pulsesPerDwell;
+    config.wavelength = wavelength;
+    config.prt = prt;
+    config.nWorkers = 1;
+    config.workerThreadConfig = Pentek_xx821ServiceThread::DefaultConfig(-1);
+    config.correction = Pentek_xx821Unpack::UnitScale();
+    config.byteSwap = false;
+    return(config);
+}
+
+Pentek_xx821PulsePair::Pentek_xx821PulsePair(const Config & config,
+                                             MomentsHandler handler) :
+    _config(config),
+    _handler(handler),
+    _rangeStart(),
+    _r0(config.nGates, 0.0f),
+    _r1Re(config.nGates, 0.0f),
+    _r1Im(config.nGates, 0.0f),
+    _r2Re(config.nGates, 0.0f),
+    _r2Im(config.nGates, 0.0f),
+    _moments(),
+    _pulseInDwell(0),
+    _expectedSeq(0),
+    _firstBlock(true),
+    _warnedPartialPulse(false),
+    _dwellCount(0),
+    _discardedDwellCount(0),
+    _job(),
+    _workers()
+{
+    if (_config.nGates == 0 || _config.pulsesPerDwell < 3 ||
+            _config.nWorkers == 0 || ! (_config.wavelength > 0.0) ||
+            ! (_config.prt > 0.0)) {
+        std::ostringstream os;
+        os << "Bad pulse-pair configuration: " << _config.nGates <<
+              " gates, " << _config.pulsesPerDwell << " pulses/dwell, " <<
+              _config.nWorkers << " workers, wavelength " <<
+              _config.wavelength << " m, PRT " << _config.prt << " s";
+        throw ConstructError(os.str());
+    }
+
+    for (int h = 0; h < 3; h++) {
+        _histI[h].resize(_config.nGates);
+        _histQ[h].resize(_config.nGates);
+    }
+    _moments.power.resize(_config.nGates);
+    _moments.velocity.resize(_config.nGates);
+    _moments.width.resize(_config.nGates);
+
+    // Split the gates into one range per worker. With more workers than
+    // aligned ranges, the last workers get empty ranges.
+    uint32_t perWorker = (_config.nGates + _config.nWorkers - 1) /
+                         _config.nWorkers;
+    perWorker = (perWorker + GATE_ALIGNMENT - 1) / GATE_ALIGNMENT *
+                GATE_ALIGNMENT;
+    for (uint32_t w = 0; w < _config.nWorkers; w++) {
+        _rangeStart.push_back(std::min(w * perWorker, _config.nGates));
+    }
+    _rangeStart.push_back(_config.nGates);
+
+    _workers.reset(new Pentek_xx821WorkerPool(
+            "pulsepair", _config.nWorkers, _config.workerThreadConfig,
+            [this](uint32_t worker) { _runJob(worker); }));
+
+    DLOG << "Pulse-pair processing of " << _config.nGates << " gates x " <<
+            _config.pulsesPerDwell << " pulses/dwell on " <<
+            _config.nWorkers << " worker(s)";
+}
+
+Pentek_xx821PulsePair::~Pentek_xx821PulsePair() {
+    _workers.reset();
+}
+
+void
+Pentek_xx821PulsePair::_runJob(uint32_t worker) {
+    static const AccumulateFn accumulate = chooseAccumulate();
+
+    uint32_t g0 = _rangeStart[worker];
+    uint32_t g1 = _rangeStart[worker + 1];
+    if (g0 == g1) {
+        return;
+    }
+
+    const size_t pulseSamples = 2 * size_t(_config.nGates);
+    for (uint32_t p = 0; p < _job.nPulses; p++) {
+        // Convert this worker's gates of the pulse straight from the DMA
+        // buffer into the history planes, then accumulate against the
+        // previous two pulses
+        uint32_t pulse = _job.firstPulse + p;
+        uint32_t cur = pulse % 3;
+        const int16_t * iq = _job.iq + p * pulseSamples + 2 * g0;
+        Pentek_xx821Unpack::IqToPlanes(iq, &_histI[cur][g0], &_histQ[cur][g0],
+                                       g1 - g0, _config.correction,
+                                       _config.byteSwap);
+
+        uint32_t lag1 = (pulse + 2) % 3;
+        uint32_t lag2 = (pulse + 1) % 3;
+        AccumPlanes planes = {
+            _histI[cur].data(), _histQ[cur].data(),
+            _histI[lag1].data(), _histQ[lag1].data(),
+            _histI[lag2].data(), _histQ[lag2].data(),
+            _r0.data(), _r1Re.data(), _r1Im.data(), _r2Re.data(), _r2Im.data()
+        };
+        accumulate(planes, g0, g1, std::min(pulse + 1, 3u));
+    }
+
+    if (_job.finishDwell) {
+        _finishGates(g0, g1);
+    }
+}
+
+void
+Pentek_xx821PulsePair::_finishGates(uint32_t g0, uint32_t g1) {
+    const float n = _config.pulsesPerDwell;
+    const float velocityScale = -_config.wavelength / (4 * M_PI * _config.prt);
+    const float widthScale = _config.wavelength /
+                             (2 * M_PI * std::sqrt(6.0) * _config.prt);
+    for (uint32_t g = g0; g < g1; g++) {
+        float r1Re = _r1Re[g] / (n - 1);
+        float r1Im = _r1Im[g] / (n - 1);
+        float r1Mag = std::hypot(r1Re, r1Im);
+        float r2Mag = std::hypot(_r2Re[g], _r2Im[g]) / (n - 2);
+
+        _moments.power[g] = _r0[g] / n;
+        _moments.velocity[g] = velocityScale * std::atan2(r1Im, r1Re);
+        if (r2Mag > 0.0f) {
+            float lnRatio = std::log(r1Mag / r2Mag);
+            _moments.width[g] = widthScale * std::sqrt(std::max(lnRatio, 0.0f));
+        } else {
+            _moments.width[g] = std::numeric_limits<float>::quiet_NaN();
+        }
+
+        _r0[g] = 0.0f;
+        _r1Re[g] = 0.0f;
+        _r1Im[g] = 0.0f;
+        _r2Re[g] = 0.0f;
+        _r2Im[g] = 0.0f;
+    }
+}
+
+void
+Pentek_xx821PulsePair::_clearDwell() {
+    std::fill(_r0.begin(), _r0.end(), 0.0f);
+    std::fill(_r1Re.begin(), _r1Re.end(), 0.0f);
+    std::fill(_r1Im.begin(), _r1Im.end(), 0.0f);
+    std::fill(_r2Re.begin(), _r2Re.end(), 0.0f);
+    std::fill(_r2Im.begin(), _r2Im.end(), 0.0f);
+    _pulseInDwell = 0;
+}
+
+void
+Pentek_xx821PulsePair::reset() {
+    _clearDwell();
+    _firstBlock = true;
+}
+
+void
+Pentek_xx821PulsePair::processBlock(const Pentek_xx821Dn::RxBlock & block) {
+    // A dwell with missing pulses would give biased moments, so drop it
+    if (! _firstBlock && block.sequence != _expectedSeq) {
+        if (_pulseInDwell > 0) {
+            DEFERRABLE_WLOG("Discarding partial dwell of " << _pulseInDwell <<
+                            " pulses after block sequence gap at " <<
+                            block.sequence);
+            _discardedDwellCount++;
+            _clearDwell();
+        }
+    }
+    _firstBlock = false;
+    _expectedSeq = block.sequence + 1;
+
+    uint32_t pulseBytes = _config.nGates * 2 * sizeof(int16_t);
+    if (block.bytes % pulseBytes != 0 && ! _warnedPartialPulse) {
+        DEFERRABLE_WLOG("Block of " << block.bytes << " bytes holds a partial " <<
+                        pulseBytes << "-byte pulse, which is ignored");
+        _warnedPartialPulse = true;
+    }
+    processPulses(static_cast<const int16_t *>(block.data),
+                  block.bytes / pulseBytes, block.timetag);
+}
+
+void
+Pentek_xx821PulsePair::processPulses(const int16_t * iq, uint32_t nPulses,
+                                     uint64_t timetag) {
+    while (nPulses > 0) {
+        if (_pulseInDwell == 0) {
+            _moments.timetag = timetag;
+        }
+
+        // Run as many pulses as fit in the dwell in progress
+        uint32_t n = std::min(nPulses,
+                              _config.pulsesPerDwell - _pulseInDwell);
+        _job.iq = iq;
+        _job.nPulses = n;
+        _job.firstPulse = _pulseInDwell;
+        _job.finishDwell = (_pulseInDwell + n == _config.pulsesPerDwell);
+        _workers->runOnAll();
+
+        iq += size_t(n) * 2 * _config.nGates;
+        nPulses -= n;
+        _pulseInDwell += n;
+
+        if (_job.finishDwell) {
+            _moments.dwellIndex = _dwellCount;
+            _moments.nPulses = _config.pulsesPerDwell;
+            _pulseInDwell = 0;
+            _dwellCount++;
+            if (_handler) {
+                _handler(_moments);
+            }
+        }
+    }
+}
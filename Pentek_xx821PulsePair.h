@@ -0,0 +1,246 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821PulsePair.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821PULSEPAIR_H_
+#define PENTEK_XX821PULSEPAIR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Pentek_xx821Dn.h"
+#include "Pentek_xx821ServiceThread.h"
+#include "Pentek_xx821Unpack.h"
+#include "Pentek_xx821WorkerPool.h"
+
+/// @brief Streaming pulse-pair moment estimator for DDC output
+///
+/// Pulses of int16 I/Q gates are taken straight from the blocks of a
+/// Pentek_xx821Dn receive ring, so samples are read once, in place, before
+/// the block is released. For each gate the lag 0, 1 and 2 autocorrelations
+/// (R0, R1, R2) are accumulated across a dwell of a fixed number of pulses;
+/// when a dwell completes, its power, radial velocity and spectrum width are
+/// computed and handed to the moments handler before the next dwell starts.
+///
+/// The gates are split into contiguous ranges, one per worker. The thread
+/// calling processBlock() works the first range and worker service threads
+/// work the rest, all in step, one block (or dwell) at a time. Conversion
+/// uses Pentek_xx821Unpack, and the accumulation uses AVX2 when the CPU has
+/// it.
+///
+/// Moments are estimated as:
+/// - power = R0, the mean of |x|^2 in the units of the sample correction
+/// - velocity = -lambda / (4 pi PRT) * arg(R1), positive away from the radar
+/// - width = lambda / (2 pi sqrt(6) PRT) * sqrt(ln(|R1| / |R2|)), or NaN if
+///   R2 is zero
+///
+/// processBlock(), processPulses() and reset() must be called from only one
+/// thread at a time.
+class Pentek_xx821PulsePair {
+public:
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief Processing configuration
+    struct Config {
+        /// @brief Number of gates (I/Q pairs) per pulse
+        uint32_t nGates;
+        /// @brief Number of pulses per dwell, at least 3
+        uint32_t pulsesPerDwell;
+        /// @brief Radar wavelength, m
+        double wavelength;
+        /// @brief Pulse repetition time, s
+        double prt;
+        /// @brief Number of threads sharing the gates, including the thread
+        /// calling processBlock()
+        uint32_t nWorkers;
+        /// @brief Scheduling settings for the worker service threads
+        Pentek_xx821ServiceThread::Config workerThreadConfig;
+        /// @brief Gain and offset correction applied to the samples
+        Pentek_xx821Unpack::Correction correction;
+        /// @brief True if the samples are byte-swapped (big-endian)
+        bool byteSwap;
+    };
+
+    /// @brief Moments for one dwell
+    struct Moments {
+        /// @brief Index of the dwell since construction
+        uint64_t dwellIndex;
+        /// @brief Board timetag of the block holding the dwell's first pulse
+        uint64_t timetag;
+        /// @brief Number of pulses in the dwell
+        uint32_t nPulses;
+        /// @brief Power for each gate
+        std::vector<float> power;
+        /// @brief Radial velocity for each gate, m/s
+        std::vector<float> velocity;
+        /// @brief Spectrum width for each gate, m/s
+        std::vector<float> width;
+    };
+
+    /// @brief Function called with the moments of each completed dwell, on
+    /// the thread calling processBlock(). The Moments object is reused for
+    /// the next dwell.
+    typedef std::function<void(const Moments &)> MomentsHandler;
+
+    /// @brief Return a default configuration: one worker, unit-scale
+    /// samples, and worker service threads with default settings
+    /// @param nGates the number of gates per pulse
+    /// @param pulsesPerDwell the number of pulses per dwell
+    /// @param wavelength the radar wavelength, m
+    /// @param prt the pulse repetition time, s
+    /// @return a default configuration
+    static Config DefaultConfig(uint32_t nGates, uint32_t pulsesPerDwell,
+                                double wavelength, double prt);
+
+    /// @brief Constructor. Worker service threads are started here.
+    /// @param config the processing configuration
+    /// @param handler function called with the moments of each dwell
+    /// @throws ConstructError if the configuration is unusable
+    Pentek_xx821PulsePair(const Config & config, MomentsHandler handler);
+
+    /// @brief Destructor. Stops the worker threads.
+    virtual ~Pentek_xx821PulsePair();
+
+    /// @brief Accumulate the pulses in a block borrowed from a DDC receive
+    /// ring. The block should hold a whole number of pulses; a trailing
+    /// partial pulse is ignored. A gap in the block sequence discards the
+    /// dwell in progress. The block may be released as soon as this
+    /// returns.
+    /// @param block the block
+    void processBlock(const Pentek_xx821Dn::RxBlock & block);
+
+    /// @brief Accumulate consecutive pulses
+    /// @param iq the I/Q samples, nGates pairs per pulse
+    /// @param nPulses the number of pulses
+    /// @param timetag board timetag of the first pulse
+    void processPulses(const int16_t * iq, uint32_t nPulses,
+                       uint64_t timetag);
+
+    /// @brief Discard the dwell in progress and forget the expected block
+    /// sequence, e.g., after restarting the DDC channel
+    void reset();
+
+    /// @brief Return the processing configuration
+    /// @return the processing configuration
+    const Config & config() const { return(_config); }
+
+    /// @brief Return the number of dwells completed
+    /// @return the number of dwells completed
+    uint64_t dwellCount() const { return(_dwellCount); }
+
+    /// @brief Return the number of partial dwells discarded because of
+    /// sequence gaps
+    /// @return the number of partial dwells discarded
+    uint64_t discardedDwellCount() const { return(_discardedDwellCount); }
+
+private:
+    /// @brief Work for all workers: a run of pulses within one dwell
+    struct Job {
+        /// @brief I/Q samples of the first pulse
+        const int16_t * iq;
+        /// @brief Number of pulses
+        uint32_t nPulses;
+        /// @brief Index within the dwell of the first pulse
+        uint32_t firstPulse;
+        /// @brief True if the run completes the dwell
+        bool finishDwell;
+    };
+
+    /// @brief Run the current job on the given worker's gate range
+    /// @param worker the worker index
+    void _runJob(uint32_t worker);
+
+    /// @brief Clear the accumulators of all gates, discarding the dwell in
+    /// progress
+    void _clearDwell();
+
+    /// @brief Compute moments for a range of gates from the accumulated
+    /// autocorrelations, and clear the accumulators
+    /// @param g0 the first gate
+    /// @param g1 one past the last gate
+    void _finishGates(uint32_t g0, uint32_t g1);
+
+    /// @brief Processing configuration
+    Config _config;
+
+    /// @brief Moments handler
+    MomentsHandler _handler;
+
+    /// @brief First gate of each worker's range, plus nGates at the end
+    std::vector<uint32_t> _rangeStart;
+
+    /// @brief The last three pulses (converted), as I and Q planes indexed
+    /// by pulse index modulo 3
+    std::vector<float> _histI[3];
+    std::vector<float> _histQ[3];
+
+    /// @brief Accumulated autocorrelations for the dwell in progress
+    std::vector<float> _r0;
+    std::vector<float> _r1Re;
+    std::vector<float> _r1Im;
+    std::vector<float> _r2Re;
+    std::vector<float> _r2Im;
+
+    /// @brief Moments of the latest dwell
+    Moments _moments;
+
+    /// @brief Index within the dwell of the next pulse
+    uint32_t _pulseInDwell;
+
+    /// @brief Sequence number expected for the next block
+    uint32_t _expectedSeq;
+
+    /// @brief Is the next block the first since construction or reset()?
+    bool _firstBlock;
+
+    /// @brief Has a block holding a partial pulse been reported?
+    bool _warnedPartialPulse;
+
+    /// @brief Number of dwells completed
+    std::atomic<uint64_t> _dwellCount;
+
+    /// @brief Number of partial dwells discarded
+    std::atomic<uint64_t> _discardedDwellCount;
+
+    /// @brief The current job
+    Job _job;
+
+    /// @brief The workers, which run _runJob()
+    std::unique_ptr<Pentek_xx821WorkerPool> _workers;
+};
+
+#endif /* PENTEK_XX821PULSEPAIR_H_ */
@@ -0,0 +1,144 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821RegCache.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+
+#include "Pentek_xx821RegCache.h"
+
+// Return the [first, last] byte address range for a register block, clipped
+// at the top of the 32-bit address space
+static std::pair<uint32_t, uint32_t>
+byteRange(uint32_t firstAddr, uint32_t nBytes) {
+    uint64_t last = uint64_t(firstAddr) + std::max(nBytes, 1u) - 1;
+    return(std::make_pair(firstAddr, uint32_t(std::min<uint64_t>(last, UINT32_MAX))));
+}
+
+static bool
+inRanges(const std::vector<std::pair<uint32_t, uint32_t> > & ranges,
+         uint32_t regaddr) {
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (regaddr >= ranges[i].first && regaddr <= ranges[i].second) {
+            return(true);
+        }
+    }
+    return(false);
+}
+
+Pentek_xx821RegCache::Pentek_xx821RegCache() :
+    _cacheableRanges(),
+    _uncacheableRanges(),
+    _entries(),
+    _dirtyWords() {
+}
+
+void
+Pentek_xx821RegCache::declareCacheable(uint32_t firstAddr, uint32_t nBytes) {
+    _cacheableRanges.push_back(byteRange(firstAddr, nBytes));
+}
+
+void
+Pentek_xx821RegCache::declareUncacheable(uint32_t firstAddr, uint32_t nBytes) {
+    _uncacheableRanges.push_back(byteRange(firstAddr, nBytes));
+    _invalidateRange(firstAddr, nBytes);
+}
+
+bool
+Pentek_xx821RegCache::isCacheable(uint32_t regaddr) const {
+    return(inRanges(_cacheableRanges, regaddr) &&
+           ! inRanges(_uncacheableRanges, regaddr));
+}
+
+bool
+Pentek_xx821RegCache::lookup(uint32_t regaddr, uint32_t & val) const {
+    std::unordered_map<uint32_t, Entry>::const_iterator it =
+            _entries.find(regaddr / 4);
+    if (it == _entries.end()) {
+        return(false);
+    }
+    val = it->second.value;
+    return(true);
+}
+
+void
+Pentek_xx821RegCache::fill(uint32_t regaddr, uint32_t val) {
+    Entry & entry = _entries[regaddr / 4];
+    entry.value = val;
+    // If the entry was dirty, it stays in _dirtyWords, but takeDirty() will
+    // skip it since it's no longer marked dirty.
+    entry.dirty = false;
+}
+
+void
+Pentek_xx821RegCache::store(uint32_t regaddr, uint32_t val) {
+    Entry & entry = _entries[regaddr / 4];
+    entry.value = val;
+    if (! entry.dirty) {
+        entry.dirty = true;
+        _dirtyWords.push_back(regaddr / 4);
+    }
+}
+
+void
+Pentek_xx821RegCache::takeDirty(std::vector<std::pair<uint32_t, uint32_t> > & writes) {
+    writes.clear();
+    std::sort(_dirtyWords.begin(), _dirtyWords.end());
+    for (size_t i = 0; i < _dirtyWords.size(); i++) {
+        std::unordered_map<uint32_t, Entry>::iterator it =
+                _entries.find(_dirtyWords[i]);
+        if (it == _entries.end() || ! it->second.dirty) {
+            continue;
+        }
+        it->second.dirty = false;
+        writes.push_back(std::make_pair(4 * it->first, it->second.value));
+    }
+    _dirtyWords.clear();
+}
+
+void
+Pentek_xx821RegCache::invalidate() {
+    _entries.clear();
+    _dirtyWords.clear();
+}
+
+void
+Pentek_xx821RegCache::_invalidateRange(uint32_t firstAddr, uint32_t nBytes) {
+    std::pair<uint32_t, uint32_t> range = byteRange(firstAddr, nBytes);
+    std::unordered_map<uint32_t, Entry>::iterator it = _entries.begin();
+    while (it != _entries.end()) {
+        // Any dirty value is dropped along with the entry; takeDirty() skips
+        // words in _dirtyWords which no longer have an entry.
+        uint32_t regaddr = 4 * it->first;
+        if (regaddr >= range.first && regaddr <= range.second) {
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
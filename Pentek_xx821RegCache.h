@@ -0,0 +1,128 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821RegCache.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821REGCACHE_H_
+#define PENTEK_XX821REGCACHE_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief Host-side shadow copy of selected AXI LITE registers of a
+/// Pentek_xx821 board
+///
+/// Only registers which have been declared cacheable are shadowed. Registers
+/// whose contents can change underneath the host (status registers,
+/// counters, etc.) must be left out, or carved out of a cacheable range
+/// using declareUncacheable(), so that reads of them always go to the
+/// hardware.
+///
+/// Each shadowed register is either clean (the shadow matches what is on
+/// the board) or dirty (the shadow holds a value which has not yet been
+/// written to the board).
+///
+/// This class does no hardware access and no locking of its own; the
+/// owning Pentek_xx821 takes care of both.
+class Pentek_xx821RegCache {
+public:
+    Pentek_xx821RegCache();
+
+    /// @brief Declare a range of registers as cacheable
+    /// @param firstAddr address of the first register in the range
+    /// @param nBytes size of the range, in bytes
+    void declareCacheable(uint32_t firstAddr, uint32_t nBytes);
+
+    /// @brief Declare a range of registers as uncacheable, overriding any
+    /// cacheable range which contains them
+    /// @param firstAddr address of the first register in the range
+    /// @param nBytes size of the range, in bytes
+    void declareUncacheable(uint32_t firstAddr, uint32_t nBytes);
+
+    /// @brief Return true iff the register at the given address is cacheable
+    /// @param regaddr the register address
+    /// @return true iff the register at the given address is cacheable
+    bool isCacheable(uint32_t regaddr) const;
+
+    /// @brief Get the shadow value for a register, if there is one
+    /// @param regaddr the register address
+    /// @param[out] val the shadow value, if one is available
+    /// @return true iff a shadow value was available
+    bool lookup(uint32_t regaddr, uint32_t & val) const;
+
+    /// @brief Record a value known to match the register on the board (e.g.,
+    /// just read from or written to the hardware). Any pending dirty value
+    /// for the register is discarded.
+    /// @param regaddr the register address, which must be cacheable
+    /// @param val the register value
+    void fill(uint32_t regaddr, uint32_t val);
+
+    /// @brief Record a value which has not yet been written to the board
+    /// @param regaddr the register address, which must be cacheable
+    /// @param val the register value
+    void store(uint32_t regaddr, uint32_t val);
+
+    /// @brief Return true iff any shadowed register is dirty
+    /// @return true iff any shadowed register is dirty
+    bool hasDirty() const { return(! _dirtyWords.empty()); }
+
+    /// @brief Move the dirty registers into a list of (address, value) pairs
+    /// in ascending address order and mark them clean
+    /// @param[out] writes the list to fill; it is cleared first
+    void takeDirty(std::vector<std::pair<uint32_t, uint32_t> > & writes);
+
+    /// @brief Forget all shadow values, including any dirty ones. Register
+    /// cacheability declarations are retained.
+    void invalidate();
+
+private:
+    /// @brief Shadow state for one register
+    struct Entry {
+        uint32_t value;
+        bool dirty;
+    };
+
+    /// @brief Forget shadow values for registers in the given range
+    void _invalidateRange(uint32_t firstAddr, uint32_t nBytes);
+
+    /// @brief Cacheable [first, last] byte address ranges
+    std::vector<std::pair<uint32_t, uint32_t> > _cacheableRanges;
+
+    /// @brief Uncacheable [first, last] byte address ranges
+    std::vector<std::pair<uint32_t, uint32_t> > _uncacheableRanges;
+
+    /// @brief Shadow entries, keyed by 32-bit word index
+    std::unordered_map<uint32_t, Entry> _entries;
+
+    /// @brief Word indices of dirty entries, in the order they became dirty
+    std::vector<uint32_t> _dirtyWords;
+};
+
+#endif /* PENTEK_XX821REGCACHE_H_ */
@@ -0,0 +1,133 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Registers.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821REGISTERS_H_
+#define PENTEK_XX821REGISTERS_H_
+
+#include <cstdint>
+
+/// @brief Access mode of an AXI LITE register
+enum class Pentek_xx821RegAccess {
+    RO,     ///< read-only
+    WO,     ///< write-only
+    RW      ///< read-write
+};
+
+/// @brief Compile-time description of one AXI LITE register
+///
+/// Registers are declared as types, e.g.
+///
+///     typedef Pentek_xx821Reg<0x8000, Pentek_xx821RegAccess::RW> DdcCtrlReg;
+///
+/// and accessed with Pentek_xx821::readRegister_<DdcCtrlReg>() and
+/// Pentek_xx821::writeRegister_<DdcCtrlReg>(). Since the address is a
+/// compile-time constant, the accessors reduce to a single volatile load or
+/// store, and misuse such as writing a read-only register is caught by the
+/// compiler.
+/// @tparam ADDR the register address, relative to the board info register
+/// base (the same addressing used by Pentek_xx821::writeLiteRegister_())
+/// @tparam ACCESS the register's access mode
+template <uint32_t ADDR, Pentek_xx821RegAccess ACCESS>
+struct Pentek_xx821Reg {
+    static_assert(ADDR % 4 == 0, "register address must be 4-byte aligned");
+
+    /// @brief The register address
+    static constexpr uint32_t addr = ADDR;
+
+    /// @brief Can the register be read?
+    static constexpr bool readable = (ACCESS != Pentek_xx821RegAccess::WO);
+
+    /// @brief Can the register be written?
+    static constexpr bool writable = (ACCESS != Pentek_xx821RegAccess::RO);
+};
+
+/// @brief Compile-time description of a bit field within a register
+/// @tparam REG the Pentek_xx821Reg type of the containing register
+/// @tparam SHIFT the bit number of the field's least significant bit
+/// @tparam WIDTH the field width in bits
+template <class REG, unsigned SHIFT, unsigned WIDTH>
+struct Pentek_xx821Field {
+    static_assert(WIDTH > 0 && SHIFT + WIDTH <= 32,
+                  "bit field does not fit in a 32-bit register");
+
+    /// @brief The containing register type
+    typedef REG Register;
+
+    /// @brief Bit number of the field's least significant bit
+    static constexpr unsigned shift = SHIFT;
+
+    /// @brief Mask of the field's bits within the register
+    static constexpr uint32_t mask =
+            (WIDTH == 32 ? 0xffffffffUL : ((1UL << WIDTH) - 1)) << SHIFT;
+
+    /// @brief Return the register bits for a field value
+    /// @param val the field value, unshifted
+    /// @return the field value shifted into position and masked
+    static constexpr uint32_t Encode(uint32_t val) {
+        return((val << SHIFT) & mask);
+    }
+
+    /// @brief Extract the field value from a register value
+    /// @param raw the register value
+    /// @return the field value, shifted down to bit 0
+    static constexpr uint32_t Decode(uint32_t raw) {
+        return((raw & mask) >> SHIFT);
+    }
+
+    /// @brief Replace the field within a register value
+    /// @param raw the register value
+    /// @param val the new field value, unshifted
+    /// @return the register value with the field replaced
+    static constexpr uint32_t Insert(uint32_t raw, uint32_t val) {
+        return((raw & ~mask) | Encode(val));
+    }
+
+    /// @brief Compile-time check that a constant field value fits
+    /// @tparam VAL the field value
+    template <uint32_t VAL>
+    struct Value {
+        static_assert(VAL <= (mask >> SHIFT), "value does not fit in field");
+        /// @brief The encoded register bits for VAL
+        static constexpr uint32_t bits = (VAL << SHIFT) & mask;
+    };
+};
+
+template <uint32_t ADDR, Pentek_xx821RegAccess ACCESS>
+constexpr uint32_t Pentek_xx821Reg<ADDR, ACCESS>::addr;
+template <uint32_t ADDR, Pentek_xx821RegAccess ACCESS>
+constexpr bool Pentek_xx821Reg<ADDR, ACCESS>::readable;
+template <uint32_t ADDR, Pentek_xx821RegAccess ACCESS>
+constexpr bool Pentek_xx821Reg<ADDR, ACCESS>::writable;
+template <class REG, unsigned SHIFT, unsigned WIDTH>
+constexpr unsigned Pentek_xx821Field<REG, SHIFT, WIDTH>::shift;
+template <class REG, unsigned SHIFT, unsigned WIDTH>
+constexpr uint32_t Pentek_xx821Field<REG, SHIFT, WIDTH>::mask;
+
+#endif /* PENTEK_XX821REGISTERS_H_ */
@@ -0,0 +1,163 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821ServiceThread.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+#include "Pentek_xx821ServiceThread.h"
+
+LOGGING("Pentek_xx821ServiceThread")
+
+// Stack prefaulted by threads which lock memory
+static const size_t PREFAULT_STACK_BYTES = 256 * 1024;
+
+Pentek_xx821ServiceThread::Config
+Pentek_xx821ServiceThread::DefaultConfig(int numaNode) {
+    Config config;
+    config.cpus = NumaNodeCpus(numaNode);
+    config.fifoPriority = 0;
+    config.lockMemory = false;
+    config.deferLogging = true;
+    return(config);
+}
+
+std::vector<int>
+Pentek_xx821ServiceThread::NumaNodeCpus(int numaNode) {
+    std::vector<int> cpus;
+    if (numaNode < 0) {
+        return(cpus);
+    }
+    // The list looks like "0-7,16-23"
+    std::ostringstream path;
+    path << "/sys/devices/system/node/node" << numaNode << "/cpulist";
+    std::ifstream cpulist(path.str().c_str());
+    std::string range;
+    while (std::getline(cpulist, range, ',')) {
+        int first, last;
+        int nParsed = sscanf(range.c_str(), "%d-%d", &first, &last);
+        if (nParsed == 1) {
+            last = first;
+        } else if (nParsed != 2) {
+            continue;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return(cpus);
+}
+
+Pentek_xx821ServiceThread::Pentek_xx821ServiceThread(const std::string & name,
+                                                     const Config & config,
+                                                     Body body) :
+    _name(name),
+    _config(config),
+    _body(body),
+    _stopRequested(false),
+    _thread()
+{
+    // Start the log drain thread now, rather than on the service thread's
+    // first deferred message
+    if (_config.deferLogging) {
+        Pentek_xx821DeferredLog::StartDrain();
+    }
+    _thread = boost::thread(&Pentek_xx821ServiceThread::_run, this);
+}
+
+Pentek_xx821ServiceThread::~Pentek_xx821ServiceThread() {
+    stop();
+}
+
+void
+Pentek_xx821ServiceThread::stop() {
+    _stopRequested = true;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void
+Pentek_xx821ServiceThread::_run() {
+    _applyConfig();
+    _body(*this);
+    Pentek_xx821DeferredLog::SetDeferring(false);
+}
+
+void
+Pentek_xx821ServiceThread::_applyConfig() {
+    pthread_setname_np(pthread_self(), _name.substr(0, 15).c_str());
+
+    if (! _config.cpus.empty()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu : _config.cpus) {
+            CPU_SET(cpu, &cpus);
+        }
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err != 0) {
+            WLOG << "Service thread " << _name << ": cannot set CPU affinity: " <<
+                    strerror(err);
+        }
+    }
+
+    if (_config.fifoPriority > 0) {
+        sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = _config.fifoPriority;
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            WLOG << "Service thread " << _name << ": cannot use SCHED_FIFO " <<
+                    "priority " << _config.fifoPriority << ": " << strerror(err);
+        }
+    }
+
+    if (_config.lockMemory) {
+        // Process-wide: this locks the memory of every thread in the process
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            WLOG << "Service thread " << _name << ": cannot lock memory: " <<
+                    strerror(errno);
+        }
+        // Touch the stack now, so the service loop never page faults on it
+        volatile char stack[PREFAULT_STACK_BYTES];
+        for (size_t i = 0; i < sizeof(stack); i += 4096) {
+            stack[i] = 0;
+        }
+    }
+
+    DLOG << "Service thread " << _name << " started";
+    Pentek_xx821DeferredLog::SetDeferring(_config.deferLogging);
+}
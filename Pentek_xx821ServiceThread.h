@@ -0,0 +1,145 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821ServiceThread.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821SERVICETHREAD_H_
+#define PENTEK_XX821SERVICETHREAD_H_
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+/// @brief A thread servicing a board, with its CPU affinity, scheduling,
+/// memory locking and logging set up from a Config before its body runs
+///
+/// Drops in DMA service loops correlate with the thread being migrated
+/// across cores or preempted, so service threads are normally pinned to
+/// cores near the card and run SCHED_FIFO. A service thread can also defer
+/// the library's log messages to a background drain thread (see
+/// Pentek_xx821DeferredLog), so that it never blocks on log output.
+///
+/// Settings which cannot be applied (e.g., SCHED_FIFO without the needed
+/// privilege) are logged as warnings and otherwise ignored.
+class Pentek_xx821ServiceThread {
+public:
+    /// @brief Scheduling and isolation settings for a service thread
+    struct Config {
+        /// @brief CPUs the thread may run on; empty to leave the affinity
+        /// alone
+        std::vector<int> cpus;
+        /// @brief SCHED_FIFO priority (1-99), or 0 to leave the scheduling
+        /// policy alone
+        int fifoPriority;
+        /// @brief Lock all of the process's memory (current and future)
+        /// into RAM, and prefault the thread's stack
+        ///
+        /// This calls mlockall(MCL_CURRENT | MCL_FUTURE), which affects the
+        /// whole process, not just this thread or board: every later
+        /// allocation anywhere in the process is locked too. It is off by
+        /// default, and should only be turned on by an application which
+        /// owns the process and has sized its memory use accordingly.
+        bool lockMemory;
+        /// @brief Defer the library's log messages from this thread to the
+        /// background drain thread
+        bool deferLogging;
+    };
+
+    /// @brief Body of a service thread. It should return soon after
+    /// stopRequested() becomes true.
+    typedef std::function<void(Pentek_xx821ServiceThread &)> Body;
+
+    /// @brief Return the default configuration for threads servicing a
+    /// board on the given NUMA node: the node's CPUs, no SCHED_FIFO, memory
+    /// not locked, and logging deferred
+    /// @param numaNode the NUMA node, or -1 if unknown (the CPU set is then
+    /// left empty)
+    /// @return the default configuration
+    static Config DefaultConfig(int numaNode);
+
+    /// @brief Return the CPUs of a NUMA node
+    /// @param numaNode the NUMA node
+    /// @return the CPUs of the node, or an empty list if they can't be
+    /// determined
+    static std::vector<int> NumaNodeCpus(int numaNode);
+
+    /// @brief Start a service thread
+    /// @param name the thread name (truncated to 15 characters for the OS)
+    /// @param config scheduling and isolation settings
+    /// @param body the thread body
+    Pentek_xx821ServiceThread(const std::string & name, const Config & config,
+                              Body body);
+
+    /// @brief Destructor. Stops the thread and waits for it to exit.
+    virtual ~Pentek_xx821ServiceThread();
+
+    /// @brief Ask the thread body to return
+    void requestStop() { _stopRequested = true; }
+
+    /// @brief Return true if the thread body has been asked to return
+    /// @return true if the thread body has been asked to return
+    bool stopRequested() const { return(_stopRequested); }
+
+    /// @brief Ask the thread body to return, and wait for it to exit
+    void stop();
+
+    /// @brief Return the thread's name
+    /// @return the thread's name
+    const std::string & name() const { return(_name); }
+
+    /// @brief Return the thread's configuration
+    /// @return the thread's configuration
+    const Config & config() const { return(_config); }
+
+private:
+    /// @brief Apply _config to the calling thread, then run the body
+    void _run();
+
+    /// @brief Apply _config to the calling thread
+    void _applyConfig();
+
+    /// @brief Thread name
+    std::string _name;
+
+    /// @brief Scheduling and isolation settings
+    Config _config;
+
+    /// @brief Thread body
+    Body _body;
+
+    /// @brief Set when the thread body should return
+    std::atomic<bool> _stopRequested;
+
+    /// @brief The thread
+    boost::thread _thread;
+};
+
+#endif /* PENTEK_XX821SERVICETHREAD_H_ */
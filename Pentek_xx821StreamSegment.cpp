@@ -0,0 +1,84 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821StreamSegment.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "Pentek_xx821StreamSegment.h"
+
+const uint32_t Pentek_xx821StreamSegment::PAGE_BYTES;
+const uint32_t Pentek_xx821StreamSegment::HUGEPAGE_BYTES;
+const char Pentek_xx821StreamSegment::DEFAULT_HUGETLBFS_DIR[] =
+        "/dev/hugepages";
+const uint32_t Pentek_xx821StreamSegment::VERSION;
+const char Pentek_xx821StreamSegment::MAGIC[8] = {
+    'P', 'X', 'X', '8', '2', '1', 'S', 'S'
+};
+
+static_assert(sizeof(Pentek_xx821StreamSegment::Header) <=
+              Pentek_xx821StreamSegment::PAGE_BYTES,
+              "Pentek_xx821StreamSegment::Header must fit in one page");
+static_assert(sizeof(Pentek_xx821StreamSegment::SlotInfo) == 64,
+              "Pentek_xx821StreamSegment::SlotInfo must be one cache line");
+
+std::string
+Pentek_xx821StreamSegment::Path(const std::string & shmName) {
+    const char * dir = getenv("PENTEK_XX821_HUGETLBFS");
+    size_t start = shmName.find_first_not_of('/');
+    std::string name =
+            (start == std::string::npos) ? "" : shmName.substr(start);
+    return(std::string(dir ? dir : DEFAULT_HUGETLBFS_DIR) + "/" + name);
+}
+
+uint32_t
+Pentek_xx821StreamSegment::BufferBytes(uint32_t bufferBytes) {
+    uint32_t bytes = PAGE_BYTES;
+    while (bytes < bufferBytes && bytes < HUGEPAGE_BYTES) {
+        bytes *= 2;
+    }
+    return(bytes < bufferBytes ? 0 : bytes);
+}
+
+uint64_t
+Pentek_xx821StreamSegment::Layout(Header & header, uint32_t nBuffers,
+                                  uint32_t bufferBytes) {
+    const uint64_t page = PAGE_BYTES;
+    const uint64_t hugePage = HUGEPAGE_BYTES;
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.nBuffers = nBuffers;
+    header.bufferBytes = bufferBytes;
+    header.slotTableOffset = page;
+    uint64_t slotTableBytes = uint64_t(nBuffers) * sizeof(SlotInfo);
+    header.dataOffset = (header.slotTableOffset + slotTableBytes +
+                         hugePage - 1) / hugePage * hugePage;
+    uint64_t bytes = header.dataOffset + uint64_t(nBuffers) * bufferBytes;
+    return((bytes + hugePage - 1) / hugePage * hugePage);
+}
@@ -0,0 +1,155 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821StreamSegment.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821STREAMSEGMENT_H_
+#define PENTEK_XX821STREAMSEGMENT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// @brief Layout of the named shared memory segment through which a
+/// Pentek_xx821Publisher shares a DDC channel's receive ring with
+/// Pentek_xx821Subscriber readers in other processes
+///
+/// The segment holds:
+/// - a Header, at offset 0
+/// - one SlotInfo per ring slot, at slotTableOffset
+/// - the ring's DMA buffers, bufferBytes each, at dataOffset
+///
+/// The board writes the DMA buffers directly, and each is given one bus
+/// address, so each must be physically contiguous. The segment is therefore
+/// a file in a hugetlbfs mount (see Path()) rather than a POSIX shared
+/// memory object, the data area starts on a hugepage boundary, and
+/// bufferBytes is a power of two no larger than a hugepage, so no buffer
+/// crosses a hugepage boundary.
+///
+/// Blocks are numbered in the order published, from zero at each start of
+/// the publisher; block n always lives in ring slot n % nBuffers. The
+/// publisher keeps the most recent readableDepth blocks away from the
+/// board, so they stay intact for readers. Each slot's generation tells
+/// readers which block the slot holds: it is Generation(n) while the slot
+/// holds block n, and odd while the board owns the slot.
+class Pentek_xx821StreamSegment {
+public:
+    /// @brief Alignment of the slot table
+    static const uint32_t PAGE_BYTES = 4096;
+
+    /// @brief Size of the hugepages backing the segment, and alignment of
+    /// the data area
+    static const uint32_t HUGEPAGE_BYTES = 2 * 1024 * 1024;
+
+    /// @brief hugetlbfs mount holding the segments, unless overridden by
+    /// the PENTEK_XX821_HUGETLBFS environment variable
+    static const char DEFAULT_HUGETLBFS_DIR[];
+
+    /// @brief Current segment format version
+    static const uint32_t VERSION = 1;
+
+    /// @brief Magic number at the start of the header, "PXX821SS"
+    static const char MAGIC[8];
+
+    /// @brief Segment header
+    struct Header {
+        /// @brief MAGIC
+        char magic[8];
+        /// @brief VERSION
+        uint32_t version;
+        /// @brief Process ID of the publisher
+        int32_t pid;
+        /// @brief Board number
+        uint32_t boardNum;
+        /// @brief DDC channel number
+        uint32_t chanId;
+        /// @brief Number of ring slots
+        uint32_t nBuffers;
+        /// @brief Size of each DMA buffer, bytes
+        uint32_t bufferBytes;
+        /// @brief Number of most recent blocks kept readable
+        uint32_t readableDepth;
+        uint32_t reserved;
+        /// @brief Offset of the slot table
+        uint64_t slotTableOffset;
+        /// @brief Offset of the first DMA buffer
+        uint64_t dataOffset;
+        /// @brief Incremented each time the publisher starts, which
+        /// restarts block numbering
+        std::atomic<uint32_t> startCount;
+        /// @brief Nonzero while the publisher is running
+        std::atomic<uint32_t> publishing;
+        /// @brief Number of blocks published since the publisher started
+        std::atomic<uint64_t> head;
+    };
+
+    /// @brief Per-slot block information, one cache line each
+    struct SlotInfo {
+        /// @brief Generation(n) while the slot holds block n; odd while the
+        /// board owns the slot
+        std::atomic<uint64_t> generation;
+        /// @brief Board timetag of the block's first sample
+        uint64_t timetag;
+        /// @brief Board sequence number of the block
+        uint32_t boardSequence;
+        /// @brief Number of valid bytes in the block
+        uint32_t bytes;
+        char pad[40];
+    };
+
+    /// @brief Return the slot generation value meaning "holds block n"
+    /// @param n the block number
+    /// @return the generation value
+    static uint64_t Generation(uint64_t n) { return(2 * (n + 1)); }
+
+    /// @brief Return the path of the file holding a segment: the segment
+    /// name (without any leading '/') in the hugetlbfs mount given by
+    /// PENTEK_XX821_HUGETLBFS, or DEFAULT_HUGETLBFS_DIR
+    /// @param shmName the segment name, e.g., "/pentek0_ddc0"
+    /// @return the path of the file holding the segment
+    static std::string Path(const std::string & shmName);
+
+    /// @brief Return the DMA buffer size used in a segment for a requested
+    /// size: the next power of two, at least PAGE_BYTES
+    /// @param bufferBytes the requested buffer size, bytes
+    /// @return the buffer size, or 0 if it would be larger than
+    /// HUGEPAGE_BYTES
+    static uint32_t BufferBytes(uint32_t bufferBytes);
+
+    /// @brief Fill in a header and return the total segment size for the
+    /// given ring, a multiple of HUGEPAGE_BYTES
+    /// @param[out] header the header to fill in
+    /// @param nBuffers the number of ring slots
+    /// @param bufferBytes the size of each DMA buffer, bytes, as returned
+    /// by BufferBytes()
+    /// @return the total segment size, bytes
+    static uint64_t Layout(Header & header, uint32_t nBuffers,
+                           uint32_t bufferBytes);
+};
+
+#endif /* PENTEK_XX821STREAMSEGMENT_H_ */
@@ -0,0 +1,164 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Subscriber.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Pentek_xx821Telemetry.h"
+
+#include "Pentek_xx821Subscriber.h"
+
+typedef Pentek_xx821StreamSegment Segment;
+
+/// @brief Sleep between checks for a new block, microseconds
+static const useconds_t POLL_SLEEP_US = 50;
+
+Pentek_xx821Subscriber::Pentek_xx821Subscriber(const std::string & shmName) :
+    _shmName(shmName),
+    _shmBase(MAP_FAILED),
+    _shmBytes(0),
+    _header(NULL),
+    _slots(NULL),
+    _data(NULL),
+    _startCount(0),
+    _nextBlock(0),
+    _missedCount(0)
+{
+    int fd = open(Segment::Path(shmName).c_str(), O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0) {
+        _shmBytes = st.st_size;
+        _shmBase = mmap(NULL, _shmBytes, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    int err = errno;
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (_shmBase == MAP_FAILED) {
+        std::ostringstream os;
+        os << "Cannot map shared memory segment " << shmName << ": " <<
+              strerror(err);
+        throw OpenError(os.str());
+    }
+
+    // Make sure the layout described by the header fits in the segment
+    _header = static_cast<const Segment::Header *>(_shmBase);
+    bool valid = _shmBytes >= sizeof(Segment::Header) &&
+            memcmp(_header->magic, Segment::MAGIC,
+                   sizeof(_header->magic)) == 0 &&
+            _header->version == Segment::VERSION &&
+            _header->dataOffset +
+                uint64_t(_header->nBuffers) * _header->bufferBytes <= _shmBytes;
+    if (! valid) {
+        munmap(const_cast<void *>(_shmBase), _shmBytes);
+        std::ostringstream os;
+        os << shmName << " is not a version " << Segment::VERSION <<
+              " Pentek_xx821Publisher segment";
+        throw OpenError(os.str());
+    }
+    _slots = reinterpret_cast<const Segment::SlotInfo *>(
+            static_cast<const char *>(_shmBase) + _header->slotTableOffset);
+    _data = static_cast<const char *>(_shmBase) + _header->dataOffset;
+
+    _startCount = _header->startCount.load(std::memory_order_acquire);
+    _nextBlock = _header->head.load(std::memory_order_acquire);
+}
+
+Pentek_xx821Subscriber::~Pentek_xx821Subscriber() {
+    munmap(const_cast<void *>(_shmBase), _shmBytes);
+}
+
+bool
+Pentek_xx821Subscriber::next(BlockView & view, uint32_t timeoutMs) {
+    const uint64_t depth = _header->readableDepth;
+    uint64_t deadline = Pentek_xx821Telemetry::Now() +
+                        uint64_t(timeoutMs) * 1000000;
+    while (true) {
+        // Block numbering restarts when the publisher does
+        uint32_t startCount =
+                _header->startCount.load(std::memory_order_acquire);
+        if (startCount != _startCount) {
+            _startCount = startCount;
+            _nextBlock = 0;
+        }
+
+        uint64_t head = _header->head.load(std::memory_order_acquire);
+        if (_nextBlock < head) {
+            // Skip blocks which have already left the readable window
+            uint64_t oldest = (head > depth) ? head - depth : 0;
+            if (_nextBlock < oldest) {
+                _missedCount += oldest - _nextBlock;
+                _nextBlock = oldest;
+            }
+
+            // Read the slot's metadata, and keep it only if the slot still
+            // held the block afterward
+            const Segment::SlotInfo & info =
+                    _slots[_nextBlock % _header->nBuffers];
+            uint64_t gen = info.generation.load(std::memory_order_acquire);
+            view.number = _nextBlock;
+            view.data = _data + (_nextBlock % _header->nBuffers) *
+                                _header->bufferBytes;
+            view.bytes = info.bytes;
+            view.timetag = info.timetag;
+            view.boardSequence = info.boardSequence;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            bool valid = gen == Segment::Generation(_nextBlock) &&
+                    info.generation.load(std::memory_order_relaxed) == gen;
+            if (valid) {
+                _nextBlock++;
+                return(true);
+            }
+            // The block left the window while we looked
+            _missedCount++;
+            _nextBlock++;
+            continue;
+        }
+
+        if (Pentek_xx821Telemetry::Now() >= deadline) {
+            return(false);
+        }
+        usleep(POLL_SLEEP_US);
+    }
+}
+
+bool
+Pentek_xx821Subscriber::intact(const BlockView & view) const {
+    // Finish reading the data before checking the slot's generation
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const Segment::SlotInfo & info = _slots[view.number % _header->nBuffers];
+    return(info.generation.load(std::memory_order_relaxed) ==
+           Segment::Generation(view.number));
+}
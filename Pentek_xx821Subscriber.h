@@ -0,0 +1,141 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Subscriber.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821SUBSCRIBER_H_
+#define PENTEK_XX821SUBSCRIBER_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "Pentek_xx821StreamSegment.h"
+
+/// @brief Class which reads a DDC channel's blocks, in place, from the
+/// shared memory segment of a Pentek_xx821Publisher in another process
+///
+/// The segment is mapped read-only, and blocks are read where the board
+/// wrote them. Reading takes no locks and never holds up the publisher or
+/// other readers: a reader which falls behind the publisher's readable
+/// window skips ahead, counting the blocks it missed. Because the board
+/// may reuse a block's buffer once the block leaves the window, a reader
+/// should call intact() after using a block's data to make sure it wasn't
+/// overwritten meanwhile.
+///
+/// A Pentek_xx821Subscriber must be used from only one thread at a time.
+class Pentek_xx821Subscriber {
+public:
+    class OpenError : public virtual std::runtime_error {
+    public:
+        OpenError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief A published block, in place in the segment
+    struct BlockView {
+        /// @brief Block number since the publisher started
+        uint64_t number;
+        /// @brief Start of the sample data
+        const void * data;
+        /// @brief Number of valid bytes at data
+        uint32_t bytes;
+        /// @brief Board timetag of the first sample in the block
+        uint64_t timetag;
+        /// @brief Board sequence number of the block
+        uint32_t boardSequence;
+    };
+
+    /// @brief Attach to a publisher's segment. Reading starts with the next
+    /// block published.
+    /// @param shmName the shared memory segment name
+    /// @throws OpenError if the segment can't be mapped or isn't a
+    /// Pentek_xx821Publisher segment
+    Pentek_xx821Subscriber(const std::string & shmName);
+
+    /// @brief Destructor. Unmaps the segment.
+    virtual ~Pentek_xx821Subscriber();
+
+    /// @brief Get the next block
+    /// @param[out] view the block
+    /// @param timeoutMs the longest time to wait for a block, in ms
+    /// @return true iff a block was returned
+    bool next(BlockView & view, uint32_t timeoutMs);
+
+    /// @brief Return true iff a block's data has not been overwritten since
+    /// next() returned it
+    /// @param view the block
+    /// @return true iff the block's data is still intact
+    bool intact(const BlockView & view) const;
+
+    /// @brief Return the number of blocks skipped because this reader fell
+    /// behind
+    /// @return the number of blocks skipped
+    uint64_t missedCount() const { return(_missedCount); }
+
+    /// @brief Return true iff the publisher is running
+    /// @return true iff the publisher is running
+    bool publishing() const { return(_header->publishing != 0); }
+
+    /// @brief Return the publisher's board number
+    /// @return the publisher's board number
+    uint32_t boardNum() const { return(_header->boardNum); }
+
+    /// @brief Return the published DDC channel number
+    /// @return the published DDC channel number
+    uint32_t chanId() const { return(_header->chanId); }
+
+private:
+    /// @brief Segment name
+    std::string _shmName;
+
+    /// @brief Mapping of the segment
+    const void * _shmBase;
+
+    /// @brief Size of the segment, bytes
+    size_t _shmBytes;
+
+    /// @brief The segment header, in _shmBase
+    const Pentek_xx821StreamSegment::Header * _header;
+
+    /// @brief The slot table, in _shmBase
+    const Pentek_xx821StreamSegment::SlotInfo * _slots;
+
+    /// @brief The first DMA buffer, in _shmBase
+    const char * _data;
+
+    /// @brief Publisher start count when this reader last synchronized
+    uint32_t _startCount;
+
+    /// @brief Number of the next block to read
+    uint64_t _nextBlock;
+
+    /// @brief Number of blocks skipped
+    uint64_t _missedCount;
+};
+
+#endif /* PENTEK_XX821SUBSCRIBER_H_ */
@@ -0,0 +1,294 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Telemetry.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821Telemetry.h"
+
+LOGGING("Pentek_xx821Telemetry")
+
+const uint32_t Pentek_xx821Telemetry::MAX_SLOTS;
+const uint32_t Pentek_xx821Telemetry::SLOT_COUNTERS;
+const uint32_t Pentek_xx821Telemetry::HIST_BUCKETS;
+const uint32_t Pentek_xx821Telemetry::DEFAULT_SAMPLE_PERIOD;
+const uint32_t Pentek_xx821Telemetry::SHM_VERSION;
+const char Pentek_xx821Telemetry::SHM_MAGIC[8] = {
+    'P', 'X', 'X', '8', '2', '1', 'T', 'M'
+};
+
+std::atomic<uint32_t> Pentek_xx821Telemetry::_NextThreadSlot(0);
+
+static_assert(sizeof(Pentek_xx821Telemetry::Slot) % 64 == 0,
+              "telemetry slots must fill whole cache lines");
+static_assert(Pentek_xx821Telemetry::COUNTER_COUNT <=
+                      Pentek_xx821Telemetry::SLOT_COUNTERS,
+              "too many telemetry counters for the slot layout");
+
+// Offset of the slots from the start of the shared memory segment
+static const size_t SHM_SLOT_OFFSET = 64;
+static_assert(sizeof(Pentek_xx821Telemetry::ShmHeader) <= SHM_SLOT_OFFSET,
+              "telemetry shared memory header is too big");
+
+Pentek_xx821Telemetry::Pentek_xx821Telemetry(uint16_t boardNum) :
+    _boardNum(boardNum),
+    _slots(NULL),
+    _slotMemory(),
+    _retiredSlots(NULL),
+    _retiredBaseline(),
+    _samplePeriod(DEFAULT_SAMPLE_PERIOD),
+    _shmName(),
+    _shmBase(NULL),
+    _shmBytes(0)
+{
+    void * mem;
+    size_t bytes = MAX_SLOTS * sizeof(Slot);
+    if (posix_memalign(&mem, 64, bytes) != 0) {
+        throw std::bad_alloc();
+    }
+    memset(mem, 0, bytes);
+    _slotMemory.push_back(mem);
+    _slots = static_cast<Slot *>(mem);
+}
+
+Pentek_xx821Telemetry::~Pentek_xx821Telemetry() {
+    if (_shmBase) {
+        munmap(_shmBase, _shmBytes);
+        shm_unlink(_shmName.c_str());
+    }
+    for (void * mem : _slotMemory) {
+        free(mem);
+    }
+}
+
+void
+Pentek_xx821Telemetry::_AddSlots(const Slot * slots, Snapshot & snap) {
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            snap.counters[c] +=
+                    slots[s].counters[c].load(std::memory_order_relaxed);
+        }
+        for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+            for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+                snap.histograms[h][b] +=
+                        slots[s].histograms[h][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+Pentek_xx821Telemetry::Snapshot
+Pentek_xx821Telemetry::snapshot() const {
+    Snapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    const Slot * slots = _slots.load(std::memory_order_acquire);
+    _AddSlots(slots, snap);
+    // Add whatever threads still holding the pre-export slots have counted
+    // since their values were carried over
+    const Slot * retired = _retiredSlots.load(std::memory_order_acquire);
+    if (retired && retired != slots) {
+        Snapshot late;
+        memset(&late, 0, sizeof(late));
+        _AddSlots(retired, late);
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            snap.counters[c] += late.counters[c] - _retiredBaseline.counters[c];
+        }
+        for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+            for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+                snap.histograms[h][b] += late.histograms[h][b] -
+                        _retiredBaseline.histograms[h][b];
+            }
+        }
+    }
+    return(snap);
+}
+
+uint64_t
+Pentek_xx821Telemetry::Snapshot::sampleCount(Histogram hist) const {
+    uint64_t n = 0;
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        n += histograms[hist][b];
+    }
+    return(n);
+}
+
+double
+Pentek_xx821Telemetry::Snapshot::percentile(Histogram hist, double pct) const {
+    uint64_t n = sampleCount(hist);
+    if (n == 0) {
+        return(0.0);
+    }
+    // Find the bucket holding the requested rank, and interpolate
+    // geometrically within it
+    double rank = pct / 100.0 * n;
+    uint64_t below = 0;
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        uint64_t inBucket = histograms[hist][b];
+        if (inBucket > 0 && below + inBucket >= rank) {
+            double frac = (rank - below) / inBucket;
+            return(std::ldexp(std::pow(2.0, frac), b));
+        }
+        below += inBucket;
+    }
+    return(std::ldexp(1.0, HIST_BUCKETS));
+}
+
+const char *
+Pentek_xx821Telemetry::CounterName(Counter counter) {
+    static const char * names[COUNTER_COUNT] = {
+        "reg_reads", "reg_writes", "rx_blocks", "rx_bytes", "rx_overruns",
+        "rx_dropped_blocks", "tx_blocks", "tx_bytes", "tx_underruns",
+        "completion_polls", "completion_interrupts"
+    };
+    return(names[counter]);
+}
+
+const char *
+Pentek_xx821Telemetry::HistogramName(Histogram hist) {
+    static const char * names[HISTOGRAM_COUNT] = {
+        "reg_read", "reg_write", "rx_wait", "tx_wait"
+    };
+    return(names[hist]);
+}
+
+std::string
+Pentek_xx821Telemetry::summary(const std::string & indent) const {
+    Snapshot snap = snapshot();
+    std::ostringstream os;
+    os << indent << "registers: " << snap.counters[REG_READS] << " reads, " <<
+          snap.counters[REG_WRITES] << " writes" << std::endl;
+    os << indent << "receive: " << snap.counters[RX_BLOCKS] << " blocks, " <<
+          snap.counters[RX_BYTES] << " bytes, " <<
+          snap.counters[RX_OVERRUNS] << " overruns (" <<
+          snap.counters[RX_DROPPED_BLOCKS] << " blocks dropped)" << std::endl;
+    os << indent << "transmit: " << snap.counters[TX_BLOCKS] << " blocks, " <<
+          snap.counters[TX_BYTES] << " bytes, " <<
+          snap.counters[TX_UNDERRUNS] << " underruns" << std::endl;
+    os << indent << "DMA completion waits: " <<
+          snap.counters[COMPLETION_POLLS] << " polled, " <<
+          snap.counters[COMPLETION_INTERRUPTS] << " on interrupt" << std::endl;
+    os << std::fixed << std::setprecision(0);
+    for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+        Histogram hist = Histogram(h);
+        if (snap.sampleCount(hist) == 0) {
+            continue;
+        }
+        os << indent << HistogramName(hist) << " latency: p50 " <<
+              snap.percentile(hist, 50) << " ns, p99 " <<
+              snap.percentile(hist, 99) << " ns (" << snap.sampleCount(hist) <<
+              " samples)" << std::endl;
+    }
+    return(os.str());
+}
+
+bool
+Pentek_xx821Telemetry::exportToSharedMemory(const std::string & name) {
+    if (_shmBase) {
+        ELOG << "Board " << _boardNum << " telemetry is already exported to " <<
+                _shmName;
+        return(false);
+    }
+    size_t slotBytes = MAX_SLOTS * sizeof(Slot);
+    size_t bytes = SHM_SLOT_OFFSET + slotBytes;
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        ELOG << "shm_open(" << name << "): " << strerror(errno);
+        return(false);
+    }
+    void * base = MAP_FAILED;
+    if (ftruncate(fd, bytes) == 0) {
+        base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int err = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+        ELOG << "Cannot map telemetry shared memory " << name << ": " <<
+                strerror(err);
+        shm_unlink(name.c_str());
+        return(false);
+    }
+
+    ShmHeader * header = static_cast<ShmHeader *>(base);
+    memcpy(header->magic, SHM_MAGIC, sizeof(header->magic));
+    header->version = SHM_VERSION;
+    header->boardNum = _boardNum;
+    header->pid = getpid();
+    header->nSlots = MAX_SLOTS;
+    header->nCounters = SLOT_COUNTERS;
+    header->nHistograms = HISTOGRAM_COUNT;
+    header->nBuckets = HIST_BUCKETS;
+    header->slotOffset = SHM_SLOT_OFFSET;
+    header->slotBytes = sizeof(Slot);
+
+    // Carry the current values over, then switch the hot paths to the new
+    // slots. The old slots stay allocated for any thread still using them,
+    // and the baseline lets snapshot() pick up what they count from here on.
+    Slot * newSlots = reinterpret_cast<Slot *>(
+            static_cast<char *>(base) + SHM_SLOT_OFFSET);
+    const Slot * oldSlots = _slots.load(std::memory_order_relaxed);
+    memset(&_retiredBaseline, 0, sizeof(_retiredBaseline));
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        for (uint32_t c = 0; c < SLOT_COUNTERS; c++) {
+            uint64_t val =
+                    oldSlots[s].counters[c].load(std::memory_order_relaxed);
+            newSlots[s].counters[c].store(val, std::memory_order_relaxed);
+            if (c < COUNTER_COUNT) {
+                _retiredBaseline.counters[c] += val;
+            }
+        }
+        for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+            for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+                uint64_t val = oldSlots[s].histograms[h][b].load(
+                        std::memory_order_relaxed);
+                newSlots[s].histograms[h][b].store(val,
+                                                   std::memory_order_relaxed);
+                _retiredBaseline.histograms[h][b] += val;
+            }
+        }
+    }
+    _retiredSlots.store(oldSlots, std::memory_order_release);
+    _slots.store(newSlots, std::memory_order_release);
+
+    _shmBase = base;
+    _shmBytes = bytes;
+    _shmName = name;
+    ILOG << "Board " << _boardNum << " telemetry exported to shared memory " <<
+            name;
+    return(true);
+}
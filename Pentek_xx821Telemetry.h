@@ -0,0 +1,301 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Telemetry.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821TELEMETRY_H_
+#define PENTEK_XX821TELEMETRY_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Per-board runtime counters and latency histograms
+///
+/// Each thread updates its own slot of counters and histograms with relaxed
+/// atomic adds, so the hot paths never share a cache line or take a lock.
+/// (Threads beyond MAX_SLOTS share slots, which stays correct since the
+/// adds are atomic.) snapshot() sums the slots.
+///
+/// Latencies are recorded in log2 buckets: bucket i counts times in
+/// [2^i, 2^(i+1)) ns. To keep the cost of timing low, only one in every
+/// latencySamplePeriod() operations per thread is timed.
+///
+/// The slots can be moved into a POSIX shared memory segment with
+/// exportToSharedMemory(), after which an external monitor can map the
+/// segment and sum the slots itself, without involving this process. The
+/// segment starts with a ShmHeader describing the layout. The original
+/// slots are kept, and counts which threads still add to them after the
+/// move are folded into snapshot(), so none are lost.
+class Pentek_xx821Telemetry {
+public:
+    /// @brief Event counters
+    enum Counter {
+        REG_READS,          ///< hardware register reads
+        REG_WRITES,         ///< hardware register writes
+        RX_BLOCKS,          ///< DMA blocks received
+        RX_BYTES,           ///< DMA bytes received
+        RX_OVERRUNS,        ///< receive overruns
+        RX_DROPPED_BLOCKS,  ///< blocks dropped by the board in overruns
+        TX_BLOCKS,          ///< DMA blocks submitted for transmission
+        TX_BYTES,           ///< DMA bytes submitted for transmission
+        TX_UNDERRUNS,       ///< transmit underruns
+        COMPLETION_POLLS,   ///< DMA completion waits which polled
+        COMPLETION_INTERRUPTS, ///< DMA completion waits on an interrupt
+        COUNTER_COUNT
+    };
+
+    /// @brief Latency histograms
+    enum Histogram {
+        HIST_REG_READ,      ///< hardware register read
+        HIST_REG_WRITE,     ///< hardware register write
+        HIST_RX_WAIT,       ///< wait for a receive DMA completion
+        HIST_TX_WAIT,       ///< wait for a free transmit buffer
+        HISTOGRAM_COUNT
+    };
+
+    /// @brief Number of per-thread slots
+    static const uint32_t MAX_SLOTS = 64;
+
+    /// @brief Counter entries in each slot (room is left for new counters
+    /// without changing the shared memory layout)
+    static const uint32_t SLOT_COUNTERS = 16;
+
+    /// @brief Buckets in each histogram. The last bucket also counts all
+    /// longer times.
+    static const uint32_t HIST_BUCKETS = 32;
+
+    /// @brief Default latency sampling period
+    static const uint32_t DEFAULT_SAMPLE_PERIOD = 64;
+
+    /// @brief One thread's counters and histograms. The size is a multiple
+    /// of 64 bytes, so slots never share a cache line.
+    struct Slot {
+        std::atomic<uint64_t> counters[SLOT_COUNTERS];
+        std::atomic<uint64_t> histograms[HISTOGRAM_COUNT][HIST_BUCKETS];
+    };
+
+    /// @brief Header at the start of the shared memory segment. The slots
+    /// follow at offset slotOffset.
+    struct ShmHeader {
+        /// @brief SHM_MAGIC
+        char magic[8];
+        /// @brief SHM_VERSION
+        uint32_t version;
+        /// @brief Number of the board the telemetry is for
+        uint32_t boardNum;
+        /// @brief Process ID of the writer
+        int32_t pid;
+        /// @brief Number of slots
+        uint32_t nSlots;
+        /// @brief Counter entries per slot
+        uint32_t nCounters;
+        /// @brief Number of histograms per slot
+        uint32_t nHistograms;
+        /// @brief Buckets per histogram
+        uint32_t nBuckets;
+        /// @brief Offset of the first slot from the start of the segment
+        uint32_t slotOffset;
+        /// @brief Size of each slot, bytes
+        uint32_t slotBytes;
+        uint32_t reserved[5];
+    };
+
+    /// @brief Magic string at the start of the shared memory segment
+    static const char SHM_MAGIC[8];
+
+    /// @brief Version of the shared memory layout
+    static const uint32_t SHM_VERSION = 1;
+
+    /// @brief Summed values of all slots at one time
+    struct Snapshot {
+        uint64_t counters[COUNTER_COUNT];
+        uint64_t histograms[HISTOGRAM_COUNT][HIST_BUCKETS];
+
+        /// @brief Estimate a percentile from one of the histograms
+        /// @param hist the histogram
+        /// @param pct the percentile, 0-100
+        /// @return the estimated latency at the given percentile in ns, or
+        /// zero if the histogram is empty
+        double percentile(Histogram hist, double pct) const;
+
+        /// @brief Return the number of samples in one of the histograms
+        /// @param hist the histogram
+        /// @return the number of samples in the histogram
+        uint64_t sampleCount(Histogram hist) const;
+    };
+
+    /// @brief Constructor
+    /// @param boardNum the number of the board the telemetry is for
+    Pentek_xx821Telemetry(uint16_t boardNum);
+
+    /// @brief Destructor. Removes the shared memory segment, if any.
+    virtual ~Pentek_xx821Telemetry();
+
+    /// @brief Add to a counter
+    /// @param counter the counter
+    /// @param n the amount to add
+    void count(Counter counter, uint64_t n = 1) const {
+        _mySlot().counters[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// @brief Return true if the calling thread should time its current
+    /// operation, i.e., once every latencySamplePeriod() calls
+    /// @return true if the calling thread should time its current operation
+    bool sampleLatency() const {
+        static thread_local uint32_t nCalls = 0;
+        uint32_t period = _samplePeriod.load(std::memory_order_relaxed);
+        return(period != 0 && (++nCalls % period) == 0);
+    }
+
+    /// @brief Add a time to a latency histogram
+    /// @param hist the histogram
+    /// @param ns the time, in nanoseconds
+    void recordLatency(Histogram hist, uint64_t ns) const {
+        uint32_t bucket = ns ? 63 - __builtin_clzll(ns) : 0;
+        if (bucket >= HIST_BUCKETS) {
+            bucket = HIST_BUCKETS - 1;
+        }
+        _mySlot().histograms[hist][bucket].fetch_add(1,
+                                                     std::memory_order_relaxed);
+    }
+
+    /// @brief Return a monotonic time in nanoseconds, for use in timing
+    /// operations
+    /// @return a monotonic time in nanoseconds
+    static uint64_t Now() {
+        return(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /// @brief Set how often latencies are sampled
+    /// @param period time one in every period operations per thread, or 0 to
+    /// disable latency timing
+    void setLatencySamplePeriod(uint32_t period) { _samplePeriod = period; }
+
+    /// @brief Return the latency sampling period
+    /// @return the latency sampling period, or 0 if latency timing is
+    /// disabled
+    uint32_t latencySamplePeriod() const { return(_samplePeriod); }
+
+    /// @brief Return the sum of all slots
+    /// @return the sum of all slots
+    Snapshot snapshot() const;
+
+    /// @brief Return a short multi-line summary of the current values, each
+    /// line starting with the given indent
+    /// @param indent string to put at the start of each line
+    /// @return a short summary of the current values
+    std::string summary(const std::string & indent = "") const;
+
+    /// @brief Move the counters and histograms into a POSIX shared memory
+    /// segment where external monitors can read them
+    ///
+    /// The current values are carried over into the segment. Counts which
+    /// other threads add to the original slots during or after the move
+    /// still appear in snapshot() and summary(), but not in the segment.
+    /// The segment is removed when this object is destroyed.
+    /// @param name the segment name, e.g., "/Pentek_xx821_0"
+    /// @return true on success, false (after logging the reason) on failure
+    bool exportToSharedMemory(const std::string & name);
+
+    /// @brief Return the name of the shared memory segment, or an empty
+    /// string if the telemetry has not been exported
+    /// @return the name of the shared memory segment, or an empty string
+    const std::string & sharedMemoryName() const { return(_shmName); }
+
+    /// @brief Return the name of a counter
+    /// @param counter the counter
+    /// @return the name of the counter
+    static const char * CounterName(Counter counter);
+
+    /// @brief Return the name of a histogram
+    /// @param hist the histogram
+    /// @return the name of the histogram
+    static const char * HistogramName(Histogram hist);
+
+private:
+    /// @brief Add the values in a set of slots to a snapshot
+    /// @param slots the slots to add
+    /// @param snap the snapshot to add to
+    static void _AddSlots(const Slot * slots, Snapshot & snap);
+
+    /// @brief Return the calling thread's slot index
+    /// @return the calling thread's slot index
+    static uint32_t _ThreadSlot() {
+        static thread_local uint32_t slot =
+                _NextThreadSlot.fetch_add(1, std::memory_order_relaxed) %
+                MAX_SLOTS;
+        return(slot);
+    }
+
+    /// @brief Return the calling thread's slot
+    /// @return the calling thread's slot
+    Slot & _mySlot() const {
+        return(_slots.load(std::memory_order_relaxed)[_ThreadSlot()]);
+    }
+
+    /// @brief Counter used to hand out thread slot indices
+    static std::atomic<uint32_t> _NextThreadSlot;
+
+    /// @brief Number of the board the telemetry is for
+    uint16_t _boardNum;
+
+    /// @brief The slots currently in use
+    std::atomic<Slot *> _slots;
+
+    /// @brief Memory allocated for slots (the slots in use, and any
+    /// replaced by exportToSharedMemory(), which are kept since other
+    /// threads may still be using them)
+    std::vector<void *> _slotMemory;
+
+    /// @brief The slots replaced by exportToSharedMemory(), or NULL
+    std::atomic<const Slot *> _retiredSlots;
+
+    /// @brief Sum of the retired slots at the time their values were
+    /// carried over to the shared memory segment. Anything they have gained
+    /// since then is added to snapshot().
+    Snapshot _retiredBaseline;
+
+    /// @brief Latency sampling period, or 0 if latency timing is disabled
+    std::atomic<uint32_t> _samplePeriod;
+
+    /// @brief Name of the shared memory segment, or empty if not exported
+    std::string _shmName;
+
+    /// @brief Mapped shared memory segment, or NULL
+    void * _shmBase;
+
+    /// @brief Size of the mapped shared memory segment
+    size_t _shmBytes;
+};
+
+#endif /* PENTEK_XX821TELEMETRY_H_ */
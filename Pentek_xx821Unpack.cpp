@@ -0,0 +1,307 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Unpack.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "Pentek_xx821Unpack.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define PENTEK_XX821_UNPACK_X86 1
+#endif
+
+// The SIMD kernels are compiled with per-function target attributes, so the
+// library itself can still be built for (and run on) baseline x86-64. Each
+// kernel handles whole vectors and leaves any remainder to the scalar loop.
+
+static inline int16_t
+loadSample(const int16_t * in, bool byteSwap) {
+    return(byteSwap ? int16_t(__builtin_bswap16(uint16_t(*in))) : *in);
+}
+
+template<bool SWAP>
+static void
+scalarIqToComplex(const int16_t * in, std::complex<float> * out,
+                  size_t nPairs, const Pentek_xx821Unpack::Correction & corr) {
+    for (size_t p = 0; p < nPairs; p++) {
+        out[p] = std::complex<float>(
+                loadSample(in + 2 * p, SWAP) * corr.gainI + corr.offsetI,
+                loadSample(in + 2 * p + 1, SWAP) * corr.gainQ + corr.offsetQ);
+    }
+}
+
+template<bool SWAP>
+static void
+scalarIqToPlanes(const int16_t * in, float * outI, float * outQ,
+                 size_t nPairs, const Pentek_xx821Unpack::Correction & corr) {
+    for (size_t p = 0; p < nPairs; p++) {
+        outI[p] = loadSample(in + 2 * p, SWAP) * corr.gainI + corr.offsetI;
+        outQ[p] = loadSample(in + 2 * p + 1, SWAP) * corr.gainQ + corr.offsetQ;
+    }
+}
+
+static const Pentek_xx821Unpack::Kernels ScalarKernels = {
+    Pentek_xx821Unpack::ISA_SCALAR,
+    { scalarIqToComplex<false>, scalarIqToComplex<true> },
+    { scalarIqToPlanes<false>, scalarIqToPlanes<true> }
+};
+
+#ifdef PENTEK_XX821_UNPACK_X86
+
+// AVX2 kernels: 8 I/Q pairs (256 bits of input) per iteration
+
+template<bool SWAP>
+__attribute__((target("avx2,fma")))
+static inline __m256i
+avx2Load(const int16_t * in) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    if (SWAP) {
+        const __m256i swapMask = _mm256_setr_epi8(
+                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+        v = _mm256_shuffle_epi8(v, swapMask);
+    }
+    return(v);
+}
+
+template<bool SWAP>
+__attribute__((target("avx2,fma")))
+static void
+avx2IqToComplex(const int16_t * in, std::complex<float> * out,
+                size_t nPairs, const Pentek_xx821Unpack::Correction & corr) {
+    // Output order matches input order, so convert in place and apply
+    // alternating I and Q corrections
+    const __m256 gain = _mm256_setr_ps(corr.gainI, corr.gainQ,
+                                       corr.gainI, corr.gainQ,
+                                       corr.gainI, corr.gainQ,
+                                       corr.gainI, corr.gainQ);
+    const __m256 offset = _mm256_setr_ps(corr.offsetI, corr.offsetQ,
+                                         corr.offsetI, corr.offsetQ,
+                                         corr.offsetI, corr.offsetQ,
+                                         corr.offsetI, corr.offsetQ);
+    float * fout = reinterpret_cast<float *>(out);
+    size_t p = 0;
+    for (; p + 8 <= nPairs; p += 8) {
+        __m256i v = avx2Load<SWAP>(in + 2 * p);
+        __m256 lo = _mm256_cvtepi32_ps(
+                _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)));
+        __m256 hi = _mm256_cvtepi32_ps(
+                _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)));
+        _mm256_storeu_ps(fout + 2 * p, _mm256_fmadd_ps(lo, gain, offset));
+        _mm256_storeu_ps(fout + 2 * p + 8, _mm256_fmadd_ps(hi, gain, offset));
+    }
+    scalarIqToComplex<SWAP>(in + 2 * p, out + p, nPairs - p, corr);
+}
+
+template<bool SWAP>
+__attribute__((target("avx2,fma")))
+static void
+avx2IqToPlanes(const int16_t * in, float * outI, float * outQ,
+               size_t nPairs, const Pentek_xx821Unpack::Correction & corr) {
+    // Each 32-bit lane holds one pair, I in the low half: sign-extend the
+    // low half for I, and arithmetic-shift the high half down for Q
+    const __m256 gainI = _mm256_set1_ps(corr.gainI);
+    const __m256 gainQ = _mm256_set1_ps(corr.gainQ);
+    const __m256 offsetI = _mm256_set1_ps(corr.offsetI);
+    const __m256 offsetQ = _mm256_set1_ps(corr.offsetQ);
+    size_t p = 0;
+    for (; p + 8 <= nPairs; p += 8) {
+        __m256i v = avx2Load<SWAP>(in + 2 * p);
+        __m256 i = _mm256_cvtepi32_ps(
+                _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16));
+        __m256 q = _mm256_cvtepi32_ps(_mm256_srai_epi32(v, 16));
+        _mm256_storeu_ps(outI + p, _mm256_fmadd_ps(i, gainI, offsetI));
+        _mm256_storeu_ps(outQ + p, _mm256_fmadd_ps(q, gainQ, offsetQ));
+    }
+    scalarIqToPlanes<SWAP>(in + 2 * p, outI + p, outQ + p, nPairs - p, corr);
+}
+
+static const Pentek_xx821Unpack::Kernels Avx2Kernels = {
+    Pentek_xx821Unpack::ISA_AVX2,
+    { avx2IqToComplex<false>, avx2IqToComplex<true> },
+    { avx2IqToPlanes<false>, avx2IqToPlanes<true> }
+};
+
+// AVX-512 kernels: 16 I/Q pairs (512 bits of input) per iteration.
+// GCC 12's AVX-512 intrinsics trigger spurious -Wmaybe-uninitialized
+// warnings (GCC bug 105593), so quiet them here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+template<bool SWAP>
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i
+avx512Load(const int16_t * in) {
+    __m512i v = _mm512_loadu_si512(in);
+    if (SWAP) {
+        const __m512i swapMask = _mm512_set4_epi32(0x0e0f0c0d, 0x0a0b0809,
+                                                   0x06070405, 0x02030001);
+        v = _mm512_shuffle_epi8(v, swapMask);
+    }
+    return(v);
+}
+
+template<bool SWAP>
+__attribute__((target("avx512f,avx512bw")))
+static void
+avx512IqToComplex(const int16_t * in, std::complex<float> * out,
+                  size_t nPairs, const Pentek_xx821Unpack::Correction & corr) {
+    const __m512 gainIQ = _mm512_setr_ps(
+            corr.gainI, corr.gainQ, corr.gainI, corr.gainQ,
+            corr.gainI, corr.gainQ, corr.gainI, corr.gainQ,
+            corr.gainI, corr.gainQ, corr.gainI, corr.gainQ,
+            corr.gainI, corr.gainQ, corr.gainI, corr.gainQ);
+    const __m512 offsetIQ = _mm512_setr_ps(
+            corr.offsetI, corr.offsetQ, corr.offsetI, corr.offsetQ,
+            corr.offsetI, corr.offsetQ, corr.offsetI, corr.offsetQ,
+            corr.offsetI, corr.offsetQ, corr.offsetI, corr.offsetQ,
+            corr.offsetI, corr.offsetQ, corr.offsetI, corr.offsetQ);
+    float * fout = reinterpret_cast<float *>(out);
+    size_t p = 0;
+    for (; p + 16 <= nPairs; p += 16) {
+        __m512i v = avx512Load<SWAP>(in + 2 * p);
+        __m512 lo = _mm512_cvtepi32_ps(
+                _mm512_cvtepi16_epi32(_mm512_castsi512_si256(v)));
+        __m512 hi = _mm512_cvtepi32_ps(
+                _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(v, 1)));
+        _mm512_storeu_ps(fout + 2 * p, _mm512_fmadd_ps(lo, gainIQ, offsetIQ));
+        _mm512_storeu_ps(fout + 2 * p + 16,
+                         _mm512_fmadd_ps(hi, gainIQ, offsetIQ));
+    }
+    scalarIqToComplex<SWAP>(in + 2 * p, out + p, nPairs - p, corr);
+}
+
+template<bool SWAP>
+__attribute__((target("avx512f,avx512bw")))
+static void
+avx512IqToPlanes(const int16_t * in, float * outI, float * outQ,
+                 size_t nPairs, const Pentek_xx821Unpack::Correction & corr) {
+    const __m512 gainI = _mm512_set1_ps(corr.gainI);
+    const __m512 gainQ = _mm512_set1_ps(corr.gainQ);
+    const __m512 offsetI = _mm512_set1_ps(corr.offsetI);
+    const __m512 offsetQ = _mm512_set1_ps(corr.offsetQ);
+    size_t p = 0;
+    for (; p + 16 <= nPairs; p += 16) {
+        __m512i v = avx512Load<SWAP>(in + 2 * p);
+        __m512 i = _mm512_cvtepi32_ps(
+                _mm512_srai_epi32(_mm512_slli_epi32(v, 16), 16));
+        __m512 q = _mm512_cvtepi32_ps(_mm512_srai_epi32(v, 16));
+        _mm512_storeu_ps(outI + p, _mm512_fmadd_ps(i, gainI, offsetI));
+        _mm512_storeu_ps(outQ + p, _mm512_fmadd_ps(q, gainQ, offsetQ));
+    }
+    scalarIqToPlanes<SWAP>(in + 2 * p, outI + p, outQ + p, nPairs - p, corr);
+}
+
+static const Pentek_xx821Unpack::Kernels Avx512Kernels = {
+    Pentek_xx821Unpack::ISA_AVX512,
+    { avx512IqToComplex<false>, avx512IqToComplex<true> },
+    { avx512IqToPlanes<false>, avx512IqToPlanes<true> }
+};
+
+#pragma GCC diagnostic pop
+
+#endif // PENTEK_XX821_UNPACK_X86
+
+Pentek_xx821Unpack::Correction
+Pentek_xx821Unpack::UnitScale() {
+    Correction corr = { 1.0f / 32768, 1.0f / 32768, 0.0f, 0.0f };
+    return(corr);
+}
+
+const Pentek_xx821Unpack::Kernels *
+Pentek_xx821Unpack::KernelsFor(Isa isa) {
+    switch (isa) {
+    case ISA_SCALAR:
+        return(&ScalarKernels);
+#ifdef PENTEK_XX821_UNPACK_X86
+    case ISA_AVX2:
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return(&Avx2Kernels);
+        }
+        return(NULL);
+    case ISA_AVX512:
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") &&
+                __builtin_cpu_supports("avx512bw")) {
+            return(&Avx512Kernels);
+        }
+        return(NULL);
+#endif
+    default:
+        return(NULL);
+    }
+}
+
+const char *
+Pentek_xx821Unpack::IsaName(Isa isa) {
+    switch (isa) {
+    case ISA_SCALAR:
+        return("scalar");
+    case ISA_AVX2:
+        return("avx2");
+    case ISA_AVX512:
+        return("avx512");
+    default:
+        return("unknown");
+    }
+}
+
+bool
+Pentek_xx821Unpack::SetIsa(Isa isa) {
+    const Kernels * kernels = KernelsFor(isa);
+    if (! kernels) {
+        return(false);
+    }
+    _ActivePtr().store(kernels, std::memory_order_relaxed);
+    return(true);
+}
+
+const Pentek_xx821Unpack::Kernels &
+Pentek_xx821Unpack::_Choose() {
+    // An instruction set named in the environment wins, if it is supported
+    const char * name = getenv("PENTEK_XX821_UNPACK_ISA");
+    if (name) {
+        for (int isa = ISA_SCALAR; isa < ISA_COUNT; isa++) {
+            const Kernels * kernels = KernelsFor(Isa(isa));
+            if (kernels && ! strcmp(name, IsaName(Isa(isa)))) {
+                return(*kernels);
+            }
+        }
+    }
+    for (int isa = ISA_COUNT - 1; isa > ISA_SCALAR; isa--) {
+        const Kernels * kernels = KernelsFor(Isa(isa));
+        if (kernels) {
+            return(*kernels);
+        }
+    }
+    return(ScalarKernels);
+}
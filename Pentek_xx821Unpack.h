@@ -0,0 +1,160 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Unpack.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821UNPACK_H_
+#define PENTEK_XX821UNPACK_H_
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Conversion of packed 16-bit I/Q samples from the DDCs to scaled
+/// float
+///
+/// Each conversion applies a gain and offset correction separately to I and
+/// Q (out = in * gain + offset), optionally byte-swapping the input first,
+/// and writes either interleaved complex float or separate I and Q planes.
+///
+/// The conversions use AVX-512 or AVX2 kernels when the CPU supports them,
+/// chosen once at run time, and a scalar loop otherwise. The SIMD kernels
+/// use fused multiply-add, so results may differ from the scalar path in
+/// the last bit.
+///
+/// AVX-512 is preferred when available, since it does twice the work per
+/// instruction. On CPUs which lower their clock for AVX-512 that can make
+/// it slower than AVX2, or slow down other code on the same core, so the
+/// choice can be overridden: set the environment variable
+/// PENTEK_XX821_UNPACK_ISA to "avx2", "avx512" or "scalar", or call
+/// SetIsa(). (test/unpack_xx821 times each kernel set on the host.)
+class Pentek_xx821Unpack {
+public:
+    /// @brief Instruction set used by a set of kernels
+    enum Isa {
+        ISA_SCALAR,
+        ISA_AVX2,       ///< AVX2 + FMA
+        ISA_AVX512,     ///< AVX-512F + AVX-512BW
+        ISA_COUNT
+    };
+
+    /// @brief Gain and offset correction
+    struct Correction {
+        float gainI;
+        float gainQ;
+        float offsetI;
+        float offsetQ;
+    };
+
+    /// @brief Return a correction which just scales full-scale int16 to
+    /// [-1.0, 1.0)
+    /// @return a correction which scales full-scale int16 to [-1.0, 1.0)
+    static Correction UnitScale();
+
+    /// @brief Convert interleaved int16 I/Q pairs to complex float
+    /// @param in the input samples, I first in each pair
+    /// @param out the output
+    /// @param nPairs the number of I/Q pairs
+    /// @param corr the gain and offset correction
+    /// @param byteSwap true if the input is byte-swapped (big-endian)
+    static void IqToComplex(const int16_t * in, std::complex<float> * out,
+                            size_t nPairs, const Correction & corr,
+                            bool byteSwap = false) {
+        _Active().iqToComplex[byteSwap](in, out, nPairs, corr);
+    }
+
+    /// @brief Convert interleaved int16 I/Q pairs to separate I and Q float
+    /// planes
+    /// @param in the input samples, I first in each pair
+    /// @param outI the output I plane
+    /// @param outQ the output Q plane
+    /// @param nPairs the number of I/Q pairs
+    /// @param corr the gain and offset correction
+    /// @param byteSwap true if the input is byte-swapped (big-endian)
+    static void IqToPlanes(const int16_t * in, float * outI, float * outQ,
+                           size_t nPairs, const Correction & corr,
+                           bool byteSwap = false) {
+        _Active().iqToPlanes[byteSwap](in, outI, outQ, nPairs, corr);
+    }
+
+    /// @brief A set of kernels for one instruction set. Each array is
+    /// indexed by the byteSwap flag.
+    struct Kernels {
+        Isa isa;
+        void (*iqToComplex[2])(const int16_t *, std::complex<float> *, size_t,
+                               const Correction &);
+        void (*iqToPlanes[2])(const int16_t *, float *, float *, size_t,
+                              const Correction &);
+    };
+
+    /// @brief Return the kernels for an instruction set, e.g., to compare
+    /// them or time them
+    /// @param isa the instruction set
+    /// @return the kernels for the instruction set, or NULL if the CPU (or
+    /// the build) doesn't support it
+    static const Kernels * KernelsFor(Isa isa);
+
+    /// @brief Return the instruction set used by IqToComplex() and
+    /// IqToPlanes()
+    /// @return the instruction set used by IqToComplex() and IqToPlanes()
+    static Isa ActiveIsa() { return(_Active().isa); }
+
+    /// @brief Set the instruction set used by IqToComplex() and
+    /// IqToPlanes(), overriding the default choice
+    /// @param isa the instruction set
+    /// @return true on success, or false (leaving the kernels unchanged) if
+    /// the CPU or the build doesn't support the instruction set
+    static bool SetIsa(Isa isa);
+
+    /// @brief Return the name of an instruction set
+    /// @param isa the instruction set
+    /// @return the name of the instruction set
+    static const char * IsaName(Isa isa);
+
+private:
+    /// @brief Return the kernels in use, chosen on first use
+    /// @return the kernels in use
+    static const Kernels & _Active() {
+        return(*_ActivePtr().load(std::memory_order_relaxed));
+    }
+
+    /// @brief Return a reference to the pointer to the kernels in use
+    /// @return a reference to the pointer to the kernels in use
+    static std::atomic<const Kernels *> & _ActivePtr() {
+        static std::atomic<const Kernels *> active(&_Choose());
+        return(active);
+    }
+
+    /// @brief Choose the kernels named by PENTEK_XX821_UNPACK_ISA, or else
+    /// the preferred kernels this CPU supports
+    /// @return the chosen kernels
+    static const Kernels & _Choose();
+};
+
+#endif /* PENTEK_XX821UNPACK_H_ */
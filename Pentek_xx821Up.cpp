@@ -0,0 +1,292 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Up.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821DeferredLog.h"
+
+#include "Pentek_xx821Up.h"
+
+LOGGING("Pentek_xx821Up")
+
+const uint32_t Pentek_xx821Up::DEFAULT_BUFFER_COUNT;
+const uint32_t Pentek_xx821Up::DEFAULT_BUFFER_BYTES;
+
+Pentek_xx821Up::Pentek_xx821Up(Pentek_xx821 & board, uint32_t chanId,
+                               uint32_t nBuffers, uint32_t bufferBytes) :
+    _board(board),
+    _chanId(chanId),
+    _nBuffers(nBuffers),
+    _bufferBytes((bufferBytes + 4095) & ~4095u),
+    _ringMem(NULL),
+    _slotData(),
+    _slotBusAddr(),
+    _descs(NULL),
+    _segBytes(_bufferBytes),
+    _segsPerBuffer(1),
+    _nDescs(0),
+    _slotLastDesc(nBuffers, 0),
+    _nextDesc(0),
+    _oldestSlot(0),
+    _inFlight(0),
+    _acquired(false),
+    _running(false),
+    _blockCount(0),
+    _underrunCount(0),
+    _segmentCount(0),
+    _waiter(board, NAV_DMA_DIR_FROM_HOST, chanId)
+{
+    if (int32_t(_chanId) >= _board.dacCount()) {
+        std::ostringstream os;
+        os << "Cannot use DAC channel " << _chanId << " on Pentek_xx821 board " <<
+              _board._boardNum << " (only " << _board.dacCount() <<
+              " channels)";
+        throw ConstructError(os.str());
+    }
+    if (_nBuffers < 2 || _bufferBytes == 0 ||
+            uint64_t(_nBuffers) * _bufferBytes > UINT32_MAX) {
+        std::ostringstream os;
+        os << "Bad transmit ring size for DAC channel " << _chanId << ": " <<
+              nBuffers << " buffers of " << bufferBytes << " bytes";
+        throw ConstructError(os.str());
+    }
+
+    // Split blocks into multiple descriptors if the board's DMA reads must
+    // be segmented
+    uint32_t readSegBytes = _board.dmaReadSegmentBytes();
+    if (readSegBytes != 0 && readSegBytes < _bufferBytes) {
+        _segBytes = readSegBytes;
+        _segsPerBuffer = (_bufferBytes + _segBytes - 1) / _segBytes;
+        ILOG << "DAC channel " << _chanId << " DMA reads segmented into " <<
+                _segsPerBuffer << " x " << _segBytes << " bytes per buffer";
+    }
+    _nDescs = _nBuffers * _segsPerBuffer;
+
+    // Get the sample buffers (from the board's buffer pool if possible) and
+    // the descriptors
+    bool haveBuffers = _board._allocRingBuffers(_nBuffers, _bufferBytes,
+                                                _slotData, _slotBusAddr,
+                                                _ringMem);
+    uint64_t descBusAddr;
+    _descs = static_cast<NAV_DMA_DESC *>(
+            _board._allocDmaMemory(_nDescs * sizeof(NAV_DMA_DESC),
+                                   descBusAddr));
+    if (! haveBuffers || ! _descs) {
+        _board._freeRingBuffers(_slotData, _ringMem);
+        _board._freeDmaMemory(_descs);
+        std::ostringstream os;
+        os << "Failed to allocate transmit ring for DAC channel " << _chanId;
+        throw ConstructError(os.str());
+    }
+
+    // Descriptors start out owned by the host (DONE), so the board has
+    // nothing to play until the first submission. Buffer addresses and
+    // lengths are filled in as blocks are submitted.
+    for (uint32_t d = 0; d < _nDescs; d++) {
+        NAV_DMA_DESC & desc = _descs[d];
+        desc.busAddr = 0;
+        desc.length = 0;
+        desc.control = 0;
+        desc.status = NAV_DMA_DESC_STAT_DONE;
+    }
+
+    DLOG << "DAC channel " << _chanId << " transmit ring: " << _nBuffers <<
+            " x " << _bufferBytes << " bytes";
+}
+
+Pentek_xx821Up::~Pentek_xx821Up() {
+    stop();
+    _board._freeRingBuffers(_slotData, _ringMem);
+    _board._freeDmaMemory(_descs);
+}
+
+void
+Pentek_xx821Up::_logDmaError(int32_t status, const std::string & funcName) const {
+    std::ostringstream os;
+    os << funcName << " for DAC channel " << _chanId << " on board " <<
+          _board._boardNum;
+    Pentek_xx821::_LogNavigatorError(status, os.str());
+}
+
+bool
+Pentek_xx821Up::start() {
+    boost::recursive_mutex::scoped_lock guard(_board._mutex);
+    if (_running) {
+        return(true);
+    }
+
+    for (uint32_t d = 0; d < _nDescs; d++) {
+        _descs[d].status = NAV_DMA_DESC_STAT_DONE;
+    }
+    _nextDesc = 0;
+    _oldestSlot = 0;
+    _inFlight = 0;
+    _acquired = false;
+    _blockCount = 0;
+    _underrunCount = 0;
+    _segmentCount = 0;
+
+    int32_t status = NAV_DmaLinkedListSetup(_board._boardHandle,
+                                            NAV_DMA_DIR_FROM_HOST, _chanId,
+                                            _descs, _nDescs);
+    if (status != NAV_STAT_OK) {
+        _logDmaError(status, "NAV_DmaLinkedListSetup");
+        return(false);
+    }
+    status = NAV_DmaStart(_board._boardHandle, NAV_DMA_DIR_FROM_HOST, _chanId);
+    if (status != NAV_STAT_OK) {
+        _logDmaError(status, "NAV_DmaStart");
+        return(false);
+    }
+    _running = true;
+    return(true);
+}
+
+void
+Pentek_xx821Up::stop() {
+    boost::recursive_mutex::scoped_lock guard(_board._mutex);
+    if (! _running) {
+        return;
+    }
+    int32_t status = NAV_DmaStop(_board._boardHandle, NAV_DMA_DIR_FROM_HOST,
+                                 _chanId);
+    if (status != NAV_STAT_OK) {
+        _logDmaError(status, "NAV_DmaStop");
+    }
+    _running = false;
+}
+
+void
+Pentek_xx821Up::_reclaimCompleted() {
+    // The board completes buffers in ring order, so walk forward from the
+    // oldest queued buffer. A buffer is complete when the last of its
+    // descriptors is.
+    while (_inFlight > 0) {
+        const NAV_DMA_DESC & lastDesc = _descs[_slotLastDesc[_oldestSlot]];
+        if (! (lastDesc.status & NAV_DMA_DESC_STAT_DONE)) {
+            break;
+        }
+        if (lastDesc.status & NAV_DMA_DESC_STAT_ERROR) {
+            DEFERRABLE_ELOG("DAC channel " << _chanId <<
+                            " DMA error on block in slot " << _oldestSlot);
+        }
+        _oldestSlot = (_oldestSlot + 1) % _nBuffers;
+        _inFlight--;
+        _waiter.noteCompletion();
+    }
+}
+
+bool
+Pentek_xx821Up::acquireBuffer(TxBlock & block, uint32_t timeoutMs) {
+    if (_acquired) {
+        DEFERRABLE_ELOG("DAC channel " << _chanId <<
+                        ": acquireBuffer() called again before submitBuffer()");
+        return(false);
+    }
+
+    _reclaimCompleted();
+    if (_inFlight == _nBuffers) {
+        // Every buffer is queued on the board; wait until it completes one,
+        // by polling or interrupt depending on the board's completion mode
+        if (! _running) {
+            return(false);
+        }
+        bool haveBuffer = _waiter.wait([this]() {
+            _reclaimCompleted();
+            return(_inFlight < _nBuffers);
+        }, timeoutMs);
+        if (! haveBuffer) {
+            return(false);
+        }
+    }
+
+    uint32_t slot = (_oldestSlot + _inFlight) % _nBuffers;
+    block.handle = slot;
+    block.data = _slotData[slot];
+    block.capacity = _bufferBytes;
+    _acquired = true;
+    return(true);
+}
+
+bool
+Pentek_xx821Up::submitBuffer(const TxBlock & block, uint32_t bytes) {
+    uint32_t slot = (_oldestSlot + _inFlight) % _nBuffers;
+    if (! _acquired || block.handle != slot) {
+        DEFERRABLE_ELOG("DAC channel " << _chanId << ": submitBuffer() of slot " <<
+                        block.handle << " which is not the acquired buffer");
+        return(false);
+    }
+    if (bytes == 0 || bytes > _bufferBytes) {
+        DEFERRABLE_ELOG("DAC channel " << _chanId << ": cannot submit " <<
+                        bytes << " bytes from a " << _bufferBytes <<
+                        "-byte buffer");
+        return(false);
+    }
+
+    // If the board has nothing else queued, it ran dry waiting for us
+    _reclaimCompleted();
+    if (_inFlight == 0 && _blockCount > 0) {
+        _underrunCount++;
+        _board._telemetry.count(Pentek_xx821Telemetry::TX_UNDERRUNS);
+    }
+
+    // Fill in the block's descriptors: one if the block fits in a single
+    // segment, or a chain of them otherwise.
+    uint32_t nSegs = (bytes + _segBytes - 1) / _segBytes;
+    uint64_t busAddr = _slotBusAddr[slot];
+    for (uint32_t seg = 0; seg < nSegs; seg++) {
+        NAV_DMA_DESC & desc = _descs[(_nextDesc + seg) % _nDescs];
+        uint32_t offset = seg * _segBytes;
+        desc.busAddr = busAddr + offset;
+        desc.length = std::min(_segBytes, bytes - offset);
+        desc.control = (seg == nSegs - 1) ? NAV_DMA_DESC_CTRL_IRQ : 0;
+    }
+    _slotLastDesc[slot] = (_nextDesc + nSegs - 1) % _nDescs;
+
+    // Hand the descriptors to the board last to first, so that the board
+    // never finds a half-queued chain. The fence makes sure the sample data
+    // and descriptor contents are visible before the board can see any
+    // descriptor as ready.
+    std::atomic_thread_fence(std::memory_order_release);
+    for (uint32_t seg = nSegs; seg > 0; seg--) {
+        _descs[(_nextDesc + seg - 1) % _nDescs].status = 0;
+    }
+    _nextDesc = (_nextDesc + nSegs) % _nDescs;
+    _segmentCount += nSegs;
+
+    _inFlight++;
+    _blockCount++;
+    _board._telemetry.count(Pentek_xx821Telemetry::TX_BLOCKS);
+    _board._telemetry.count(Pentek_xx821Telemetry::TX_BYTES, bytes);
+    _acquired = false;
+    return(true);
+}
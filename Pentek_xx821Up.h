@@ -0,0 +1,248 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Up.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821UP_H_
+#define PENTEK_XX821UP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Pentek_xx821.h"
+#include "Pentek_xx821CompletionWaiter.h"
+
+/// @brief Class which encapsulates one DAC/upconverter channel of a Pentek
+/// xx821-series board
+///
+/// Waveform blocks are streamed to the DAC through a ring of pinned DMA
+/// buffers (two by default, i.e., double buffering), each with a Navigator
+/// linked-list descriptor. While the board plays one buffer, the host fills
+/// the next: acquireBuffer() returns the next free buffer, and
+/// submitBuffer() hands it to the board with the number of bytes to play,
+/// which may change from block to block.
+///
+/// Completion is signalled by the board writing back the descriptor status
+/// in host memory, so buffers are reclaimed without a system call. The
+/// caller only sleeps (waiting for a DMA interrupt) when every buffer is
+/// still queued on the board.
+///
+/// If a buffer is submitted when the board has nothing else queued, the
+/// DAC has run dry, and the submission is counted as an underrun.
+///
+/// When the board's DMA reads must be segmented (see
+/// Pentek_xx821::dmaReadSegmentBytes()), each block is queued as a chain of
+/// descriptors no larger than the segment size. The whole chain is handed
+/// to the board at once, so the board moves from one segment to the next
+/// without host involvement, and only the last segment of a block raises
+/// an interrupt.
+///
+/// Waveforms which the firmware plays from a table in register space,
+/// rather than streamed, are loaded with Pentek_xx821::loadWaveform_(),
+/// which uploads only what changed since the last load.
+///
+/// acquireBuffer() and submitBuffer() must be called from a single thread.
+class Pentek_xx821Up {
+public:
+    /// @brief Default number of DMA buffers in the transmit ring
+    static const uint32_t DEFAULT_BUFFER_COUNT = 2;
+
+    /// @brief Default size of each DMA buffer, in bytes
+    static const uint32_t DEFAULT_BUFFER_BYTES = 65536;
+
+    class ConstructError : public virtual std::runtime_error {
+    public:
+        ConstructError(std::string msg) : std::runtime_error(msg) {}
+    };
+
+    /// @brief A transmit buffer obtained from acquireBuffer()
+    struct TxBlock {
+        /// @brief Ring slot of the buffer, used to submit it
+        uint32_t handle;
+        /// @brief Start of the DMA buffer, to be filled with DAC samples
+        void * data;
+        /// @brief Size of the DMA buffer, in bytes
+        uint32_t capacity;
+    };
+
+    /// @brief Constructor
+    /// @param board the board containing the channel; it must outlive this
+    /// object
+    /// @param chanId the DAC channel number, 0 to board.dacCount() - 1
+    /// @param nBuffers the number of DMA buffers in the transmit ring
+    /// @param bufferBytes the size of each DMA buffer, in bytes; it is
+    /// rounded up to a multiple of 4096
+    /// @throws ConstructError on error in construction
+    Pentek_xx821Up(Pentek_xx821 & board, uint32_t chanId,
+                   uint32_t nBuffers = DEFAULT_BUFFER_COUNT,
+                   uint32_t bufferBytes = DEFAULT_BUFFER_BYTES);
+
+    /// @brief Destructor. DMA is stopped if it is running.
+    virtual ~Pentek_xx821Up();
+
+    /// @brief Return the DAC channel number
+    /// @return the DAC channel number
+    uint32_t chanId() const { return(_chanId); }
+
+    /// @brief Return the number of DMA buffers in the transmit ring
+    /// @return the number of DMA buffers in the transmit ring
+    uint32_t bufferCount() const { return(_nBuffers); }
+
+    /// @brief Return the size of each DMA buffer, in bytes
+    /// @return the size of each DMA buffer, in bytes
+    uint32_t bufferBytes() const { return(_bufferBytes); }
+
+    /// @brief Start DMA. The board idles until the first buffer is
+    /// submitted.
+    /// @return true iff DMA was started successfully
+    bool start();
+
+    /// @brief Stop DMA. Any buffers still queued are abandoned.
+    void stop();
+
+    /// @brief Return true iff DMA is running
+    /// @return true iff DMA is running
+    bool running() const { return(_running); }
+
+    /// @brief Get the next free transmit buffer
+    /// @param[out] block the buffer, if one is available
+    /// @param timeoutMs the longest time to wait for a buffer, in ms
+    /// @return true iff a buffer was obtained
+    bool acquireBuffer(TxBlock & block, uint32_t timeoutMs);
+
+    /// @brief Queue a filled buffer for transmission
+    /// @param block the buffer, obtained from the last acquireBuffer() call
+    /// @param bytes the number of bytes in the buffer to transmit
+    /// @return true iff the buffer was queued
+    bool submitBuffer(const TxBlock & block, uint32_t bytes);
+
+    /// @brief Return the number of buffers queued on the board and not yet
+    /// completed, as of the last acquireBuffer() or submitBuffer() call
+    /// @return the number of buffers queued on the board
+    uint32_t inFlightCount() const { return(_inFlight); }
+
+    /// @brief Return the number of blocks submitted since start()
+    /// @return the number of blocks submitted since start()
+    uint64_t blockCount() const { return(_blockCount); }
+
+    /// @brief Return the number of underruns seen since start()
+    /// @return the number of underruns seen since start()
+    uint64_t underrunCount() const { return(_underrunCount); }
+
+    /// @brief Return true iff blocks are split into multiple DMA read
+    /// segments
+    /// @return true iff blocks are split into multiple DMA read segments
+    bool segmented() const { return(_segsPerBuffer > 1); }
+
+    /// @brief Return the number of DMA descriptors queued since start()
+    ///
+    /// The cost of DMA read segmentation is the number of extra descriptors
+    /// the board has to fetch and process, segmentCount() - blockCount().
+    /// @return the number of DMA descriptors queued since start()
+    uint64_t segmentCount() const { return(_segmentCount); }
+
+protected:
+    /// @brief Reclaim buffers whose transmission the board has completed
+    void _reclaimCompleted();
+
+    /// @brief Log an error from a Navigator DMA call for this channel
+    /// @param status the status returned by the Navigator function
+    /// @param funcName the name of the Navigator function
+    void _logDmaError(int32_t status, const std::string & funcName) const;
+
+    /// @brief The board containing the channel
+    Pentek_xx821 & _board;
+
+    /// @brief DAC channel number
+    uint32_t _chanId;
+
+    /// @brief Number of DMA buffers in the ring
+    uint32_t _nBuffers;
+
+    /// @brief Size of each DMA buffer, in bytes
+    uint32_t _bufferBytes;
+
+    /// @brief Single DMA allocation holding the ring's sample buffers, or
+    /// NULL if they came from the board's buffer pool
+    void * _ringMem;
+
+    /// @brief Address of each ring slot's sample buffer
+    std::vector<uint8_t *> _slotData;
+
+    /// @brief Bus address of each ring slot's sample buffer
+    std::vector<uint64_t> _slotBusAddr;
+
+    /// @brief Navigator descriptor ring, in DMA memory. Descriptors are
+    /// used in order, as many per block as the block needs.
+    NAV_DMA_DESC * _descs;
+
+    /// @brief Largest transfer described by one descriptor, in bytes
+    uint32_t _segBytes;
+
+    /// @brief Maximum number of descriptors needed for one buffer
+    uint32_t _segsPerBuffer;
+
+    /// @brief Number of descriptors in the descriptor ring
+    uint32_t _nDescs;
+
+    /// @brief For each buffer slot, the index of the last descriptor queued
+    /// for it
+    std::vector<uint32_t> _slotLastDesc;
+
+    /// @brief Index of the next descriptor to be queued
+    uint32_t _nextDesc;
+
+    /// @brief Ring slot of the oldest buffer queued on the board
+    uint32_t _oldestSlot;
+
+    /// @brief Number of buffers queued on the board
+    std::atomic<uint32_t> _inFlight;
+
+    /// @brief Is a buffer currently acquired and not yet submitted?
+    bool _acquired;
+
+    /// @brief Is DMA running?
+    std::atomic<bool> _running;
+
+    /// @brief Number of blocks submitted since start()
+    std::atomic<uint64_t> _blockCount;
+
+    /// @brief Number of underruns seen since start()
+    std::atomic<uint64_t> _underrunCount;
+
+    /// @brief Number of descriptors queued since start()
+    std::atomic<uint64_t> _segmentCount;
+
+    /// @brief Waits for DMA completions in the board's completion mode
+    Pentek_xx821CompletionWaiter _waiter;
+};
+
+#endif /* PENTEK_XX821UP_H_ */
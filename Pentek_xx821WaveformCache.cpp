@@ -0,0 +1,147 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821WaveformCache.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <logx/Logging.h>
+
+#include "Pentek_xx821WaveformCache.h"
+
+LOGGING("Pentek_xx821WaveformCache")
+
+const uint32_t Pentek_xx821WaveformCache::DEFAULT_MERGE_GAP_WORDS;
+
+/// @brief Words compared at a time while skipping unchanged stretches
+static const size_t COMPARE_CHUNK_WORDS = 16;
+
+Pentek_xx821WaveformCache::Pentek_xx821WaveformCache(
+        uint32_t chanId, uint32_t tableBase, size_t capacityWords,
+        uint32_t mergeGapWords) :
+    _chanId(chanId),
+    _tableBase(tableBase),
+    _mergeGapWords(mergeGapWords),
+    _loaded(),
+    _knownWords(0),
+    _runs(),
+    _lastUploadWords(0),
+    _lastRunCount(0)
+{
+    if ((tableBase % 4) != 0 ||
+            capacityWords > (uint64_t(UINT32_MAX) + 1 - tableBase) / 4) {
+        std::ostringstream os;
+        os << "Bad waveform table for DAC channel " << chanId << " at 0x" <<
+              std::hex << tableBase << std::dec << " with " <<
+              capacityWords << " words";
+        throw std::invalid_argument(os.str());
+    }
+    _loaded.resize(capacityWords, 0);
+}
+
+void
+Pentek_xx821WaveformCache::invalidate() {
+    _knownWords = 0;
+}
+
+size_t
+Pentek_xx821WaveformCache::_nextChange(const uint32_t * words, size_t start,
+                                       size_t count) const {
+    // Only the known part of the table can match
+    size_t end = std::min(count, _knownWords);
+    size_t ndx = start;
+    // Skip unchanged stretches a chunk at a time, then find the word
+    while (ndx + COMPARE_CHUNK_WORDS <= end &&
+            memcmp(words + ndx, &_loaded[ndx],
+                   COMPARE_CHUNK_WORDS * sizeof(uint32_t)) == 0) {
+        ndx += COMPARE_CHUNK_WORDS;
+    }
+    while (ndx < end && words[ndx] == _loaded[ndx]) {
+        ndx++;
+    }
+    // Words past the known part of the table always count as changed
+    return(ndx);
+}
+
+size_t
+Pentek_xx821WaveformCache::_nextMatch(const uint32_t * words, size_t start,
+                                      size_t count) const {
+    size_t end = std::min(count, _knownWords);
+    size_t ndx = start;
+    while (ndx < end && words[ndx] != _loaded[ndx]) {
+        ndx++;
+    }
+    return((ndx < end) ? ndx : count);
+}
+
+const std::vector<Pentek_xx821WaveformCache::Run> &
+Pentek_xx821WaveformCache::diff(const uint32_t * words, size_t count) {
+    if (count > _loaded.size()) {
+        std::ostringstream os;
+        os << "Waveform of " << count << " words does not fit in the " <<
+              _loaded.size() << "-word table for DAC channel " << _chanId;
+        throw std::invalid_argument(os.str());
+    }
+
+    // Alternate between changed and unchanged stretches. A changed stretch
+    // is joined to the previous run if the unchanged stretch between them
+    // is no longer than the merge gap.
+    _runs.clear();
+    size_t ndx = _nextChange(words, 0, count);
+    while (ndx < count) {
+        size_t end = _nextMatch(words, ndx, count);
+        if (! _runs.empty() &&
+                ndx - (_runs.back().firstWord + _runs.back().count) <=
+                _mergeGapWords) {
+            _runs.back().count = end - _runs.back().firstWord;
+        } else {
+            Run run = { ndx, end - ndx };
+            _runs.push_back(run);
+        }
+        ndx = _nextChange(words, end, count);
+    }
+    return(_runs);
+}
+
+void
+Pentek_xx821WaveformCache::commit(const uint32_t * words, size_t count) {
+    _lastUploadWords = 0;
+    for (size_t r = 0; r < _runs.size(); r++) {
+        const Run & run = _runs[r];
+        std::copy(words + run.firstWord, words + run.firstWord + run.count,
+                  _loaded.begin() + run.firstWord);
+        _lastUploadWords += run.count;
+    }
+    _lastRunCount = _runs.size();
+    _knownWords = std::max(_knownWords, count);
+
+    DLOG << "DAC channel " << _chanId << " waveform of " << count <<
+            " words loaded: " << _lastUploadWords << " words in " <<
+            _lastRunCount << " burst(s)";
+}
@@ -0,0 +1,165 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821WaveformCache.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821WAVEFORMCACHE_H_
+#define PENTEK_XX821WAVEFORMCACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// @brief Host-side copy of the waveform table loaded on the board for one
+/// DAC channel, used to upload only what changes between waveforms
+///
+/// Transmit waveforms for different scan modes often differ in only a few
+/// samples or a phase code. Given a new waveform, diff() compares it with
+/// the copy of what is on the board and returns the changed word ranges as
+/// a short list of runs. Changed ranges separated by no more than the merge
+/// gap are coalesced into one run, since rewriting a few unchanged words
+/// within a burst costs less than starting another burst.
+/// Pentek_xx821::loadWaveform_() writes the runs as register bursts and
+/// then updates the copy, so mode switch time scales with how much of the
+/// waveform changed rather than with its length.
+///
+/// The table's location in the board's register space is defined by the
+/// firmware, so board subclasses create one cache per DAC channel for it.
+/// Until the first load (or after invalidate()), the contents of the table
+/// on the board are unknown, and the whole waveform is uploaded.
+///
+/// A Pentek_xx821WaveformCache must be used from only one thread at a time.
+class Pentek_xx821WaveformCache {
+public:
+    /// @brief Default merge gap, in words: one 64-byte write-combining line
+    static const uint32_t DEFAULT_MERGE_GAP_WORDS = 16;
+
+    /// @brief A run of consecutive changed words
+    struct Run {
+        /// @brief Index of the first word of the run in the waveform
+        size_t firstWord;
+        /// @brief Number of words in the run
+        size_t count;
+    };
+
+    /// @brief Constructor
+    /// @param chanId the DAC channel number, used in log messages
+    /// @param tableBase the register address of the first word of the
+    /// channel's waveform table, which must be a multiple of 4
+    /// @param capacityWords the size of the waveform table, in 32-bit words
+    /// @param mergeGapWords changed ranges separated by at most this many
+    /// unchanged words are uploaded as one run
+    /// @throws std::invalid_argument if the table is misaligned or extends
+    /// past the end of the 32-bit register address space
+    Pentek_xx821WaveformCache(
+            uint32_t chanId, uint32_t tableBase, size_t capacityWords,
+            uint32_t mergeGapWords = DEFAULT_MERGE_GAP_WORDS);
+
+    /// @brief Return the DAC channel number
+    /// @return the DAC channel number
+    uint32_t chanId() const { return(_chanId); }
+
+    /// @brief Return the register address of the waveform table
+    /// @return the register address of the waveform table
+    uint32_t tableBase() const { return(_tableBase); }
+
+    /// @brief Return the size of the waveform table, in 32-bit words
+    /// @return the size of the waveform table, in 32-bit words
+    size_t capacityWords() const { return(_loaded.size()); }
+
+    /// @brief Return the number of leading words of the table whose
+    /// contents on the board are known
+    /// @return the number of leading words known
+    size_t knownWords() const { return(_knownWords); }
+
+    /// @brief Forget what is loaded on the board, so that the next load
+    /// uploads the whole waveform (e.g., after the board is reset or the
+    /// table is written by other means)
+    void invalidate();
+
+    /// @brief Build the list of runs needed to load a waveform
+    /// @param words the waveform
+    /// @param count the number of words in the waveform
+    /// @return the runs of words to upload, in increasing order, valid
+    /// until the next call
+    /// @throws std::invalid_argument if the waveform is larger than the table
+    const std::vector<Run> & diff(const uint32_t * words, size_t count);
+
+    /// @brief Record that the runs returned by the last diff() have been
+    /// written to the board, updating the host-side copy
+    /// @param words the waveform passed to the last diff()
+    /// @param count the number of words passed to the last diff()
+    void commit(const uint32_t * words, size_t count);
+
+    /// @brief Return the number of words uploaded by the last load
+    /// @return the number of words uploaded by the last load
+    size_t lastUploadWords() const { return(_lastUploadWords); }
+
+    /// @brief Return the number of runs uploaded by the last load
+    /// @return the number of runs uploaded by the last load
+    size_t lastRunCount() const { return(_lastRunCount); }
+
+private:
+    /// @brief Return the index of the first word at or after @p start which
+    /// differs from the copy, or @p count if there is none
+    size_t _nextChange(const uint32_t * words, size_t start,
+                       size_t count) const;
+
+    /// @brief Return the index of the first word at or after @p start which
+    /// matches the copy, or @p count if there is none
+    size_t _nextMatch(const uint32_t * words, size_t start,
+                      size_t count) const;
+
+    /// @brief DAC channel number
+    uint32_t _chanId;
+
+    /// @brief Register address of the waveform table
+    uint32_t _tableBase;
+
+    /// @brief Merge gap, words
+    uint32_t _mergeGapWords;
+
+    /// @brief Copy of the table contents on the board
+    std::vector<uint32_t> _loaded;
+
+    /// @brief Number of leading words of _loaded which match the board
+    size_t _knownWords;
+
+    /// @brief Runs built by the last diff()
+    std::vector<Run> _runs;
+
+    /// @brief Number of words uploaded by the last load
+    size_t _lastUploadWords;
+
+    /// @brief Number of runs uploaded by the last load
+    size_t _lastRunCount;
+};
+
+#endif /* PENTEK_XX821WAVEFORMCACHE_H_ */
@@ -0,0 +1,110 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821WorkerPool.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <sstream>
+
+#include "Pentek_xx821WorkerPool.h"
+
+Pentek_xx821WorkerPool::Pentek_xx821WorkerPool(
+        const std::string & name, uint32_t nWorkers,
+        const Pentek_xx821ServiceThread::Config & threadConfig,
+        JobFunction job) :
+    _job(job),
+    _jobMutex(),
+    _jobReady(),
+    _jobDone(),
+    _jobGeneration(0),
+    _nBusy(0),
+    _quit(false),
+    _threads()
+{
+    for (uint32_t w = 1; w < nWorkers; w++) {
+        std::ostringstream threadName;
+        threadName << name << w;
+        _threads.emplace_back(new Pentek_xx821ServiceThread(
+                threadName.str(), threadConfig,
+                [this, w](Pentek_xx821ServiceThread & thread) {
+                    _workerBody(thread, w);
+                }));
+    }
+}
+
+Pentek_xx821WorkerPool::~Pentek_xx821WorkerPool() {
+    {
+        boost::mutex::scoped_lock guard(_jobMutex);
+        _quit = true;
+    }
+    _jobReady.notify_all();
+    _threads.clear();
+}
+
+void
+Pentek_xx821WorkerPool::_workerBody(Pentek_xx821ServiceThread & thread,
+                                    uint32_t worker) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            boost::mutex::scoped_lock guard(_jobMutex);
+            while (! _quit && _jobGeneration == seenGeneration) {
+                _jobReady.wait(guard);
+            }
+            if (_quit) {
+                return;
+            }
+            seenGeneration = _jobGeneration;
+        }
+        _job(worker);
+        {
+            boost::mutex::scoped_lock guard(_jobMutex);
+            if (--_nBusy == 0) {
+                _jobDone.notify_one();
+            }
+        }
+    }
+}
+
+void
+Pentek_xx821WorkerPool::runOnAll() {
+    if (_threads.empty()) {
+        _job(0);
+        return;
+    }
+    {
+        boost::mutex::scoped_lock guard(_jobMutex);
+        _nBusy = _threads.size();
+        _jobGeneration++;
+    }
+    _jobReady.notify_all();
+    _job(0);
+    boost::mutex::scoped_lock guard(_jobMutex);
+    while (_nBusy > 0) {
+        _jobDone.wait(guard);
+    }
+}
@@ -0,0 +1,116 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821WorkerPool.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821WORKERPOOL_H_
+#define PENTEK_XX821WORKERPOOL_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "Pentek_xx821ServiceThread.h"
+
+/// @brief A fixed set of workers which run one job function together, for
+/// processing stages which split each piece of work among several cores
+///
+/// Worker 0 is the thread calling runOnAll(); workers 1 and up are
+/// Pentek_xx821ServiceThreads, which wait for each new job, run the job
+/// function with their worker index, and report back. The job function
+/// finds the work to do in its owner's state, which runOnAll() hands over to
+/// the workers and back.
+///
+/// runOnAll() must be called from only one thread at a time.
+class Pentek_xx821WorkerPool {
+public:
+    /// @brief Function run by each worker for each job
+    /// @param worker the worker index, 0 to size() - 1
+    typedef std::function<void(uint32_t worker)> JobFunction;
+
+    /// @brief Constructor. Starts the worker service threads.
+    /// @param name prefix of the worker thread names; the worker index is
+    /// appended
+    /// @param nWorkers the number of workers, including the calling thread
+    /// @param threadConfig scheduling and isolation settings for the worker
+    /// threads
+    /// @param job the job function
+    Pentek_xx821WorkerPool(
+            const std::string & name, uint32_t nWorkers,
+            const Pentek_xx821ServiceThread::Config & threadConfig,
+            JobFunction job);
+
+    /// @brief Destructor. Stops the worker threads.
+    virtual ~Pentek_xx821WorkerPool();
+
+    /// @brief Run the job function on all workers, and return when they
+    /// have all finished
+    void runOnAll();
+
+    /// @brief Return the number of workers, including the calling thread
+    /// @return the number of workers
+    uint32_t size() const { return(_threads.size() + 1); }
+
+private:
+    /// @brief Body of the worker service threads
+    /// @param thread the service thread
+    /// @param worker the worker index
+    void _workerBody(Pentek_xx821ServiceThread & thread, uint32_t worker);
+
+    /// @brief The job function
+    JobFunction _job;
+
+    /// @brief Guards _jobGeneration, _nBusy and _quit
+    boost::mutex _jobMutex;
+
+    /// @brief Signals workers that a new job is ready or that they should
+    /// quit
+    boost::condition_variable _jobReady;
+
+    /// @brief Signals the calling thread that all workers are done
+    boost::condition_variable _jobDone;
+
+    /// @brief Incremented for each new job
+    uint64_t _jobGeneration;
+
+    /// @brief Number of worker threads still working on the current job
+    uint32_t _nBusy;
+
+    /// @brief Set when the worker threads should exit
+    bool _quit;
+
+    /// @brief Worker service threads, for workers 1 and up
+    std::vector<std::unique_ptr<Pentek_xx821ServiceThread> > _threads;
+};
+
+#endif /* PENTEK_XX821WORKERPOOL_H_ */
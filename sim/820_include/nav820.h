@@ -0,0 +1,54 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * nav820.h
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Stand-in for the Navigator BSP's 820_include/nav820.h, declaring the
+ * xx821-specific functions used by the test programs. Implemented by the
+ * simulated board in Pentek_xx821Sim.cpp.
+ */
+
+#ifndef SIM_NAV820_H_
+#define SIM_NAV820_H_
+
+#include <nav_common.h>
+
+// Bus master modes for NAV820_BusSetup()
+#define NAV_BUS_MSTR_STAND_ALONE 0
+#define NAV_BUS_MSTR_MASTER 1
+#define NAV_BUS_MSTR_SLAVE 2
+
+// User LED states for NAVip_BrdInfoRegs_UserLed_SetUserLedEnable()
+#define NAV_IP_BRD_INFO_USER_LED_CTRL_USER_LED_OFF 0
+#define NAV_IP_BRD_INFO_USER_LED_CTRL_USER_LED_ON 1
+
+int32_t NAV820_BusSetup(NAV_BOARD_RESRC * board, uint32_t syncBusMode,
+                        uint32_t gateBusMode);
+void NAVip_BrdInfoRegs_UserLed_SetUserLedEnable(volatile uint32_t * baseBAR0,
+                                                uint32_t enable);
+
+#endif /* SIM_NAV820_H_ */
@@ -0,0 +1,587 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Sim.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Simulated Navigator backend: implements the Navigator API declared in
+ * sim/nav_common.h and sim/820_include/nav820.h, and the DMA calls declared
+ * in Pentek_xx821NavDma.h.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <logx/Logging.h>
+
+#include <nav_common.h>
+#include <820_include/nav820.h>
+#include "../Pentek_xx821NavDma.h"
+#include "Pentek_xx821Sim.h"
+
+// The simulator implements the DMA calls, so it is only built along with a
+// library whose DMA paths use them
+#ifndef PENTEK_XX821_NAV_DMA
+#error "The simulated backend needs PENTEK_XX821_NAV_DMA (set by PENTEK_SIM)"
+#endif
+
+LOGGING("Pentek_xx821Sim")
+
+const char * NavApiStatus[] = {
+    "OK",
+    "error",
+    "timeout",
+    "bad parameter",
+    "out of memory",
+    "DMA channel not running"
+};
+
+typedef std::chrono::steady_clock SimClock;
+
+// Common timing reference for all simulated boards: timetags count
+// nanoseconds from here, as if every board ran from one radar timing
+// generator
+static const SimClock::time_point SimEpoch = SimClock::now();
+
+// Size of the simulated BAR0 register space, and the offsets of the user
+// blocks within it
+static const uint32_t BAR0_BYTES = 0x300000;
+static const uint32_t USER_BLOCK_1_OFFSET = 0x100000;
+static const uint32_t USER_BLOCK_2_OFFSET = 0x200000;
+
+// Board info register used for the user LED
+static const uint32_t USER_LED_REG = 0x30;
+
+// Return an environment variable's value as a number, or the given default
+// if it is not set
+static double
+envValue(const char * name, double defaultValue) {
+    const char * val = getenv(name);
+    return(val ? atof(val) : defaultValue);
+}
+
+// Sleep until the given time. Waits shorter than the scheduler can manage
+// are busy-waited.
+static void
+waitUntil(const SimClock::time_point & t) {
+    SimClock::time_point now = SimClock::now();
+    if (t - now > std::chrono::microseconds(100)) {
+        boost::this_thread::sleep(boost::posix_time::microseconds(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                        t - now).count() - 50));
+    }
+    while (SimClock::now() < t) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+// The current configuration. Register latencies are also kept in atomics
+// so that register accesses don't need the lock.
+static boost::mutex ConfigMutex;
+static Pentek_xx821Sim::Config & currentConfig() {
+    static Pentek_xx821Sim::Config config = Pentek_xx821Sim::DefaultConfig();
+    return(config);
+}
+static std::atomic<uint32_t> RegReadNs(currentConfig().regReadNs);
+static std::atomic<uint32_t> RegWriteNs(currentConfig().regWriteNs);
+
+/// DMA state for one channel direction of a simulated board
+class SimChannel {
+public:
+    SimChannel(uint32_t dir, uint32_t chan) :
+        dir(dir), chan(chan), descs(NULL), nDescs(0), running(false),
+        irqPending(false), sequence(0) {}
+    ~SimChannel() { stop(); }
+
+    void start() {
+        Pentek_xx821Sim::Config config = Pentek_xx821Sim::GetConfig();
+        bytesPerNs = config.dmaMBytesPerSec * 1.0e-3;
+        descNs = config.dmaDescUs * 1000;
+        irqLatencyNs = config.irqLatencyUs * 1000;
+        sequence = 0;
+        irqPending = false;
+        running = true;
+        thread = boost::thread(dir == NAV_DMA_DIR_TO_HOST ?
+                               &SimChannel::_runToHost :
+                               &SimChannel::_runFromHost, this);
+    }
+
+    void stop() {
+        running = false;
+        if (thread.joinable()) {
+            thread.join();
+        }
+        irqCond.notify_all();
+    }
+
+    int32_t waitForInterrupt(uint32_t timeoutMs) {
+        boost::unique_lock<boost::mutex> guard(irqMutex);
+        boost::posix_time::milliseconds timeout(timeoutMs);
+        bool gotIrq = irqCond.timed_wait(guard, timeout, [this] {
+            return(irqPending || ! running);
+        });
+        if (! gotIrq || ! irqPending) {
+            return(running ? NAV_STAT_TIMEOUT : NAV_STAT_NOT_RUNNING);
+        }
+        irqPending = false;
+        guard.unlock();
+        Pentek_xx821Sim::Spin(irqLatencyNs);
+        return(NAV_STAT_OK);
+    }
+
+    const uint32_t dir;
+    const uint32_t chan;
+    NAV_DMA_DESC * descs;
+    uint32_t nDescs;
+    std::atomic<bool> running;
+
+private:
+    // Time to move the given number of bytes, including descriptor overhead
+    SimClock::duration _xferTime(uint32_t bytes) const {
+        return(std::chrono::nanoseconds(
+                descNs + uint64_t(std::ceil(bytes / bytesPerNs))));
+    }
+
+    // Hand a descriptor back to the host, raising an interrupt if asked
+    void _complete(NAV_DMA_DESC & desc) {
+        std::atomic_thread_fence(std::memory_order_release);
+        desc.status = NAV_DMA_DESC_STAT_DONE;
+        if (desc.control & NAV_DMA_DESC_CTRL_IRQ) {
+            boost::unique_lock<boost::mutex> guard(irqMutex);
+            irqPending = true;
+            irqCond.notify_all();
+        }
+    }
+
+    // Board-to-host channel: blocks arrive at the DMA bandwidth whether or
+    // not the host keeps up. A block which arrives when the next descriptor
+    // still belongs to the host is dropped, leaving a gap in the sequence.
+    // Block times fall on a grid of block periods from SimEpoch, so that
+    // channels with equal block sizes (on any board) deliver blocks with
+    // equal timetags.
+    void _runToHost() {
+        SimClock::duration period = _xferTime(descs[0].length);
+        SimClock::time_point next = SimEpoch +
+                ((SimClock::now() - SimEpoch) / period + 1) * period;
+        uint32_t ndx = 0;
+        while (running) {
+            NAV_DMA_DESC & desc = descs[ndx];
+            waitUntil(next);
+            SimClock::time_point now = SimClock::now();
+            if (now - next > std::chrono::milliseconds(10)) {
+                // We fell far behind (e.g., descheduled); drop the blocks we
+                // missed rather than trying to catch up
+                uint32_t nMissed = (now - next) / period;
+                next += nMissed * period;
+                sequence += nMissed;
+            }
+            if (desc.status == 0) {
+                _fillSamples(reinterpret_cast<uint8_t *>(desc.busAddr),
+                             desc.length);
+                desc.xferBytes = desc.length;
+                desc.timetag = std::chrono::duration_cast<
+                        std::chrono::nanoseconds>(next - SimEpoch).count();
+                desc.sequence = sequence;
+                _complete(desc);
+                ndx = (ndx + 1) % nDescs;
+            }
+            sequence++;
+            next += period;
+        }
+    }
+
+    // Host-to-board channel: descriptors are consumed in ring order as the
+    // host hands them over, at the DMA bandwidth.
+    void _runFromHost() {
+        uint32_t ndx = 0;
+        SimClock::time_point next = SimClock::now();
+        while (running) {
+            NAV_DMA_DESC & desc = descs[ndx];
+            if (desc.status != 0) {
+                // Nothing queued; poll again shortly
+                boost::this_thread::sleep(boost::posix_time::microseconds(20));
+                next = SimClock::now();
+                continue;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            next += _xferTime(desc.length);
+            waitUntil(next);
+            desc.xferBytes = desc.length;
+            _complete(desc);
+            ndx = (ndx + 1) % nDescs;
+        }
+    }
+
+    // Fill a block with 16-bit I/Q samples of a tone
+    void _fillSamples(uint8_t * dest, uint32_t bytes) {
+        static std::vector<int16_t> tone;
+        static boost::mutex toneMutex;
+        {
+            boost::mutex::scoped_lock guard(toneMutex);
+            if (tone.empty()) {
+                // 1024 I/Q pairs, 16 cycles
+                const int nPairs = 1024;
+                tone.resize(2 * nPairs);
+                for (int i = 0; i < nPairs; i++) {
+                    double phase = 2 * M_PI * 16 * i / nPairs;
+                    tone[2 * i] = int16_t(16000 * cos(phase));
+                    tone[2 * i + 1] = int16_t(16000 * sin(phase));
+                }
+            }
+        }
+        size_t toneBytes = tone.size() * sizeof(int16_t);
+        for (uint32_t offset = 0; offset < bytes; offset += toneBytes) {
+            memcpy(dest + offset, tone.data(),
+                   std::min<size_t>(toneBytes, bytes - offset));
+        }
+    }
+
+    double bytesPerNs;
+    uint64_t descNs;
+    uint32_t irqLatencyNs;
+    boost::mutex irqMutex;
+    boost::condition_variable irqCond;
+    bool irqPending;
+    uint32_t sequence;
+    boost::thread thread;
+};
+
+/// State for one simulated board, shared by all handles opened for it
+class SimBoard {
+public:
+    SimBoard(uint32_t index) :
+        index(index), openCount(0), registers(BAR0_BYTES / 4, 0) {
+        uint32_t * bar0 = registers.data();
+        resource.ipBaseAddr.boardInfo = bar0;
+        resource.ipBaseAddr.userBlock[0] = bar0 + USER_BLOCK_1_OFFSET / 4;
+        resource.ipBaseAddr.userBlock[1] = bar0 + USER_BLOCK_2_OFFSET / 4;
+        resource.pciInfo.BAR0Base = bar0;
+        resource.pciInfo.busNum = 0x10 + index;
+        resource.pciInfo.devNum = 0;
+        resource.pciInfo.funcNum = 0;
+        resource.simBoard = this;
+    }
+
+    // Return the given channel, creating it if necessary
+    SimChannel & channel(uint32_t dir, uint32_t chan) {
+        boost::mutex::scoped_lock guard(mutex);
+        std::unique_ptr<SimChannel> & c = channels[std::make_pair(dir, chan)];
+        if (! c) {
+            c.reset(new SimChannel(dir, chan));
+        }
+        return(*c);
+    }
+
+    const uint32_t index;
+    uint32_t openCount;
+    NAV_BOARD_RESRC resource;
+    std::vector<uint32_t> registers;
+    boost::mutex mutex;
+    std::map<std::pair<uint32_t, uint32_t>, std::unique_ptr<SimChannel> > channels;
+};
+
+// BSP state
+static boost::mutex BspMutex;
+static bool BspStarted = false;
+static NAV_DEVICE_INFO DeviceInfo[NAV_MAX_BOARDS];
+static SimBoard * Boards[NAV_MAX_BOARDS];
+
+static SimBoard *
+simBoard(void * board) {
+    return(static_cast<SimBoard *>(
+            static_cast<NAV_BOARD_RESRC *>(board)->simBoard));
+}
+
+Pentek_xx821Sim::Config
+Pentek_xx821Sim::DefaultConfig() {
+    Config config;
+    config.boardCount = envValue("PENTEK_SIM_BOARDS", 1);
+    config.regReadNs = envValue("PENTEK_SIM_REG_READ_NS", 900);
+    config.regWriteNs = envValue("PENTEK_SIM_REG_WRITE_NS", 60);
+    config.dmaMBytesPerSec = envValue("PENTEK_SIM_DMA_MBPS", 1600);
+    config.dmaDescUs = envValue("PENTEK_SIM_DMA_DESC_US", 2);
+    config.irqLatencyUs = envValue("PENTEK_SIM_IRQ_US", 10);
+    config.startupMs = envValue("PENTEK_SIM_STARTUP_MS", 50);
+    config.findMs = envValue("PENTEK_SIM_FIND_MS", 20);
+    config.openMs = envValue("PENTEK_SIM_OPEN_MS", 100);
+    config.maxReadReqSize = envValue("PENTEK_SIM_MAX_READ_REQ", 512);
+    config.linkSpeed = envValue("PENTEK_SIM_LINK_SPEED", 3);
+    config.linkWidth = envValue("PENTEK_SIM_LINK_WIDTH", 8);
+    config.adcCount = 3;
+    config.ddcCount = 3;
+    config.dacCount = 1;
+    if (config.boardCount > NAV_MAX_BOARDS) {
+        config.boardCount = NAV_MAX_BOARDS;
+    }
+    return(config);
+}
+
+Pentek_xx821Sim::Config
+Pentek_xx821Sim::GetConfig() {
+    boost::mutex::scoped_lock guard(ConfigMutex);
+    return(currentConfig());
+}
+
+void
+Pentek_xx821Sim::SetConfig(const Config & config) {
+    boost::mutex::scoped_lock guard(ConfigMutex);
+    currentConfig() = config;
+    if (currentConfig().boardCount > NAV_MAX_BOARDS) {
+        currentConfig().boardCount = NAV_MAX_BOARDS;
+    }
+    RegReadNs = config.regReadNs;
+    RegWriteNs = config.regWriteNs;
+}
+
+void
+Pentek_xx821Sim::Spin(uint32_t ns) {
+    if (ns == 0) {
+        return;
+    }
+    waitUntil(SimClock::now() + std::chrono::nanoseconds(ns));
+}
+
+uint32_t
+NavSimRegLoad(volatile uint32_t * addr) {
+    Pentek_xx821Sim::Spin(RegReadNs.load(std::memory_order_relaxed));
+    return(*addr);
+}
+
+void
+NavSimRegStore(volatile uint32_t * addr, uint32_t val) {
+    *addr = val;
+    Pentek_xx821Sim::Spin(RegWriteNs.load(std::memory_order_relaxed));
+}
+
+int32_t
+NAV_BoardStartup(void) {
+    boost::mutex::scoped_lock guard(BspMutex);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(
+            Pentek_xx821Sim::GetConfig().startupMs));
+    BspStarted = true;
+    DLOG << "Simulated Navigator BSP started";
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_BoardFinish(void) {
+    boost::mutex::scoped_lock guard(BspMutex);
+    BspStarted = false;
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_BoardFind(uint32_t flags, NAV_DEVICE_INFO ** boardList,
+              int32_t * numBoards) {
+    boost::mutex::scoped_lock guard(BspMutex);
+    if (! BspStarted) {
+        return(NAV_STAT_ERROR);
+    }
+    Pentek_xx821Sim::Config config = Pentek_xx821Sim::GetConfig();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(config.findMs));
+    for (int32_t b = 0; b < config.boardCount; b++) {
+        DeviceInfo[b].index = b;
+        boardList[b] = &DeviceInfo[b];
+    }
+    *numBoards = config.boardCount;
+    return(NAV_STAT_OK);
+}
+
+void *
+NAV_BoardOpen(NAV_DEVICE_INFO * devInfo, uint32_t flags) {
+    if (! devInfo || devInfo->index >= NAV_MAX_BOARDS) {
+        return(NULL);
+    }
+    // Opens of different boards proceed in parallel, as with the real
+    // driver
+    boost::this_thread::sleep(boost::posix_time::milliseconds(
+            Pentek_xx821Sim::GetConfig().openMs));
+
+    boost::mutex::scoped_lock guard(BspMutex);
+    if (! BspStarted) {
+        return(NULL);
+    }
+    SimBoard *& board = Boards[devInfo->index];
+    if (! board) {
+        board = new SimBoard(devInfo->index);
+    }
+    board->openCount++;
+    return(&board->resource);
+}
+
+void *
+NAV_BoardSelect(int32_t numBoards, uint32_t flags, NAV_DEVICE_INFO * devInfo,
+                uint32_t selectFlags) {
+    return(numBoards > 0 ? NAV_BoardOpen(devInfo, flags) : NULL);
+}
+
+int32_t
+NAV_BoardClose(void * board) {
+    boost::mutex::scoped_lock guard(BspMutex);
+    SimBoard * simb = simBoard(board);
+    if (--simb->openCount == 0) {
+        Boards[simb->index] = NULL;
+        delete(simb);
+    }
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAVsys_Init(NAV_SYS_CONTEXT * context) {
+    context->board = -1;
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAVsys_UnInit(NAV_SYS_CONTEXT * context) {
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_GetPcieLinkStatus(void * board, uint32_t * linkSpeed, uint32_t * linkWidth,
+                      uint32_t * maxPayloadSize, uint32_t * maxReadReqSize,
+                      uint32_t * linkStatus) {
+    Pentek_xx821Sim::Config config = Pentek_xx821Sim::GetConfig();
+    *linkSpeed = config.linkSpeed;
+    *linkWidth = config.linkWidth;
+    *maxPayloadSize = 256;
+    *maxReadReqSize = config.maxReadReqSize;
+    *linkStatus = 1;
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_GetBoardSpec(void * board, uint32_t item, int32_t * value) {
+    Pentek_xx821Sim::Config config = Pentek_xx821Sim::GetConfig();
+    switch (item) {
+    case NAV_BOARD_SPEC_ADC_CHAN_COUNT:
+        *value = config.adcCount;
+        return(NAV_STAT_OK);
+    case NAV_BOARD_SPEC_DDC_CHAN_COUNT:
+        *value = config.ddcCount;
+        return(NAV_STAT_OK);
+    case NAV_BOARD_SPEC_DAC_CHAN_COUNT:
+        *value = config.dacCount;
+        return(NAV_STAT_OK);
+    default:
+        return(NAV_STAT_BAD_PARAM);
+    }
+}
+
+int32_t
+NAV_DmaMemAlloc(void * board, uint32_t bytes, void ** virtAddr,
+                uint64_t * busAddr) {
+    // The simulated board reaches host memory by virtual address
+    if (posix_memalign(virtAddr, 4096, (bytes + 4095) & ~4095u) != 0) {
+        *virtAddr = NULL;
+        return(NAV_STAT_NO_MEMORY);
+    }
+    *busAddr = reinterpret_cast<uint64_t>(*virtAddr);
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaMemFree(void * board, void * virtAddr) {
+    free(virtAddr);
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaMemMap(void * board, void * virtAddr, uint32_t bytes,
+              uint64_t * busAddr) {
+    *busAddr = reinterpret_cast<uint64_t>(virtAddr);
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaMemUnmap(void * board, void * virtAddr) {
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaLinkedListSetup(void * board, uint32_t dir, uint32_t chan,
+                       NAV_DMA_DESC * descs, uint32_t nDescs) {
+    if (dir > NAV_DMA_DIR_FROM_HOST || ! descs || nDescs == 0) {
+        return(NAV_STAT_BAD_PARAM);
+    }
+    SimChannel & channel = simBoard(board)->channel(dir, chan);
+    if (channel.running) {
+        return(NAV_STAT_ERROR);
+    }
+    channel.descs = descs;
+    channel.nDescs = nDescs;
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaStart(void * board, uint32_t dir, uint32_t chan) {
+    SimChannel & channel = simBoard(board)->channel(dir, chan);
+    if (! channel.descs) {
+        return(NAV_STAT_ERROR);
+    }
+    if (! channel.running) {
+        channel.start();
+    }
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaStop(void * board, uint32_t dir, uint32_t chan) {
+    simBoard(board)->channel(dir, chan).stop();
+    return(NAV_STAT_OK);
+}
+
+int32_t
+NAV_DmaWaitForInterrupt(void * board, NAV_SYS_CONTEXT * context, uint32_t dir,
+                        uint32_t chan, uint32_t timeoutMs) {
+    return(simBoard(board)->channel(dir, chan).waitForInterrupt(timeoutMs));
+}
+
+int32_t
+NAV820_BusSetup(NAV_BOARD_RESRC * board, uint32_t syncBusMode,
+                uint32_t gateBusMode) {
+    DLOG << "Simulated board " << simBoard(board)->index << " bus mode " <<
+            syncBusMode << "/" << gateBusMode;
+    return(NAV_STAT_OK);
+}
+
+void
+NAVip_BrdInfoRegs_UserLed_SetUserLedEnable(volatile uint32_t * baseBAR0,
+                                           uint32_t enable) {
+    NavRegWrite(baseBAR0 + USER_LED_REG / 4, 0x1, enable);
+}
@@ -0,0 +1,122 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * Pentek_xx821Sim.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PENTEK_XX821SIM_H_
+#define PENTEK_XX821SIM_H_
+
+#include <cstdint>
+
+/// @brief Configuration of the simulated Navigator backend
+///
+/// When the library is built with PENTEK_SIM=yes, the Navigator BSP is
+/// replaced by a simulated board: each board has an in-memory register
+/// file, and each DMA channel is driven by a thread which moves blocks at a
+/// configured bandwidth. Register loads and stores busy-wait for the
+/// configured PCIe transaction latency, so code timed against the simulator
+/// sees costs of the right order of magnitude without a card.
+///
+/// The defaults can be overridden with environment variables, read once
+/// when the program starts:
+/// | Variable                     | Config field    | Default |
+/// |------------------------------|-----------------|---------|
+/// | PENTEK_SIM_BOARDS            | boardCount      | 1       |
+/// | PENTEK_SIM_REG_READ_NS       | regReadNs       | 900     |
+/// | PENTEK_SIM_REG_WRITE_NS      | regWriteNs      | 60      |
+/// | PENTEK_SIM_DMA_MBPS          | dmaMBytesPerSec | 1600    |
+/// | PENTEK_SIM_DMA_DESC_US       | dmaDescUs       | 2       |
+/// | PENTEK_SIM_IRQ_US            | irqLatencyUs    | 10      |
+/// | PENTEK_SIM_STARTUP_MS        | startupMs       | 50      |
+/// | PENTEK_SIM_FIND_MS           | findMs          | 20      |
+/// | PENTEK_SIM_OPEN_MS           | openMs          | 100     |
+/// | PENTEK_SIM_MAX_READ_REQ      | maxReadReqSize  | 512     |
+/// | PENTEK_SIM_LINK_SPEED        | linkSpeed       | 3       |
+/// | PENTEK_SIM_LINK_WIDTH        | linkWidth       | 8       |
+class Pentek_xx821Sim {
+public:
+    /// @brief Simulated board and bus parameters
+    struct Config {
+        /// @brief Number of boards found by NAV_BoardFind()
+        int32_t boardCount;
+        /// @brief Round trip time of a (non-posted) register read, ns
+        uint32_t regReadNs;
+        /// @brief Cost to the CPU of a (posted) register write, ns
+        uint32_t regWriteNs;
+        /// @brief DMA bandwidth of each channel, MB/s
+        double dmaMBytesPerSec;
+        /// @brief Per-descriptor DMA overhead, us
+        uint32_t dmaDescUs;
+        /// @brief Delay from a DMA completion interrupt to the waiting
+        /// thread waking, us
+        uint32_t irqLatencyUs;
+        /// @brief Time taken by NAV_BoardStartup(), ms
+        uint32_t startupMs;
+        /// @brief Time taken by NAV_BoardFind(), ms
+        uint32_t findMs;
+        /// @brief Time taken by NAV_BoardOpen(), ms
+        uint32_t openMs;
+        /// @brief PCIe 'max read request size' reported by
+        /// NAV_GetPcieLinkStatus(), bytes
+        uint32_t maxReadReqSize;
+        /// @brief PCIe link speed reported by NAV_GetPcieLinkStatus()
+        /// (1 = 2.5 GT/s, 2 = 5 GT/s, 3 = 8 GT/s, ...)
+        uint32_t linkSpeed;
+        /// @brief PCIe link width reported by NAV_GetPcieLinkStatus(), lanes
+        uint32_t linkWidth;
+        /// @brief ADC channels per board
+        int32_t adcCount;
+        /// @brief DDC channels per board
+        int32_t ddcCount;
+        /// @brief DAC channels per board
+        int32_t dacCount;
+    };
+
+    /// @brief Return the default configuration, including any overrides
+    /// from PENTEK_SIM_xxx environment variables
+    /// @return the default configuration
+    static Config DefaultConfig();
+
+    /// @brief Return the current configuration
+    /// @return the current configuration
+    static Config GetConfig();
+
+    /// @brief Replace the configuration
+    ///
+    /// Register latencies take effect immediately. DMA parameters take
+    /// effect at the next NAV_DmaStart(), and the remaining parameters at
+    /// the next call of the function they affect.
+    /// @param config the new configuration
+    static void SetConfig(const Config & config);
+
+    /// @brief Busy-wait for the given time
+    /// @param ns the time to wait, in nanoseconds
+    static void Spin(uint32_t ns);
+};
+
+#endif /* PENTEK_XX821SIM_H_ */
@@ -0,0 +1,130 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * nav_common.h
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Stand-in for the Navigator BSP's nav_common.h, declaring the subset of
+ * the Navigator API used by the Pentek_xx821 library and its test
+ * programs. The functions are implemented by the simulated board in
+ * Pentek_xx821Sim.cpp. This directory is put ahead of the BSP in the
+ * include path when building with PENTEK_SIM=yes.
+ */
+
+#ifndef SIM_NAV_COMMON_H_
+#define SIM_NAV_COMMON_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unistd.h>
+
+/// @brief Defined when building against the simulated Navigator backend
+#define NAV_SIM 1
+
+#define NAV_MAX_BOARDS 16
+
+// Status values returned by the NAV_xxx() functions, and their names
+#define NAV_STAT_OK 0
+#define NAV_STAT_ERROR 1
+#define NAV_STAT_TIMEOUT 2
+#define NAV_STAT_BAD_PARAM 3
+#define NAV_STAT_NO_MEMORY 4
+#define NAV_STAT_NOT_RUNNING 5
+extern const char * NavApiStatus[];
+
+// Board spec items for NAV_GetBoardSpec()
+#define NAV_BOARD_SPEC_ADC_CHAN_COUNT 0
+#define NAV_BOARD_SPEC_DDC_CHAN_COUNT 1
+#define NAV_BOARD_SPEC_DAC_CHAN_COUNT 2
+
+typedef struct {
+    /// @brief Index of the board in the simulated system
+    uint32_t index;
+} NAV_DEVICE_INFO;
+
+typedef struct {
+    /// @brief Index of the board the context was initialized for, or -1
+    int32_t board;
+} NAV_SYS_CONTEXT;
+
+typedef struct {
+    void * BAR0Base;
+    uint32_t busNum;
+    uint32_t devNum;
+    uint32_t funcNum;
+} NAV_PCI_INFO;
+
+typedef struct {
+    volatile uint32_t * boardInfo;
+    volatile uint32_t * userBlock[2];
+} NAV_IP_BASE_ADDR;
+
+typedef struct {
+    NAV_IP_BASE_ADDR ipBaseAddr;
+    NAV_PCI_INFO pciInfo;
+    /// @brief The simulator's state for the board
+    void * simBoard;
+} NAV_BOARD_RESRC;
+
+int32_t NAV_BoardStartup(void);
+int32_t NAV_BoardFinish(void);
+int32_t NAV_BoardFind(uint32_t flags, NAV_DEVICE_INFO ** boardList,
+                      int32_t * numBoards);
+void * NAV_BoardOpen(NAV_DEVICE_INFO * devInfo, uint32_t flags);
+void * NAV_BoardSelect(int32_t numBoards, uint32_t flags,
+                       NAV_DEVICE_INFO * devInfo, uint32_t selectFlags);
+int32_t NAV_BoardClose(void * board);
+int32_t NAVsys_Init(NAV_SYS_CONTEXT * context);
+int32_t NAVsys_UnInit(NAV_SYS_CONTEXT * context);
+int32_t NAV_GetPcieLinkStatus(void * board, uint32_t * linkSpeed,
+                              uint32_t * linkWidth, uint32_t * maxPayloadSize,
+                              uint32_t * maxReadReqSize,
+                              uint32_t * linkStatus);
+int32_t NAV_GetBoardSpec(void * board, uint32_t item, int32_t * value);
+
+// Register access. The simulator applies its PCIe latency model to each
+// load and store; a masked write is a read followed by a write, as on the
+// real bus.
+uint32_t NavSimRegLoad(volatile uint32_t * addr);
+void NavSimRegStore(volatile uint32_t * addr, uint32_t val);
+
+static inline void
+NavRegWrite(volatile uint32_t * addr, uint32_t mask, uint32_t val) {
+    if (mask != 0xffffffffUL) {
+        val = (NavSimRegLoad(addr) & ~mask) | (val & mask);
+    }
+    NavSimRegStore(addr, val);
+}
+
+static inline uint32_t
+NavRegRead(volatile uint32_t * addr, uint32_t mask) {
+    return(NavSimRegLoad(addr) & mask);
+}
+
+// The DMA calls are not part of nav_common.h; the library declares the ones
+// it assumes in Pentek_xx821NavDma.h, and the simulator implements them.
+
+#endif /* SIM_NAV_COMMON_H_ */
@@ -0,0 +1,540 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// Copyright UCAR (c) 2018
+// University Corporation for Atmospheric Research (UCAR)
+// National Center for Atmospheric Research (NCAR)
+// Boulder, Colorado, USA
+// BSD licence applies - redistribution and use in source and binary
+// forms, with or without modification, are permitted provided that
+// the following conditions are met:
+// 1) If the software is modified to produce derivative works,
+// such modified software should be clearly marked, so as not
+// to confuse it with the version available from UCAR.
+// 2) Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// 3) Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+// 4) Neither the name of UCAR nor the names of its contributors,
+// if any, may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+
+// Register and DMA microbenchmarks for Pentek xx821 boards, with results
+// written as JSON so that runs can be compared across driver, BIOS and
+// library versions. Built against the simulated Navigator backend
+// (PENTEK_SIM=yes), it runs without a card.
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <boost/program_options.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/thread.hpp>
+#include <logx/Logging.h>
+#include <Pentek_xx821.h>
+#include <Pentek_xx821Dn.h>
+#include <Pentek_xx821Manager.h>
+#include <Pentek_xx821Up.h>
+#ifdef NAV_SIM
+#include <Pentek_xx821Sim.h>
+#endif
+
+using namespace std;
+namespace po = boost::program_options;
+
+LOGGING("bench_xx821")
+
+typedef std::chrono::steady_clock Clock;
+
+int _boardNum = 0;              ///< board to benchmark
+int _nOpenBoards = 0;           ///< boards to open in the startup test (0 = all)
+int _nIterations = 100000;      ///< timed register accesses per test
+int _nThreads = 4;              ///< threads in the register cache contention test
+double _dmaSeconds = 1.0;       ///< run time for each DMA test (secs)
+string _blockSizesString = "4096,16384,65536,262144,1048576";
+                                ///< DMA block sizes to test
+uint32_t _readReg = 0x0;        ///< register address for read tests
+string _writeRegString;         ///< register address for write tests
+bool _doTx = false;             ///< run the DAC transmit test
+string _outFile;                ///< JSON output file ("" = stdout)
+bool _exitNow = false;          ///< early exit if this becomes true
+
+/// Subclass which gives the benchmark access to the register interface
+class BenchBoard : public Pentek_xx821 {
+public:
+    BenchBoard(uint16_t boardNum) : Pentek_xx821(boardNum) {}
+
+    using Pentek_xx821::readLiteRegister_;
+    using Pentek_xx821::writeLiteRegister_;
+    using Pentek_xx821::writeLiteRegisterBlock_;
+    using Pentek_xx821::_declareCacheableRegisters;
+
+    /// Return the first register address of the board info registers (0),
+    /// USER BLOCK 1 (1) or USER BLOCK 2 (2)
+    uint32_t regionStart(int region) const {
+        volatile uint32_t * base[] = {
+            _boardInfoRegBase(), _userBlock1Base(), _userBlock2Base()
+        };
+        return(4 * (base[region] - _boardInfoRegBase()));
+    }
+};
+
+/// Parse the command line options
+void parseOptions(int argc, char** argv)
+{
+    // get the options
+    po::options_description descripts("Options");
+    descripts.add_options()
+            ("help", "Describe options")
+            ("board", po::value<int>(&_boardNum), "Board to benchmark [0]")
+            ("nOpenBoards", po::value<int>(&_nOpenBoards),
+             "# of boards to open in the startup test [all]")
+            ("iterations", po::value<int>(&_nIterations),
+             "Timed register accesses per test [100000]")
+            ("threads", po::value<int>(&_nThreads),
+             "Threads in the register cache contention test [4]")
+            ("dmaSeconds", po::value<double>(&_dmaSeconds),
+             "Run time for each DMA test, s [1.0]")
+            ("blockSizes", po::value<string>(&_blockSizesString),
+             "Comma-separated DMA block sizes, bytes [4096,...,1048576]")
+            ("readReg", po::value<uint32_t>(&_readReg),
+             "Register address for read tests [0]")
+            ("writeReg", po::value<string>(&_writeRegString),
+             "Register address for write tests; write tests are skipped if "
+             "not given, except with the simulator")
+            ("tx", po::bool_switch(&_doTx),
+             "Run the DAC transmit test (always run with the simulator)")
+            ("out", po::value<string>(&_outFile),
+             "JSON output file [stdout]")
+            ;
+
+    po::variables_map vm;
+    po::command_line_parser parser(argc, argv);
+    po::positional_options_description pd;
+    po::store(parser.options(descripts).positional(pd).run(), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        cout << "Usage: " << argv[0] <<
+                " [OPTION]..." << endl;
+        cout << descripts << endl;
+        exit(0);
+    }
+}
+
+/// Interrupt handler to trigger early exit
+void
+onInterrupt(int signal) {
+    ILOG << "Exiting early on " << strsignal(signal) << " signal";
+    _exitNow = true;
+}
+
+/// Return the time in seconds since the given time point
+double
+secondsSince(const Clock::time_point & start) {
+    return(chrono::duration<double>(Clock::now() - start).count());
+}
+
+/// Return the given percentile of the (sorted) samples
+double
+percentile(const vector<double> & sorted, double pct) {
+    if (sorted.empty()) {
+        return(0.0);
+    }
+    size_t ndx = size_t(pct / 100.0 * (sorted.size() - 1) + 0.5);
+    return(sorted[ndx]);
+}
+
+/// Return a JSON object with the latency percentiles (ns) of the samples
+string
+latencyJson(vector<double> & samples) {
+    sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double s : samples) {
+        sum += s;
+    }
+    ostringstream os;
+    os << "{\"count\": " << samples.size() <<
+          ", \"mean_ns\": " << (samples.empty() ? 0.0 : sum / samples.size()) <<
+          ", \"p50_ns\": " << percentile(samples, 50) <<
+          ", \"p99_ns\": " << percentile(samples, 99) <<
+          ", \"p99_9_ns\": " << percentile(samples, 99.9) <<
+          ", \"max_ns\": " << (samples.empty() ? 0.0 : samples.back()) << "}";
+    return(os.str());
+}
+
+/// Time each call of op() individually
+template <class OP>
+vector<double>
+timeEach(int n, OP op) {
+    vector<double> samples;
+    samples.reserve(n);
+    for (int i = 0; i < n && ! _exitNow; i++) {
+        Clock::time_point t0 = Clock::now();
+        op(i);
+        samples.push_back(chrono::duration<double, nano>(Clock::now() - t0).count());
+    }
+    return(samples);
+}
+
+/// Startup test: cold open of one board, then serial and parallel opens of
+/// all boards with the BSP already started and the boards enumerated
+string
+benchStartup() {
+    ostringstream os;
+    Clock::time_point start = Clock::now();
+    double coldTotal;
+    Pentek_xx821::OpenTiming cold;
+    {
+        Pentek_xx821 board(_boardNum);
+        coldTotal = secondsSince(start);
+        cold = board.openTiming();
+    }
+    os << "{\"cold_open_s\": " << coldTotal <<
+          ", \"cold_phases_s\": {\"startup\": " << cold.startup <<
+          ", \"find\": " << cold.find << ", \"open\": " << cold.open <<
+          ", \"sys_init\": " << cold.sysInit <<
+          ", \"link_status\": " << cold.linkStatus <<
+          ", \"board_spec\": " << cold.boardSpec << "}";
+
+    Pentek_xx821Manager manager;
+    int nBoards = manager.boardCount();
+    if (_nOpenBoards > 0 && _nOpenBoards < nBoards) {
+        nBoards = _nOpenBoards;
+    }
+    vector<uint16_t> boardNums;
+    for (int b = 0; b < nBoards; b++) {
+        boardNums.push_back(b);
+    }
+
+    start = Clock::now();
+    {
+        vector<unique_ptr<Pentek_xx821> > boards;
+        for (uint16_t b : boardNums) {
+            boards.emplace_back(new Pentek_xx821(b));
+        }
+    }
+    double serial = secondsSince(start);
+    {
+        vector<unique_ptr<Pentek_xx821> > boards =
+                manager.openBoards<Pentek_xx821>(boardNums);
+    }
+    os << ", \"boards\": " << nBoards <<
+          ", \"enumeration_s\": " << manager.enumerationTime() <<
+          ", \"serial_open_s\": " << serial <<
+          ", \"parallel_open_s\": " << manager.lastOpenTime() << "}";
+    return(os.str());
+}
+
+/// Register tests: per-access latency of reads and writes, block write
+/// throughput compared with single writes and with the original per-word
+/// string-building block write, and cached access from several threads to
+/// one region or to separate regions
+string
+benchRegisters(BenchBoard & board, bool doWrites, uint32_t writeReg) {
+    ostringstream os;
+    vector<double> samples = timeEach(_nIterations, [&board](int) {
+        board.readLiteRegister_(_readReg);
+    });
+    os << "{\"read\": " << latencyJson(samples);
+
+    if (doWrites) {
+        samples = timeEach(_nIterations, [&board, writeReg](int i) {
+            board.writeLiteRegister_(writeReg, uint32_t(i));
+        });
+        os << ", \"write\": " << latencyJson(samples);
+
+        // 64 consecutive registers: written the way the original block
+        // write did it (building an action string for every word), then
+        // one at a time, then as a block
+        const int nWords = 64;
+        vector<uint32_t> vals(nWords);
+        for (int w = 0; w < nWords; w++) {
+            vals[w] = w;
+        }
+        int nBlocks = max(1, _nIterations / nWords);
+        const string action("bench block write");
+        Clock::time_point start = Clock::now();
+        for (int b = 0; b < nBlocks; b++) {
+            for (int w = 0; w < nWords; w++) {
+                ostringstream oss;
+                oss << action << " at ndx " << w;
+                board.writeLiteRegister_(writeReg + 4 * w, vals[w], oss.str());
+            }
+        }
+        double baseline = secondsSince(start);
+        start = Clock::now();
+        for (int b = 0; b < nBlocks; b++) {
+            for (int w = 0; w < nWords; w++) {
+                board.writeLiteRegister_(writeReg + 4 * w, vals[w]);
+            }
+        }
+        double single = secondsSince(start);
+        start = Clock::now();
+        for (int b = 0; b < nBlocks; b++) {
+            board.writeLiteRegisterBlock_(writeReg, vals.data(), nWords);
+        }
+        double block = secondsSince(start);
+        double nWritten = double(nBlocks) * nWords;
+        os << ", \"block_write\": {\"words_per_block\": " << nWords <<
+              ", \"baseline_mwords_per_s\": " <<
+              nWritten / baseline / 1.0e6 <<
+              ", \"single_mwords_per_s\": " << nWritten / single / 1.0e6 <<
+              ", \"block_mwords_per_s\": " << nWritten / block / 1.0e6 << "}";
+    }
+
+    // Cached reads from several threads, first all in one region, then
+    // spread across the regions
+    board._declareCacheableRegisters(board.regionStart(0), 4);
+    board._declareCacheableRegisters(board.regionStart(1), 4);
+    board._declareCacheableRegisters(board.regionStart(2), 4);
+    board.enableRegisterCache(true);
+    os << ", \"cached_read_threads\": " << _nThreads;
+    for (int spread = 0; spread < 2; spread++) {
+        boost::barrier barrier(_nThreads + 1);
+        boost::thread_group threads;
+        for (int t = 0; t < _nThreads; t++) {
+            uint32_t regaddr = board.regionStart(spread ? t % 3 : 0);
+            threads.create_thread([&board, &barrier, regaddr]() {
+                barrier.wait();
+                for (int i = 0; i < _nIterations; i++) {
+                    board.readLiteRegister_(regaddr);
+                }
+            });
+        }
+        Clock::time_point start = Clock::now();
+        barrier.wait();
+        threads.join_all();
+        double mops = double(_nThreads) * _nIterations / secondsSince(start) / 1.0e6;
+        os << (spread ? ", \"cached_read_spread_mops\": " :
+                        ", \"cached_read_one_region_mops\": ") << mops;
+    }
+    board.enableRegisterCache(false);
+    os << "}";
+    return(os.str());
+}
+
+/// DMA receive test for one block size
+string
+benchRx(BenchBoard & board, uint32_t blockBytes) {
+    Pentek_xx821Dn dn(board, 0, 8, blockBytes);
+    if (! dn.start()) {
+        return("null");
+    }
+    Pentek_xx821Dn::RxBlock block;
+    uint64_t bytes = 0;
+    Clock::time_point start = Clock::now();
+    while (secondsSince(start) < _dmaSeconds && ! _exitNow) {
+        if (dn.acquireBlock(block, 100)) {
+            bytes += block.bytes;
+            dn.releaseBlock(block);
+        }
+    }
+    double elapsed = secondsSince(start);
+    dn.stop();
+    ostringstream os;
+    os << "{\"block_bytes\": " << blockBytes <<
+          ", \"mbytes_per_s\": " << bytes / elapsed / 1.0e6 <<
+          ", \"blocks\": " << dn.blockCount() <<
+          ", \"overruns\": " << dn.overrunCount() <<
+          ", \"dropped_blocks\": " << dn.droppedBlockCount() << "}";
+    return(os.str());
+}
+
+/// Completion mode test: receive with the given completion mode and block
+/// size, reporting throughput, wait latency and the CPU time used by the
+/// receiving thread
+string
+benchCompletionMode(BenchBoard & board, Pentek_xx821::CompletionMode mode,
+                    uint32_t blockBytes) {
+    static const char * modeNames[] = { "interrupt", "poll", "adaptive" };
+    board.setCompletionMode(mode);
+    Pentek_xx821Telemetry::Snapshot before = board.telemetry().snapshot();
+
+    Pentek_xx821Dn dn(board, 0, 8, blockBytes);
+    if (! dn.start()) {
+        return("null");
+    }
+    Pentek_xx821Dn::RxBlock block;
+    uint64_t bytes = 0;
+    timespec cpu0;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu0);
+    Clock::time_point start = Clock::now();
+    while (secondsSince(start) < _dmaSeconds && ! _exitNow) {
+        if (dn.acquireBlock(block, 100)) {
+            bytes += block.bytes;
+            dn.releaseBlock(block);
+        }
+    }
+    double elapsed = secondsSince(start);
+    timespec cpu1;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu1);
+    dn.stop();
+    board.setCompletionMode(Pentek_xx821::COMPLETION_INTERRUPT);
+
+    // Wait latencies recorded during this test only
+    Pentek_xx821Telemetry::Snapshot snap = board.telemetry().snapshot();
+    for (uint32_t b = 0; b < Pentek_xx821Telemetry::HIST_BUCKETS; b++) {
+        snap.histograms[Pentek_xx821Telemetry::HIST_RX_WAIT][b] -=
+                before.histograms[Pentek_xx821Telemetry::HIST_RX_WAIT][b];
+    }
+    double cpuSecs = (cpu1.tv_sec - cpu0.tv_sec) +
+            1.0e-9 * (cpu1.tv_nsec - cpu0.tv_nsec);
+    ostringstream os;
+    os << "{\"mode\": \"" << modeNames[mode] << "\"" <<
+          ", \"block_bytes\": " << blockBytes <<
+          ", \"mbytes_per_s\": " << bytes / elapsed / 1.0e6 <<
+          ", \"cpu_fraction\": " << cpuSecs / elapsed <<
+          ", \"wait_p50_ns\": " <<
+          snap.percentile(Pentek_xx821Telemetry::HIST_RX_WAIT, 50) <<
+          ", \"wait_p99_ns\": " <<
+          snap.percentile(Pentek_xx821Telemetry::HIST_RX_WAIT, 99) <<
+          ", \"overruns\": " << dn.overrunCount() << "}";
+    return(os.str());
+}
+
+/// DMA transmit test for one block size
+string
+benchTx(BenchBoard & board, uint32_t blockBytes) {
+    Pentek_xx821Up up(board, 0, 4, blockBytes);
+    if (! up.start()) {
+        return("null");
+    }
+    // Play silence
+    Pentek_xx821Up::TxBlock block;
+    uint64_t bytes = 0;
+    Clock::time_point start = Clock::now();
+    while (secondsSince(start) < _dmaSeconds && ! _exitNow) {
+        if (up.acquireBuffer(block, 100)) {
+            memset(block.data, 0, blockBytes);
+            up.submitBuffer(block, blockBytes);
+            bytes += blockBytes;
+        }
+    }
+    double elapsed = secondsSince(start);
+    up.stop();
+    ostringstream os;
+    os << "{\"block_bytes\": " << blockBytes <<
+          ", \"mbytes_per_s\": " << bytes / elapsed / 1.0e6 <<
+          ", \"blocks\": " << up.blockCount() <<
+          ", \"underruns\": " << up.underrunCount() <<
+          ", \"segments\": " << up.segmentCount() << "}";
+    return(os.str());
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    // parse the command line options, substituting for config params.
+    parseOptions(argc, argv);
+
+    // Exit early if an interrupt signal (^C) is received
+    signal(SIGINT, onInterrupt);
+
+    // Writes and transmission are only safe on real hardware if asked for
+    bool doWrites = ! _writeRegString.empty();
+    uint32_t writeReg = doWrites ? stoul(_writeRegString, 0, 0) : 0;
+#ifdef NAV_SIM
+    const bool simulated = true;
+    _doTx = true;
+#else
+    const bool simulated = false;
+#endif
+
+    vector<uint32_t> blockSizes;
+    istringstream sizes(_blockSizesString);
+    string size;
+    while (getline(sizes, size, ',')) {
+        blockSizes.push_back(stoul(size, 0, 0));
+    }
+
+    ostringstream json;
+    json << setprecision(6);
+    json << "{\n  \"simulated\": " << (simulated ? "true" : "false");
+#ifdef NAV_SIM
+    Pentek_xx821Sim::Config simConfig = Pentek_xx821Sim::GetConfig();
+    json << ",\n  \"sim_config\": {\"reg_read_ns\": " << simConfig.regReadNs <<
+            ", \"reg_write_ns\": " << simConfig.regWriteNs <<
+            ", \"dma_mbytes_per_s\": " << simConfig.dmaMBytesPerSec <<
+            ", \"open_ms\": " << simConfig.openMs <<
+            ", \"boards\": " << simConfig.boardCount << "}";
+#endif
+
+    // The startup test must run while no other board object exists
+    ILOG << "Startup test";
+    json << ",\n  \"startup\": " << benchStartup();
+
+    BenchBoard board(_boardNum);
+#ifdef NAV_SIM
+    if (! doWrites) {
+        // Scratch register in the simulated board's USER BLOCK 1
+        doWrites = true;
+        writeReg = board.regionStart(1);
+    }
+#endif
+    json << ",\n  \"board\": {\"number\": " << _boardNum <<
+            ", \"pci_address\": \"" << board.pciAddress() << "\"" <<
+            ", \"numa_node\": " << board.numaNode() <<
+            ", \"dma_read_segment_bytes\": " << board.dmaReadSegmentBytes() << "}";
+
+    ILOG << "Register tests";
+    json << ",\n  \"registers\": " << benchRegisters(board, doWrites, writeReg);
+
+    ILOG << "DMA receive tests";
+    json << ",\n  \"dma_rx\": [";
+    for (size_t s = 0; s < blockSizes.size() && ! _exitNow; s++) {
+        json << (s ? ", " : "") << benchRx(board, blockSizes[s]);
+    }
+    json << "]";
+
+    ILOG << "DMA completion mode tests";
+    json << ",\n  \"completion_modes\": [";
+    const Pentek_xx821::CompletionMode modes[] = {
+        Pentek_xx821::COMPLETION_INTERRUPT,
+        Pentek_xx821::COMPLETION_POLL,
+        Pentek_xx821::COMPLETION_ADAPTIVE
+    };
+    bool first = true;
+    for (Pentek_xx821::CompletionMode mode : modes) {
+        for (size_t s = 0; s < blockSizes.size() && ! _exitNow; s++) {
+            json << (first ? "" : ", ") <<
+                    benchCompletionMode(board, mode, blockSizes[s]);
+            first = false;
+        }
+    }
+    json << "]";
+
+    if (_doTx && board.dacCount() > 0) {
+        ILOG << "DMA transmit tests";
+        json << ",\n  \"dma_tx\": [";
+        for (size_t s = 0; s < blockSizes.size() && ! _exitNow; s++) {
+            json << (s ? ", " : "") << benchTx(board, blockSizes[s]);
+        }
+        json << "]";
+    }
+    json << "\n}\n";
+
+    if (_outFile.empty()) {
+        cout << json.str();
+    } else {
+        ofstream out(_outFile.c_str());
+        out << json.str();
+        ILOG << "Results written to " << _outFile;
+    }
+    return(0);
+}
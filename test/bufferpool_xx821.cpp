@@ -0,0 +1,257 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * bufferpool_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Exercise Pentek_xx821BufferPool without a board: block layout, the
+ * lock-free free list (single-threaded and with several threads allocating
+ * and releasing at once), and busAddress() through a stand-in map function
+ * which gives each arena a distinct fake bus address. The map function
+ * checks need hugepages reserved in /proc/sys/vm/nr_hugepages; without
+ * them, the program checks that a pool with a map function is refused.
+ * Exits with status 1 if any check fails.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include <boost/thread/thread.hpp>
+#include <logx/Logging.h>
+
+#include <Pentek_xx821BufferPool.h>
+
+using namespace std;
+
+LOGGING("bufferpool_xx821")
+
+typedef Pentek_xx821BufferPool Pool;
+
+int _nChecks = 0;   ///< checks made
+int _nBad = 0;      ///< checks failed
+
+/// Count a check, logging it if it failed
+void
+check(bool ok, const char * what) {
+    _nChecks++;
+    if (! ok) {
+        ELOG << "FAILED: " << what;
+        _nBad++;
+    }
+}
+
+/// Take every block from a pool, checking that the blocks are aligned and
+/// don't overlap, and that the pool is then empty
+vector<uint8_t *>
+takeAll(Pool & pool) {
+    vector<uint8_t *> blocks;
+    while (uint8_t * b = static_cast<uint8_t *>(pool.allocate())) {
+        blocks.push_back(b);
+    }
+    check(blocks.size() == pool.blockCount(), "every block can be taken");
+    check(pool.freeCount() == 0, "free count is zero when empty");
+    check(pool.allocate() == NULL, "allocate() from empty pool is NULL");
+
+    vector<uint8_t *> sorted(blocks);
+    sort(sorted.begin(), sorted.end());
+    bool aligned = true;
+    bool disjoint = true;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        aligned &= (uintptr_t(sorted[i]) % Pool::BLOCK_ALIGNMENT) == 0;
+        if (i > 0) {
+            disjoint &= sorted[i] >= sorted[i - 1] + pool.blockBytes();
+        }
+    }
+    check(aligned, "blocks are aligned");
+    check(disjoint, "blocks don't overlap");
+    return(blocks);
+}
+
+/// Return blocks to a pool
+void
+releaseAll(Pool & pool, const vector<uint8_t *> & blocks) {
+    for (uint8_t * b : blocks) {
+        pool.release(b);
+    }
+    check(pool.freeCount() == pool.blockCount(), "all blocks returned");
+}
+
+/// The free list, single-threaded and with concurrent users
+void
+checkFreeList() {
+    // 1000-byte blocks round up to 1024, so 2048 fit in an arena and 5000
+    // need three arenas
+    Pool pool(1000, 5000);
+    check(pool.blockBytes() == 1024, "block size rounded up");
+    check(pool.freeCount() == 5000, "all blocks free at start");
+    check(pool.busAddress(NULL) == 0, "no bus address without map function");
+
+    vector<uint8_t *> blocks = takeAll(pool);
+
+    // Released blocks come back, and nothing else does
+    pool.release(blocks[17]);
+    pool.release(blocks[4000]);
+    check(pool.freeCount() == 2, "free count after release");
+    set<uint8_t *> again = { static_cast<uint8_t *>(pool.allocate()),
+                             static_cast<uint8_t *>(pool.allocate()) };
+    check(again == set<uint8_t *>({ blocks[17], blocks[4000] }),
+          "released blocks are handed out again");
+    check(pool.allocate() == NULL, "no other blocks handed out");
+
+    int notFromPool;
+    pool.release(&notFromPool);
+    check(pool.freeCount() == 0, "foreign pointer is not taken");
+
+    releaseAll(pool, blocks);
+
+    // Threads taking and returning blocks at once must never share one.
+    // Each writes its id into the blocks it holds and checks it is still
+    // there before releasing them.
+    const int nThreads = 4;
+    const int nRounds = 20000;
+    atomic<int> nShared(0);
+    vector<unique_ptr<boost::thread> > threads;
+    for (int t = 0; t < nThreads; t++) {
+        threads.emplace_back(new boost::thread([&pool, &nShared, t]() {
+            vector<uint32_t *> held;
+            for (int r = 0; r < nRounds; r++) {
+                for (int n = 0; n < 1 + r % 7; n++) {
+                    uint32_t * b = static_cast<uint32_t *>(pool.allocate());
+                    if (b) {
+                        *b = t;
+                        held.push_back(b);
+                    }
+                }
+                for (uint32_t * b : held) {
+                    if (*b != uint32_t(t)) {
+                        nShared++;
+                    }
+                    pool.release(b);
+                }
+                held.clear();
+            }
+        }));
+    }
+    for (auto & thread : threads) {
+        thread->join();
+    }
+    check(nShared == 0, "concurrent users never share a block");
+    check(pool.freeCount() == pool.blockCount(),
+          "all blocks free after concurrent use");
+    releaseAll(pool, takeAll(pool));
+    ILOG << "free list checks done";
+}
+
+/// busAddress() through a stand-in map function
+void
+checkBusAddresses() {
+    // Give arena n the fake bus address (n + 1) << 32, and remember the
+    // calls
+    map<void *, uint64_t> mapped;
+    size_t nBadSizes = 0;
+    int nUnmapped = 0;
+    Pool::MapFunction mapFunc =
+            [&mapped, &nBadSizes](void * mem, size_t bytes, uint64_t & bus) {
+        nBadSizes += (bytes != Pool::ARENA_BYTES);
+        bus = uint64_t(mapped.size() + 1) << 32;
+        mapped[mem] = bus;
+        return(true);
+    };
+    Pool::UnmapFunction unmapFunc = [&nUnmapped](void *) { nUnmapped++; };
+
+    std::unique_ptr<Pool> pool;
+    try {
+        pool.reset(new Pool(300000, 20, -1, mapFunc, unmapFunc));
+    } catch (Pool::ConstructError & e) {
+        ILOG << e.what();
+        check(mapped.empty(), "nothing mapped when pool is refused");
+        ILOG << "No 2 MB hugepages available; skipping bus address checks";
+        return;
+    }
+    check(pool->hugePages(), "pool with map function uses hugepages");
+
+    // 300000-byte blocks (300032 after rounding): six to an arena, so 20
+    // blocks need four arenas, each mapped once as a whole page
+    check(mapped.size() == 4, "map function called once per arena");
+    check(nBadSizes == 0, "map function given whole 2 MB pages");
+
+    vector<uint8_t *> blocks = takeAll(*pool);
+    int nBadBus = 0;
+    for (uint8_t * b : blocks) {
+        // The block's arena is the mapped page at or below it
+        map<void *, uint64_t>::iterator it = mapped.upper_bound(b);
+        --it;
+        uint8_t * page = static_cast<uint8_t *>(it->first);
+        bool inPage = b + pool->blockBytes() <= page + Pool::ARENA_BYTES;
+        if (! inPage || pool->busAddress(b) != it->second + (b - page)) {
+            nBadBus++;
+        }
+    }
+    check(nBadBus == 0, "block bus address is its page's plus offset");
+    int notFromPool;
+    check(pool->busAddress(&notFromPool) == 0,
+          "no bus address for a foreign pointer");
+    releaseAll(*pool, blocks);
+    pool.reset();
+    check(nUnmapped == 4, "each arena unmapped on destruction");
+    ILOG << "bus address checks done";
+}
+
+/// Blocks which could not lie within one hugepage are refused
+void
+checkLimits() {
+    bool refused = false;
+    try {
+        Pool pool(Pool::ARENA_BYTES + 1, 2);
+    } catch (Pool::ConstructError & e) {
+        refused = true;
+    }
+    check(refused, "blocks larger than an arena are refused");
+
+    Pool pool(Pool::ARENA_BYTES, 2);
+    check(pool.blockBytes() == Pool::ARENA_BYTES, "arena-sized blocks work");
+    releaseAll(pool, takeAll(pool));
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    checkFreeList();
+    checkBusAddresses();
+    checkLimits();
+
+    cout << "bufferpool_xx821: " << _nChecks << " checks, " << _nBad <<
+            " failed" << endl;
+    return(_nBad ? 1 : 0);
+}
@@ -0,0 +1,252 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * decimate_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Check Pentek_xx821Decimator against a double-precision reference filter
+ * over a stream fed in blocks of random size, then report its throughput
+ * decimating a set of channels with a given number of workers. Exits with
+ * status 1 if the check fails.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <logx/Logging.h>
+
+#include <Pentek_xx821Decimator.h>
+
+using namespace std;
+namespace po = boost::program_options;
+
+LOGGING("decimate_xx821")
+
+uint32_t _nTaps = 96;           ///< filter taps in timing runs
+uint32_t _decimation = 4;       ///< decimation factor in timing runs
+uint32_t _nChannels = 4;        ///< channels in timing runs
+uint32_t _nWorkers = 1;         ///< workers in timing runs
+uint32_t _blockPairs = 16384;   ///< I/Q pairs per block in timing runs
+double _seconds = 1.0;          ///< duration of timing runs
+
+/// Parse the command line options
+void parseOptions(int argc, char** argv)
+{
+    po::options_description descripts("Options");
+    descripts.add_options()
+            ("help", "Describe options")
+            ("taps", po::value<uint32_t>(&_nTaps),
+                    "Filter taps when timing [96]")
+            ("decimation", po::value<uint32_t>(&_decimation),
+                    "Decimation factor when timing [4]")
+            ("channels", po::value<uint32_t>(&_nChannels),
+                    "Channels when timing [4]")
+            ("workers", po::value<uint32_t>(&_nWorkers),
+                    "Worker threads when timing [1]")
+            ("blockPairs", po::value<uint32_t>(&_blockPairs),
+                    "I/Q pairs per block when timing [16384]")
+            ("seconds", po::value<double>(&_seconds),
+                    "Duration of the timing run, s [1.0]")
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, descripts), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        cout << "Usage: " << argv[0] << " [OPTION]..." << endl;
+        cout << descripts << endl;
+        exit(0);
+    }
+}
+
+/// Return windowed-sinc low-pass taps for a decimation factor
+vector<float>
+lowPassTaps(uint32_t nTaps, uint32_t decimation) {
+    vector<float> taps(nTaps);
+    double center = (nTaps - 1) / 2.0;
+    for (uint32_t t = 0; t < nTaps; t++) {
+        double x = (t - center) / decimation;
+        double sinc = (x == 0.0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+        double window = (nTaps == 1) ? 1.0 :
+                0.54 - 0.46 * cos(2 * M_PI * t / (nTaps - 1));
+        taps[t] = sinc * window / decimation;
+    }
+    return(taps);
+}
+
+/// Decimate a whole stream (of I/Q pairs) in double precision, with the
+/// first output at the first sample
+vector<complex<double> >
+referenceDecimate(const vector<complex<double> > & in,
+                  const vector<float> & taps, uint32_t decimation) {
+    vector<complex<double> > out;
+    for (size_t n = 0; n < in.size(); n += decimation) {
+        complex<double> sum = 0.0;
+        for (size_t k = 0; k < taps.size() && k <= n; k++) {
+            sum += double(taps[k]) * in[n - k];
+        }
+        out.push_back(sum);
+    }
+    return(out);
+}
+
+/// Check the decimator for one filter, with int16 and float input fed in
+/// blocks of random size. Return the number of mismatches found.
+int
+checkFilter(uint32_t nTaps, uint32_t decimation, mt19937 & rng) {
+    vector<float> taps = lowPassTaps(nTaps, decimation);
+    Pentek_xx821Decimator::Config config =
+            Pentek_xx821Decimator::DefaultConfig(taps, decimation, 2, 6000);
+    Pentek_xx821Decimator decimator(config);
+
+    // Channel 0 gets int16 samples and channel 1 the same samples as float
+    uniform_int_distribution<int> sampleDist(INT16_MIN, INT16_MAX);
+    const size_t nPairs = 20000;
+    vector<int16_t> iq(2 * nPairs);
+    vector<complex<float> > fIq(nPairs);
+    vector<complex<double> > dIq(nPairs);
+    Pentek_xx821Unpack::Correction corr = config.correction;
+    for (size_t p = 0; p < nPairs; p++) {
+        iq[2 * p] = int16_t(sampleDist(rng));
+        iq[2 * p + 1] = int16_t(sampleDist(rng));
+        fIq[p] = complex<float>(iq[2 * p] * corr.gainI,
+                                iq[2 * p + 1] * corr.gainQ);
+        dIq[p] = complex<double>(fIq[p]);
+    }
+    vector<complex<double> > ref = referenceDecimate(dIq, taps, decimation);
+
+    // Blocks range from empty to well past the decimator's work buffer
+    uniform_int_distribution<size_t> blockDist(0, 6000);
+    vector<complex<float> > got[2];
+    size_t offset = 0;
+    while (offset < nPairs) {
+        size_t n = min(blockDist(rng), nPairs - offset);
+        const Pentek_xx821Decimator::Output & out0 =
+                decimator.processChannel(0, iq.data() + 2 * offset, n, 0);
+        got[0].insert(got[0].end(), out0.samples, out0.samples + out0.count);
+        const Pentek_xx821Decimator::Output & out1 =
+                decimator.processFloatChannel(1, fIq.data() + offset, n, 0);
+        got[1].insert(got[1].end(), out1.samples, out1.samples + out1.count);
+        offset += n;
+    }
+
+    // Allow for float rounding in a sum of nTaps products of magnitude up
+    // to about 1
+    double tolerance = 1.0e-6 * (nTaps + 4);
+    int nBad = 0;
+    for (int c = 0; c < 2; c++) {
+        if (got[c].size() != ref.size()) {
+            ELOG << nTaps << " taps, decimation " << decimation <<
+                    ", channel " << c << ": " << got[c].size() <<
+                    " outputs, expected " << ref.size();
+            nBad++;
+            continue;
+        }
+        for (size_t s = 0; s < ref.size(); s++) {
+            if (abs(complex<double>(got[c][s]) - ref[s]) > tolerance) {
+                if (nBad++ < 10) {
+                    ELOG << nTaps << " taps, decimation " << decimation <<
+                            ", channel " << c << ": output " << s << " is " <<
+                            got[c][s] << ", expected " << ref[s];
+                }
+            }
+        }
+    }
+    return(nBad);
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    parseOptions(argc, argv);
+
+    ILOG << "Filter kernels: " << Pentek_xx821Unpack::IsaName(
+            Pentek_xx821Unpack::ActiveIsa());
+
+    // Tap counts chosen to exercise each kernel's vector loops and tails
+    mt19937 rng(821);
+    int nBad = 0;
+    uint32_t tapCounts[] = { 1, 3, 4, 7, 8, 12, 16, 31, 64, 127 };
+    uint32_t decimations[] = { 1, 3, 8 };
+    for (uint32_t nTaps : tapCounts) {
+        for (uint32_t decimation : decimations) {
+            nBad += checkFilter(nTaps, decimation, rng);
+        }
+    }
+    ILOG << "Reference check: " << (nBad ? "FAILED" : "ok");
+
+    // Throughput, with every channel decimating the same block
+    Pentek_xx821Decimator::Config config =
+            Pentek_xx821Decimator::DefaultConfig(
+                    lowPassTaps(_nTaps, _decimation), _decimation,
+                    _nChannels, _blockPairs);
+    config.nWorkers = _nWorkers;
+    Pentek_xx821Decimator decimator(config);
+
+    uniform_int_distribution<int> sampleDist(INT16_MIN, INT16_MAX);
+    vector<int16_t> iq(2 * _blockPairs);
+    for (size_t s = 0; s < iq.size(); s++) {
+        iq[s] = int16_t(sampleDist(rng));
+    }
+    vector<Pentek_xx821Dn::RxBlock> blocks(_nChannels);
+    vector<const Pentek_xx821Dn::RxBlock *> blockPtrs(_nChannels);
+    for (uint32_t c = 0; c < _nChannels; c++) {
+        blocks[c].data = iq.data();
+        blocks[c].bytes = iq.size() * sizeof(int16_t);
+        blocks[c].timetag = 0;
+        blocks[c].sequence = 0;
+        blockPtrs[c] = &blocks[c];
+    }
+
+    typedef chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    uint64_t nSets = 0;
+    while (elapsed < _seconds) {
+        decimator.processBlocks(blockPtrs.data());
+        for (uint32_t c = 0; c < _nChannels; c++) {
+            blocks[c].sequence++;
+        }
+        nSets++;
+        elapsed = chrono::duration<double>(Clock::now() - start).count();
+    }
+    double mPairs = 1.0e-6 * nSets * _nChannels * _blockPairs / elapsed;
+    cout << _nChannels << " channel(s), " << _nTaps << " taps, decimation " <<
+            _decimation << ", " << _nWorkers << " worker(s): " << mPairs <<
+            " Mpairs/s in, " << mPairs / _decimation << " Mpairs/s out" <<
+            endl;
+
+    return(nBad ? 1 : 0);
+}
@@ -0,0 +1,200 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// Copyright UCAR (c) 2018
+// University Corporation for Atmospheric Research (UCAR)
+// National Center for Atmospheric Research (NCAR)
+// Boulder, Colorado, USA
+// BSD licence applies - redistribution and use in source and binary
+// forms, with or without modification, are permitted provided that
+// the following conditions are met:
+// 1) If the software is modified to produce derivative works,
+// such modified software should be clearly marked, so as not
+// to confuse it with the version available from UCAR.
+// 2) Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// 3) Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+// 4) Neither the name of UCAR nor the names of its contributors,
+// if any, may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+
+/*
+ * record_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Record raw DDC blocks from a Pentek xx821 board to an indexed capture
+ * file (see Pentek_xx821CaptureFile.h). Each channel is serviced by its own
+ * board service thread, which writes blocks straight from the DMA ring
+ * buffers and returns them to the board.
+ */
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <boost/thread/thread.hpp>
+#include <logx/Logging.h>
+#include <Pentek_xx821.h>
+#include <Pentek_xx821CaptureWriter.h>
+#include <Pentek_xx821Dn.h>
+
+using namespace std;
+namespace po = boost::program_options;
+
+LOGGING("record_xx821")
+
+int _boardNum = 0;              ///< board to record from
+string _channelsString = "0";   ///< DDC channels to record ("all" for all)
+double _seconds = 0.0;          ///< recording time (secs), 0 = until ^C
+string _outFile;                ///< capture file
+uint64_t _capacityMB = 4096;    ///< capture file data capacity (MiB)
+uint32_t _nBuffers = Pentek_xx821Dn::DEFAULT_BUFFER_COUNT;
+                                ///< DMA buffers per channel
+uint32_t _bufferBytes = Pentek_xx821Dn::DEFAULT_BUFFER_BYTES;
+                                ///< bytes per DMA buffer
+bool _exitNow = false;          ///< early exit if this becomes true
+
+/// Parse the command line options
+void parseOptions(int argc, char** argv)
+{
+    // get the options
+    po::options_description descripts("Options");
+    descripts.add_options()
+            ("help", "Describe options")
+            ("board", po::value<int>(&_boardNum), "Board to record from [0]")
+            ("channels", po::value<string>(&_channelsString),
+                    "Comma-separated DDC channels to record, or 'all' [0]")
+            ("seconds", po::value<double>(&_seconds),
+                    "Recording time, s; 0 to record until ^C [0]")
+            ("out", po::value<string>(&_outFile)->required(),
+                    "Capture file to write")
+            ("capacityMB", po::value<uint64_t>(&_capacityMB),
+                    "Capture file data capacity, MiB [4096]")
+            ("bufferCount", po::value<uint32_t>(&_nBuffers),
+                    "DMA buffers per channel [64]")
+            ("bufferBytes", po::value<uint32_t>(&_bufferBytes),
+                    "Bytes per DMA buffer [65536]")
+            ;
+
+    po::variables_map vm;
+    po::command_line_parser parser(argc, argv);
+    po::positional_options_description pd;
+    pd.add("out", 1);
+    po::store(parser.options(descripts).positional(pd).run(), vm);
+
+    if (vm.count("help")) {
+        cout << "Usage: " << argv[0] <<
+                " [OPTION]... <capture_file>" << endl;
+        cout << descripts << endl;
+        exit(0);
+    }
+    po::notify(vm);
+}
+
+/// Interrupt handler to trigger early exit
+void
+onInterrupt(int signal) {
+    ILOG << "Exiting early on " << strsignal(signal) << " signal";
+    _exitNow = true;
+}
+
+/// Service thread body recording one channel
+void
+recordChannel(Pentek_xx821ServiceThread & thread, Pentek_xx821Dn & dn,
+              Pentek_xx821CaptureWriter & writer, uint32_t chan) {
+    Pentek_xx821Dn::RxBlock block;
+    while (! thread.stopRequested()) {
+        if (dn.acquireBlock(block, 100)) {
+            writer.append(chan, block);
+            dn.releaseBlock(block);
+        }
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    // parse the command line options, substituting for config params.
+    parseOptions(argc, argv);
+
+    // Exit early if an interrupt signal (^C) is received
+    signal(SIGINT, onInterrupt);
+
+    Pentek_xx821 board(_boardNum);
+
+    vector<uint32_t> channels;
+    if (_channelsString == "all") {
+        for (int c = 0; c < board.ddcCount(); c++) {
+            channels.push_back(c);
+        }
+    } else {
+        istringstream chans(_channelsString);
+        string chan;
+        while (getline(chans, chan, ',')) {
+            channels.push_back(stoul(chan, 0, 0));
+        }
+    }
+
+    // Open the channels and the capture file. Capture file channel IDs are
+    // 256 * board + DDC channel.
+    vector<unique_ptr<Pentek_xx821Dn> > dns;
+    vector<uint32_t> chanIds;
+    for (uint32_t c : channels) {
+        dns.emplace_back(new Pentek_xx821Dn(board, c, _nBuffers, _bufferBytes));
+        chanIds.push_back(256 * _boardNum + c);
+    }
+    Pentek_xx821CaptureWriter writer(_outFile, chanIds,
+                                     dns.front()->bufferBytes(),
+                                     _capacityMB << 20);
+
+    for (size_t c = 0; c < dns.size(); c++) {
+        Pentek_xx821Dn & dn = *dns[c];
+        if (! dn.start()) {
+            ELOG << "Failed to start DDC channel " << dn.chanId();
+            exit(1);
+        }
+        ostringstream name;
+        name << "record" << dn.chanId();
+        board.startServiceThread(name.str(),
+                [&dn, &writer, c](Pentek_xx821ServiceThread & thread) {
+                    recordChannel(thread, dn, writer, c);
+                });
+    }
+
+    // Report progress once a second until done
+    ILOG << "Recording " << dns.size() << " channel(s) to " << _outFile <<
+            (writer.directIo() ? " with O_DIRECT" : "");
+    uint64_t lastBytes = 0;
+    for (int s = 1; ! _exitNow && (_seconds <= 0.0 || s <= _seconds); s++) {
+        boost::this_thread::sleep(boost::posix_time::seconds(1));
+        uint64_t bytes = writer.bytesWritten();
+        ILOG << (bytes - lastBytes) / 1.0e6 << " MB/s, " <<
+                writer.droppedCount() << " blocks not recorded";
+        lastBytes = bytes;
+    }
+
+    board.stopServiceThreads();
+    for (size_t c = 0; c < dns.size(); c++) {
+        dns[c]->stop();
+    }
+    writer.close();
+
+    for (size_t c = 0; c < dns.size(); c++) {
+        ILOG << "DDC channel " << dns[c]->chanId() << ": " <<
+                writer.blockCount(c) << " blocks recorded, " <<
+                dns[c]->droppedBlockCount() << " dropped by the board";
+    }
+    return((writer.droppedCount() == 0) ? 0 : 1);
+}
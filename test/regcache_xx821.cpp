@@ -0,0 +1,183 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * regcache_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Exercise Pentek_xx821RegCache without a board: cacheable and uncacheable
+ * range declarations, clean and dirty shadow values, and the contents and
+ * ordering of the dirty list returned by takeDirty(). Exits with status 1
+ * if any check fails.
+ */
+
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <logx/Logging.h>
+
+#include <Pentek_xx821RegCache.h>
+
+using namespace std;
+
+LOGGING("regcache_xx821")
+
+typedef vector<pair<uint32_t, uint32_t> > WriteList;
+
+int _nChecks = 0;   ///< checks made
+int _nBad = 0;      ///< checks failed
+
+/// Count a check, logging it if it failed
+void
+check(bool ok, const char * what) {
+    _nChecks++;
+    if (! ok) {
+        ELOG << "FAILED: " << what;
+        _nBad++;
+    }
+}
+
+/// Return true iff the cache holds the given shadow value for a register
+bool
+holds(const Pentek_xx821RegCache & cache, uint32_t regaddr, uint32_t val) {
+    uint32_t shadow;
+    return(cache.lookup(regaddr, shadow) && shadow == val);
+}
+
+/// Cacheable ranges, uncacheable carve-outs, and clipping at the top of
+/// the address space
+void
+checkRanges() {
+    Pentek_xx821RegCache cache;
+    check(! cache.isCacheable(0x100), "nothing cacheable by default");
+
+    cache.declareCacheable(0x100, 0x40);
+    check(cache.isCacheable(0x100), "first register of range cacheable");
+    check(cache.isCacheable(0x13c), "last register of range cacheable");
+    check(! cache.isCacheable(0x140), "register after range not cacheable");
+    check(! cache.isCacheable(0xfc), "register before range not cacheable");
+
+    cache.declareUncacheable(0x120, 8);
+    check(! cache.isCacheable(0x120), "carved-out register not cacheable");
+    check(! cache.isCacheable(0x124), "carved-out register not cacheable");
+    check(cache.isCacheable(0x11c), "register below carve-out cacheable");
+    check(cache.isCacheable(0x128), "register above carve-out cacheable");
+
+    // A later cacheable declaration doesn't undo the carve-out
+    cache.declareCacheable(0x100, 0x100);
+    check(! cache.isCacheable(0x120), "carve-out overrides later range");
+    check(cache.isCacheable(0x1fc), "second range cacheable");
+
+    cache.declareCacheable(0xfffffff0, 0x100);
+    check(cache.isCacheable(0xfffffffc), "range clipped at top of space");
+}
+
+/// Clean and dirty shadow values
+void
+checkValues() {
+    Pentek_xx821RegCache cache;
+    cache.declareCacheable(0, 0x1000);
+    uint32_t val;
+    check(! cache.lookup(0x10, val), "no shadow value before first access");
+
+    cache.fill(0x10, 0x1234);
+    check(holds(cache, 0x10, 0x1234), "fill() sets the shadow value");
+    check(! cache.hasDirty(), "fill() leaves the register clean");
+
+    cache.store(0x10, 0x5678);
+    check(holds(cache, 0x10, 0x5678), "store() sets the shadow value");
+    check(cache.hasDirty(), "store() makes the register dirty");
+
+    // A fill (e.g., a write-through) discards the pending dirty value
+    cache.fill(0x10, 0x9abc);
+    WriteList writes;
+    cache.takeDirty(writes);
+    check(writes.empty(), "fill() after store() discards the dirty value");
+    check(holds(cache, 0x10, 0x9abc), "fill() after store() sets shadow");
+
+    cache.store(0x20, 1);
+    cache.invalidate();
+    check(! cache.lookup(0x10, val) && ! cache.lookup(0x20, val),
+          "invalidate() forgets shadow values");
+    check(! cache.hasDirty(), "invalidate() forgets dirty values");
+    check(cache.isCacheable(0x10), "invalidate() keeps declarations");
+}
+
+/// The dirty list: one write per register with its latest value, in
+/// ascending address order, and clean afterward
+void
+checkDirtyList() {
+    Pentek_xx821RegCache cache;
+    cache.declareCacheable(0, 0x1000);
+
+    // Dirty registers out of address order, one of them twice
+    cache.store(0x30, 3);
+    cache.store(0x08, 1);
+    cache.store(0x200, 7);
+    cache.store(0x08, 2);
+    cache.store(0x14, 5);
+
+    WriteList writes;
+    cache.takeDirty(writes);
+    WriteList expected = { { 0x08, 2 }, { 0x14, 5 }, { 0x30, 3 },
+                           { 0x200, 7 } };
+    check(writes == expected, "takeDirty() gives latest values in order");
+    check(! cache.hasDirty(), "takeDirty() leaves registers clean");
+    check(holds(cache, 0x08, 2), "takeDirty() keeps shadow values");
+
+    cache.takeDirty(writes);
+    check(writes.empty(), "second takeDirty() finds nothing");
+
+    // Registers dirtied again after a takeDirty() are reported again
+    cache.store(0x14, 6);
+    cache.takeDirty(writes);
+    check(writes == WriteList(1, make_pair(0x14u, 6u)),
+          "register dirtied again is reported again");
+
+    // Carving out a dirty register drops its pending value
+    cache.store(0x40, 9);
+    cache.store(0x44, 10);
+    cache.declareUncacheable(0x40, 4);
+    cache.takeDirty(writes);
+    check(writes == WriteList(1, make_pair(0x44u, 10u)),
+          "carve-out drops the register's dirty value");
+    uint32_t val;
+    check(! cache.lookup(0x40, val), "carve-out drops the shadow value");
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    checkRanges();
+    checkValues();
+    checkDirtyList();
+
+    cout << "regcache_xx821: " << _nChecks << " checks, " << _nBad <<
+            " failed" << endl;
+    return(_nBad ? 1 : 0);
+}
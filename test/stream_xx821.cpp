@@ -0,0 +1,202 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * stream_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Share a DDC channel's sample stream between processes. With --publish,
+ * the channel's receive ring is placed in a named shared memory segment
+ * (see Pentek_xx821Publisher.h); with --subscribe, blocks are read from a
+ * publisher's segment in place (see Pentek_xx821Subscriber.h). Any number
+ * of subscribers may run against one publisher. The segment lives in a
+ * hugetlbfs mount (/dev/hugepages, or $PENTEK_XX821_HUGETLBFS), and the
+ * publisher needs enough hugepages reserved for it.
+ */
+
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <boost/program_options.hpp>
+#include <boost/thread/thread.hpp>
+#include <logx/Logging.h>
+#include <Pentek_xx821.h>
+#include <Pentek_xx821Publisher.h>
+#include <Pentek_xx821Subscriber.h>
+
+using namespace std;
+namespace po = boost::program_options;
+
+LOGGING("stream_xx821")
+
+bool _publish = false;          ///< run as publisher
+bool _subscribe = false;        ///< run as subscriber
+int _boardNum = 0;              ///< board to publish from
+uint32_t _chanId = 0;           ///< DDC channel to publish
+string _shmName = "/pentek_xx821_ddc0";
+                                ///< shared memory segment name
+double _seconds = 0.0;          ///< run time (secs), 0 = until ^C
+uint32_t _nBuffers = Pentek_xx821Dn::DEFAULT_BUFFER_COUNT;
+                                ///< DMA buffers in the ring
+uint32_t _bufferBytes = Pentek_xx821Dn::DEFAULT_BUFFER_BYTES;
+                                ///< bytes per DMA buffer
+uint32_t _depth = 0;            ///< readable depth, blocks
+bool _exitNow = false;          ///< early exit if this becomes true
+
+/// Parse the command line options
+void parseOptions(int argc, char** argv)
+{
+    // get the options
+    po::options_description descripts("Options");
+    descripts.add_options()
+            ("help", "Describe options")
+            ("publish", po::bool_switch(&_publish),
+                    "Publish a DDC channel")
+            ("subscribe", po::bool_switch(&_subscribe),
+                    "Read blocks from a publisher")
+            ("board", po::value<int>(&_boardNum), "Board to publish from [0]")
+            ("channel", po::value<uint32_t>(&_chanId),
+                    "DDC channel to publish [0]")
+            ("shm", po::value<string>(&_shmName),
+                    "Shared memory segment name [/pentek_xx821_ddc0]")
+            ("seconds", po::value<double>(&_seconds),
+                    "Run time, s; 0 to run until ^C [0]")
+            ("bufferCount", po::value<uint32_t>(&_nBuffers),
+                    "DMA buffers in the ring [64]")
+            ("bufferBytes", po::value<uint32_t>(&_bufferBytes),
+                    "Bytes per DMA buffer [65536]")
+            ("depth", po::value<uint32_t>(&_depth),
+                    "Blocks kept readable; 0 for half the ring [0]")
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, descripts), vm);
+    po::notify(vm);
+
+    if (vm.count("help") || _publish == _subscribe) {
+        cout << "Usage: " << argv[0] << " --publish|--subscribe [OPTION]..." <<
+                endl;
+        cout << descripts << endl;
+        exit(vm.count("help") ? 0 : 1);
+    }
+}
+
+/// Interrupt handler to trigger early exit
+void
+onInterrupt(int signal) {
+    ILOG << "Exiting early on " << strsignal(signal) << " signal";
+    _exitNow = true;
+}
+
+/// Return true while the run time has not expired
+bool
+keepRunning(int seconds) {
+    return(! _exitNow && (_seconds <= 0.0 || seconds <= _seconds));
+}
+
+/// Publish the channel, reporting progress once a second
+int
+publish() {
+    Pentek_xx821 board(_boardNum);
+    Pentek_xx821Publisher publisher(board, _chanId, _shmName, _nBuffers,
+                                    _bufferBytes, _depth);
+    if (! publisher.start()) {
+        ELOG << "Failed to start DDC channel " << _chanId;
+        return(1);
+    }
+    ILOG << "Publishing DDC channel " << _chanId << " as " << _shmName;
+    uint64_t lastCount = 0;
+    for (int s = 1; keepRunning(s); s++) {
+        boost::this_thread::sleep(boost::posix_time::seconds(1));
+        uint64_t count = publisher.publishedCount();
+        ILOG << (count - lastCount) << " blocks/s published, " <<
+                publisher.channel().droppedBlockCount() <<
+                " dropped by the board";
+        lastCount = count;
+    }
+    publisher.stop();
+    return(0);
+}
+
+/// Read blocks from the publisher, reporting progress once a second
+int
+subscribe() {
+    Pentek_xx821Subscriber subscriber(_shmName);
+    ILOG << "Reading board " << subscriber.boardNum() << " DDC channel " <<
+            subscriber.chanId() << " from " << _shmName;
+
+    // Touch every sample so that the reads are real, and check afterward
+    // that the block wasn't overwritten while we read it
+    uint64_t nBlocks = 0;
+    uint64_t nTorn = 0;
+    uint64_t nBytes = 0;
+    uint64_t lastBytes = 0;
+    uint64_t checksum = 0;
+    boost::posix_time::ptime next = boost::posix_time::microsec_clock::
+            universal_time() + boost::posix_time::seconds(1);
+    for (int s = 1; keepRunning(s); ) {
+        Pentek_xx821Subscriber::BlockView view;
+        if (subscriber.next(view, 100)) {
+            const uint64_t * words = static_cast<const uint64_t *>(view.data);
+            for (uint32_t w = 0; w < view.bytes / 8; w++) {
+                checksum += words[w];
+            }
+            if (subscriber.intact(view)) {
+                nBlocks++;
+                nBytes += view.bytes;
+            } else {
+                nTorn++;
+            }
+        }
+        if (boost::posix_time::microsec_clock::universal_time() >= next) {
+            ILOG << (nBytes - lastBytes) / 1.0e6 << " MB/s read, " <<
+                    subscriber.missedCount() << " blocks missed, " <<
+                    nTorn << " overwritten while reading" <<
+                    (subscriber.publishing() ? "" : " (publisher stopped)");
+            lastBytes = nBytes;
+            next += boost::posix_time::seconds(1);
+            s++;
+        }
+    }
+    ILOG << nBlocks << " blocks read, " << subscriber.missedCount() <<
+            " missed, " << nTorn << " overwritten while reading (checksum " <<
+            checksum << ")";
+    return(0);
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    // parse the command line options, substituting for config params.
+    parseOptions(argc, argv);
+
+    // Exit early if an interrupt signal (^C) is received
+    signal(SIGINT, onInterrupt);
+
+    return(_publish ? publish() : subscribe());
+}
@@ -0,0 +1,264 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// Copyright UCAR (c) 2018
+// University Corporation for Atmospheric Research (UCAR)
+// National Center for Atmospheric Research (NCAR)
+// Boulder, Colorado, USA
+// BSD licence applies - redistribution and use in source and binary
+// forms, with or without modification, are permitted provided that
+// the following conditions are met:
+// 1) If the software is modified to produce derivative works,
+// such modified software should be clearly marked, so as not
+// to confuse it with the version available from UCAR.
+// 2) Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// 3) Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+// 4) Neither the name of UCAR nor the names of its contributors,
+// if any, may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+
+/*
+ * unpack_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Check each of the Pentek_xx821Unpack kernels supported by this CPU
+ * against the scalar kernels, then report their throughput. Exits with
+ * status 1 if any kernel disagrees with the scalar path.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <logx/Logging.h>
+
+#include <Pentek_xx821Unpack.h>
+
+using namespace std;
+namespace po = boost::program_options;
+
+LOGGING("unpack_xx821")
+
+typedef Pentek_xx821Unpack::Kernels Kernels;
+typedef Pentek_xx821Unpack::Correction Correction;
+
+size_t _nPairs = 65536;     ///< I/Q pairs per conversion in timing runs
+double _seconds = 0.5;      ///< time to run each kernel in timing runs
+
+/// Parse the command line options
+void parseOptions(int argc, char** argv)
+{
+    po::options_description descripts("Options");
+    descripts.add_options()
+            ("help", "Describe options")
+            ("pairs", po::value<size_t>(&_nPairs),
+                    "I/Q pairs per conversion when timing [65536]")
+            ("seconds", po::value<double>(&_seconds),
+                    "Time to run each kernel, s [0.5]")
+            ;
+
+    po::variables_map vm;
+    po::command_line_parser parser(argc, argv);
+    po::positional_options_description pd;
+    po::store(parser.options(descripts).positional(pd).run(), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        cout << "Usage: " << argv[0] <<
+                " [OPTION]..." << endl;
+        cout << descripts << endl;
+        exit(0);
+    }
+}
+
+/// Return true if a SIMD result is within rounding of the scalar result.
+/// The SIMD kernels use fused multiply-add, so allow a few ulps of the
+/// larger of the product and the offset.
+bool
+closeEnough(float simd, float scalar, int16_t in, float gain, float offset) {
+    float scale = max(fabs(in * gain), fabs(offset));
+    return(fabs(simd - scalar) <= 4 * scale * numeric_limits<float>::epsilon());
+}
+
+/// Compare one kernel set against the scalar kernels for all lengths up to
+/// a few vectors (to exercise the tails) and one long run. Return the
+/// number of mismatches found.
+int
+checkKernels(const Kernels & kernels, const vector<int16_t> & in,
+             const Correction & corr) {
+    const Kernels & scalar = *Pentek_xx821Unpack::KernelsFor(
+            Pentek_xx821Unpack::ISA_SCALAR);
+    size_t maxPairs = in.size() / 2;
+    vector<complex<float> > cRef(maxPairs), cOut(maxPairs);
+    vector<float> iRef(maxPairs), qRef(maxPairs), iOut(maxPairs), qOut(maxPairs);
+
+    // Byte-swapped copy of the input, so that every swap variant should
+    // give the same result as the unswapped scalar kernel
+    vector<int16_t> swapped(in.size());
+    for (size_t s = 0; s < in.size(); s++) {
+        swapped[s] = int16_t(__builtin_bswap16(uint16_t(in[s])));
+    }
+
+    vector<size_t> lengths;
+    for (size_t n = 0; n <= 64 && n < maxPairs; n++) {
+        lengths.push_back(n);
+    }
+    lengths.push_back(maxPairs - 1);
+
+    int nBad = 0;
+    for (size_t n : lengths) {
+        scalar.iqToComplex[0](in.data(), cRef.data(), n, corr);
+        scalar.iqToPlanes[0](in.data(), iRef.data(), qRef.data(), n, corr);
+        for (int swap = 0; swap < 2; swap++) {
+            const int16_t * src = swap ? swapped.data() : in.data();
+            // Fill the outputs past n so that overruns show up as mismatches
+            fill(cOut.begin(), cOut.end(), complex<float>(NAN, NAN));
+            fill(iOut.begin(), iOut.end(), NAN);
+            fill(qOut.begin(), qOut.end(), NAN);
+            kernels.iqToComplex[swap](src, cOut.data(), n, corr);
+            kernels.iqToPlanes[swap](src, iOut.data(), qOut.data(), n, corr);
+            for (size_t p = 0; p < n; p++) {
+                int16_t i = in[2 * p];
+                int16_t q = in[2 * p + 1];
+                if (! closeEnough(cOut[p].real(), cRef[p].real(), i,
+                                  corr.gainI, corr.offsetI) ||
+                        ! closeEnough(cOut[p].imag(), cRef[p].imag(), q,
+                                      corr.gainQ, corr.offsetQ) ||
+                        ! closeEnough(iOut[p], iRef[p], i,
+                                      corr.gainI, corr.offsetI) ||
+                        ! closeEnough(qOut[p], qRef[p], q,
+                                      corr.gainQ, corr.offsetQ)) {
+                    if (nBad++ < 10) {
+                        ELOG << Pentek_xx821Unpack::IsaName(kernels.isa) <<
+                                (swap ? " (byte-swapped)" : "") <<
+                                " mismatch at pair " << p << " of " << n <<
+                                ": got " << cOut[p] << ", " << iOut[p] <<
+                                "/" << qOut[p] << ", expected " << cRef[p];
+                    }
+                }
+            }
+            if (n < maxPairs && (! isnan(cOut[n].real()) ||
+                                 ! isnan(iOut[n]) || ! isnan(qOut[n]))) {
+                ELOG << Pentek_xx821Unpack::IsaName(kernels.isa) <<
+                        " wrote past the end of a " << n << "-pair output";
+                nBad++;
+            }
+        }
+    }
+    return(nBad);
+}
+
+/// Run a conversion repeatedly for _seconds and return millions of I/Q
+/// pairs converted per second
+template<class CONVERT>
+double
+timeConversion(CONVERT convert) {
+    typedef chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    uint64_t nConversions = 0;
+    while (elapsed < _seconds) {
+        for (int rep = 0; rep < 16; rep++) {
+            convert();
+        }
+        nConversions += 16;
+        elapsed = chrono::duration<double>(Clock::now() - start).count();
+    }
+    return(1.0e-6 * nConversions * _nPairs / elapsed);
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    parseOptions(argc, argv);
+
+    // Random input with the extreme values salted in
+    mt19937 rng(821);
+    uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    vector<int16_t> checkIn(2 * 1000);
+    for (size_t s = 0; s < checkIn.size(); s++) {
+        checkIn[s] = int16_t(dist(rng));
+    }
+    checkIn[0] = INT16_MIN;
+    checkIn[1] = INT16_MAX;
+    checkIn[2] = -1;
+    checkIn[3] = 0;
+
+    Correction corrections[] = {
+        Pentek_xx821Unpack::UnitScale(),
+        { 1.0f, 1.0f, 0.0f, 0.0f },
+        { 0.98f / 32768, 1.03f / 32768, 0.0021f, -0.0017f }
+    };
+
+    int nBad = 0;
+    for (int isa = 0; isa < Pentek_xx821Unpack::ISA_COUNT; isa++) {
+        const Kernels * kernels =
+                Pentek_xx821Unpack::KernelsFor(Pentek_xx821Unpack::Isa(isa));
+        if (! kernels) {
+            ILOG << Pentek_xx821Unpack::IsaName(Pentek_xx821Unpack::Isa(isa)) <<
+                    " not supported on this CPU; skipping";
+            continue;
+        }
+        int nIsaBad = 0;
+        for (const Correction & corr : corrections) {
+            nIsaBad += checkKernels(*kernels, checkIn, corr);
+        }
+        ILOG << Pentek_xx821Unpack::IsaName(kernels->isa) << " check: " <<
+                (nIsaBad ? "FAILED" : "ok");
+        nBad += nIsaBad;
+    }
+
+    // Throughput, in millions of I/Q pairs per second
+    vector<int16_t> in(2 * _nPairs);
+    for (size_t s = 0; s < in.size(); s++) {
+        in[s] = int16_t(dist(rng));
+    }
+    vector<complex<float> > cOut(_nPairs);
+    vector<float> iOut(_nPairs), qOut(_nPairs);
+    Correction corr = corrections[2];
+
+    cout << "Active ISA: " << Pentek_xx821Unpack::IsaName(
+            Pentek_xx821Unpack::ActiveIsa()) << endl;
+    cout << "Throughput for " << _nPairs << "-pair conversions, Mpairs/s" <<
+            endl;
+    cout << setw(8) << "isa" << setw(12) << "complex" << setw(12) <<
+            "complex-bs" << setw(12) << "planes" << setw(12) << "planes-bs" <<
+            endl;
+    cout << fixed << setprecision(1);
+    for (int isa = 0; isa < Pentek_xx821Unpack::ISA_COUNT; isa++) {
+        const Kernels * kernels =
+                Pentek_xx821Unpack::KernelsFor(Pentek_xx821Unpack::Isa(isa));
+        if (! kernels) {
+            continue;
+        }
+        cout << setw(8) << Pentek_xx821Unpack::IsaName(kernels->isa);
+        for (int swap = 0; swap < 2; swap++) {
+            cout << setw(12) << timeConversion([&]() {
+                kernels->iqToComplex[swap](in.data(), cOut.data(), _nPairs, corr);
+            });
+        }
+        for (int swap = 0; swap < 2; swap++) {
+            cout << setw(12) << timeConversion([&]() {
+                kernels->iqToPlanes[swap](in.data(), iOut.data(), qOut.data(),
+                                          _nPairs, corr);
+            });
+        }
+        cout << endl;
+    }
+
+    return(nBad ? 1 : 0);
+}
@@ -0,0 +1,240 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 2026
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+
+/*
+ * waveform_xx821.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *
+ * Exercise Pentek_xx821WaveformCache without a board: the runs diff()
+ * returns for a first full upload, a one-word change, changes within and
+ * beyond the merge gap, and shorter and longer waveforms, and the copy
+ * commit() keeps. Exits with status 1 if any check fails.
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <logx/Logging.h>
+
+#include <Pentek_xx821WaveformCache.h>
+
+using namespace std;
+
+LOGGING("waveform_xx821")
+
+typedef Pentek_xx821WaveformCache::Run Run;
+
+/// Size of the waveform table used for the checks, words
+const size_t TABLE_WORDS = 1024;
+
+/// Merge gap used for the checks, words
+const uint32_t GAP = Pentek_xx821WaveformCache::DEFAULT_MERGE_GAP_WORDS;
+
+int _nChecks = 0;   ///< checks made
+int _nBad = 0;      ///< checks failed
+
+/// Count a check, logging it if it failed
+void
+check(bool ok, const char * what) {
+    _nChecks++;
+    if (! ok) {
+        ELOG << "FAILED: " << what;
+        _nBad++;
+    }
+}
+
+/// Return a waveform of the given length with a distinct value in each word
+vector<uint32_t>
+waveform(size_t count) {
+    vector<uint32_t> words(count);
+    for (size_t w = 0; w < count; w++) {
+        words[w] = 0x10000 + w;
+    }
+    return(words);
+}
+
+/// Load a waveform into the cache as Pentek_xx821::loadWaveform_() does,
+/// and return the runs which would have been uploaded
+vector<Run>
+load(Pentek_xx821WaveformCache & cache, const vector<uint32_t> & words) {
+    vector<Run> runs = cache.diff(words.data(), words.size());
+    cache.commit(words.data(), words.size());
+    return(runs);
+}
+
+/// Return true iff a run list holds exactly the given (firstWord, count)
+/// pairs
+bool
+runsAre(const vector<Run> & runs, const vector<pair<size_t, size_t> > & want) {
+    if (runs.size() != want.size()) {
+        return(false);
+    }
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (runs[r].firstWord != want[r].first ||
+                runs[r].count != want[r].second) {
+            return(false);
+        }
+    }
+    return(true);
+}
+
+/// First upload, reloading the same waveform, a one-word change, and
+/// invalidate()
+void
+checkFullAndSingle() {
+    Pentek_xx821WaveformCache cache(0, 0x1000, TABLE_WORDS);
+    vector<uint32_t> words = waveform(256);
+
+    check(runsAre(load(cache, words), { {0, 256} }),
+          "first load uploads the whole waveform");
+    check(cache.lastUploadWords() == 256 && cache.lastRunCount() == 1,
+          "first load counted as 256 words in one run");
+    check(cache.knownWords() == 256, "first load makes 256 words known");
+
+    check(load(cache, words).empty(), "same waveform uploads nothing");
+    check(cache.lastUploadWords() == 0 && cache.lastRunCount() == 0,
+          "same waveform counted as nothing uploaded");
+
+    words[100] ^= 1;
+    check(runsAre(load(cache, words), { {100, 1} }),
+          "one changed word uploads one word");
+    check(load(cache, words).empty(), "one-word change was committed");
+
+    // Changes in the first and last words, and at a compare chunk boundary
+    words[0] ^= 1;
+    words[16] ^= 1;
+    words[255] ^= 1;
+    check(runsAre(load(cache, words), { {0, 17}, {255, 1} }),
+          "changes at the ends and a chunk boundary");
+
+    cache.invalidate();
+    check(cache.knownWords() == 0, "invalidate() forgets the table");
+    check(runsAre(load(cache, words), { {0, 256} }),
+          "load after invalidate() uploads the whole waveform");
+}
+
+/// Changed words separated by exactly the merge gap, and by one more
+void
+checkMergeGap() {
+    Pentek_xx821WaveformCache cache(0, 0x1000, TABLE_WORDS);
+    vector<uint32_t> words = waveform(512);
+    load(cache, words);
+
+    // GAP unchanged words between the changes: one run
+    words[50] ^= 1;
+    words[50 + GAP + 1] ^= 1;
+    check(runsAre(load(cache, words), { {50, GAP + 2} }),
+          "changes within the merge gap are one run");
+    check(cache.lastUploadWords() == GAP + 2,
+          "merged run uploads the words between the changes");
+
+    // GAP + 1 unchanged words between the changes: two runs
+    words[200] ^= 1;
+    words[200 + GAP + 2] ^= 1;
+    check(runsAre(load(cache, words), { {200, 1}, {200 + GAP + 2, 1} }),
+          "changes beyond the merge gap are separate runs");
+
+    // A run of several changed words followed by one within the gap
+    for (size_t w = 300; w < 305; w++) {
+        words[w] ^= 1;
+    }
+    words[305 + GAP] ^= 1;
+    check(runsAre(load(cache, words), { {300, 5 + GAP + 1} }),
+          "changed stretch merged with a later change");
+
+    // With no merge gap, adjacent changes are still one run
+    Pentek_xx821WaveformCache noGap(1, 0x2000, TABLE_WORDS, 0);
+    load(noGap, words);
+    words[10] ^= 1;
+    words[11] ^= 1;
+    words[13] ^= 1;
+    check(runsAre(load(noGap, words), { {10, 2}, {13, 1} }),
+          "zero merge gap keeps separated changes apart");
+}
+
+/// Shorter and longer waveforms than the one loaded, and one too big for
+/// the table
+void
+checkLengths() {
+    Pentek_xx821WaveformCache cache(0, 0x1000, TABLE_WORDS);
+    vector<uint32_t> words = waveform(256);
+    load(cache, words);
+
+    vector<uint32_t> shorter(words.begin(), words.begin() + 128);
+    check(load(cache, shorter).empty(),
+          "shorter waveform matching the start uploads nothing");
+    check(cache.knownWords() == 256,
+          "shorter waveform keeps the rest of the table known");
+    shorter[127] ^= 1;
+    check(runsAre(load(cache, shorter), { {127, 1} }),
+          "change in a shorter waveform uploads one word");
+
+    // The words past the known part of the table are always uploaded, and
+    // join a change within the merge gap before them
+    vector<uint32_t> longer = waveform(300);
+    check(runsAre(load(cache, longer), { {127, 1}, {256, 44} }),
+          "longer waveform uploads the restored word and the new words");
+    check(cache.knownWords() == 300, "longer waveform extends the table");
+    longer[290] ^= 1;
+    longer.resize(320, 7);
+    check(runsAre(load(cache, longer), { {290, 30} }),
+          "change within the gap before new words joins their run");
+
+    vector<uint32_t> full = waveform(TABLE_WORDS);
+    check(runsAre(load(cache, full), { {290, TABLE_WORDS - 290} }),
+          "waveform filling the table");
+
+    bool threw = false;
+    try {
+        vector<uint32_t> tooBig = waveform(TABLE_WORDS + 1);
+        cache.diff(tooBig.data(), tooBig.size());
+    } catch (std::invalid_argument &) {
+        threw = true;
+    }
+    check(threw, "waveform larger than the table is rejected");
+
+    threw = false;
+    try {
+        Pentek_xx821WaveformCache misaligned(0, 0x1002, 16);
+    } catch (std::invalid_argument &) {
+        threw = true;
+    }
+    check(threw, "misaligned table is rejected");
+}
+
+int
+main(int argc, char** argv)
+{
+    // Let logx get and strip out its arguments
+    logx::ParseLogArgs(argc, argv);
+
+    checkFullAndSingle();
+    checkMergeGap();
+    checkLengths();
+
+    cout << "waveform_xx821: " << _nChecks << " checks, " << _nBad <<
+            " failed" << endl;
+    return(_nBad ? 1 : 0);
+}
@@ -13,21 +13,113 @@ requiredTools = [
     'doxygen',
 ]
 
-env = Environment(tools = ['default'] + requiredTools)
 variables = eol_scons.GlobalVariables()
+variables.Add(BoolVariable('PENTEK_SIM',
+                           'Build against the simulated Navigator backend ' +
+                           'in sim/ instead of the Navigator BSP, so that ' +
+                           'no Pentek card is needed',
+                           False))
+variables.Add(BoolVariable('PENTEK_NAV_DMA',
+                           'Build the DMA paths against Navigator DMA ' +
+                           'entry points declared in Pentek_xx821NavDma.h ' +
+                           '(always on with PENTEK_SIM); without them, ' +
+                           'DMA channels cannot be created',
+                           False))
+
+# PENTEK_SIM must be known before loading tools, since the simulated
+# backend takes the place of the Navigator BSP
+varEnv = Environment(tools = ['default'])
+variables.Update(varEnv)
+useSim = varEnv['PENTEK_SIM']
+if useSim:
+    requiredTools.remove('Navigator_xx821')
+useNavDma = useSim or varEnv['PENTEK_NAV_DMA']
+
+env = Environment(tools = ['default'] + requiredTools)
 variables.Update(env)
 
 # This library must be compiled with C++11 enabled
 env.AppendUnique(CXXFLAGS=['-std=c++11'])
 
+if useNavDma:
+    env.AppendUnique(CPPDEFINES = ['PENTEK_XX821_NAV_DMA'])
+
 libsources = Split("""
 Pentek_xx821.cpp
+Pentek_xx821BufferPool.cpp
+Pentek_xx821CaptureFile.cpp
+Pentek_xx821CaptureReader.cpp
+Pentek_xx821CaptureWriter.cpp
+Pentek_xx821CompletionWaiter.cpp
+Pentek_xx821Decimator.cpp
+Pentek_xx821DeferredLog.cpp
+Pentek_xx821Dn.cpp
+Pentek_xx821FanIn.cpp
+Pentek_xx821FieldUpdate.cpp
+Pentek_xx821Health.cpp
+Pentek_xx821Manager.cpp
+Pentek_xx821Profile.cpp
+Pentek_xx821Publisher.cpp
+Pentek_xx821PulsePair.cpp
+Pentek_xx821RegCache.cpp
+Pentek_xx821ServiceThread.cpp
+Pentek_xx821StreamSegment.cpp
+Pentek_xx821Subscriber.cpp
+Pentek_xx821Telemetry.cpp
+Pentek_xx821Unpack.cpp
+Pentek_xx821Up.cpp
+Pentek_xx821WaveformCache.cpp
+Pentek_xx821WorkerPool.cpp
 """)
 
 headers = Split("""
 Pentek_xx821.h
+Pentek_xx821BufferPool.h
+Pentek_xx821CaptureFile.h
+Pentek_xx821CaptureReader.h
+Pentek_xx821CaptureWriter.h
+Pentek_xx821CompletionWaiter.h
+Pentek_xx821Decimator.h
+Pentek_xx821DeferredLog.h
+Pentek_xx821Dn.h
+Pentek_xx821FanIn.h
+Pentek_xx821FieldUpdate.h
+Pentek_xx821Health.h
+Pentek_xx821Manager.h
+Pentek_xx821NavDma.h
+Pentek_xx821Profile.h
+Pentek_xx821Publisher.h
+Pentek_xx821PulsePair.h
+Pentek_xx821RegCache.h
+Pentek_xx821Registers.h
+Pentek_xx821ServiceThread.h
+Pentek_xx821StreamSegment.h
+Pentek_xx821Subscriber.h
+Pentek_xx821Telemetry.h
+Pentek_xx821Unpack.h
+Pentek_xx821Up.h
+Pentek_xx821WaveformCache.h
+Pentek_xx821WorkerPool.h
+""")
+
+simsources = Split("""
+sim/Pentek_xx821Sim.cpp
+""")
+
+simheaders = Split("""
+sim/820_include/nav820.h
+sim/Pentek_xx821Sim.h
+sim/nav_common.h
 """)
 
+thisdir = env.Dir('.').srcnode().abspath
+simdir = os.path.join(thisdir, 'sim')
+if useSim:
+    # Our stand-in Navigator headers must be found first
+    env.PrependUnique(CPPPATH = [simdir])
+    libsources += simsources
+    headers += simheaders
+
 libpentek = env.Library('Pentek_xx821', libsources)
 Default(libpentek)
 
@@ -37,10 +129,15 @@ env['DOXYFILE_DICT'].update({'PROJECT_NAME':'Pentek_xx821'})
 html = env.Apidocs(libsources + headers)
 Default(html)
 
-thisdir = env.Dir('.').srcnode().abspath
 def Pentek_xx821(env):
+    if useSim:
+        env.PrependUnique(CPPPATH = [simdir])
     env.AppendUnique(CPPPATH = [thisdir])
+    if useNavDma:
+        env.AppendUnique(CPPDEFINES = ['PENTEK_XX821_NAV_DMA'])
     env.AppendLibrary('Pentek_xx821')
+    # shm_open() for exported telemetry and published streams
+    env.AppendLibrary('rt')
     env.AppendDoxref('Pentek_xx821')
     env.Require(requiredTools)
 